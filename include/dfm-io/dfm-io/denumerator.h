@@ -6,6 +6,7 @@
 #define DENUMERATOR_H
 
 #include <dfm-io/dfmio_global.h>
+#include <dfm-io/dfileinfo.h>
 #include <dfm-io/error/error.h>
 
 #include <QUrl>
@@ -18,6 +19,7 @@ BEGIN_IO_NAMESPACE
 class DEnumeratorPrivate;
 class DFileInfo;
 class DEnumeratorFuture;
+class DSortedListing;
 class DEnumerator : public QEnableSharedFromThis<DEnumerator>
 {
 public:
@@ -78,6 +80,7 @@ public:
     ~DEnumerator();
     QUrl uri() const;
 
+    // wildcard patterns like QDir's, only matching names are listed, kCaseSensitive and kAllDirs apply
     void setNameFilters(const QStringList &filters);
     QStringList nameFilters() const;
 
@@ -99,6 +102,20 @@ public:
     void setSortMixed(bool mix);
     bool isSortMixed() const;
 
+    // only query these attributes for every entry, empty means all the default attributes
+    void setQueryAttributes(const QList<DFileInfo::AttributeID> &attributes);
+    QList<DFileInfo::AttributeID> queryAttributes() const;
+
+    // walk the sub dirs of a local uri with this many threads, entries then come unordered
+    void setMaxThreadCount(int count);
+    int maxThreadCount() const;
+
+    // process wide cache of dir listings, off while the limit is 0 (the default).
+    // local dirs are checked against the mtime, ctime and inode of the dir, other dirs
+    // are only kept while a DWatcher watches them
+    static void setListingCacheLimit(qint64 bytes);
+    static qint64 listingCacheLimit();
+
 public:
     bool cancel();
     bool hasNext() const;
@@ -107,12 +124,21 @@ public:
     quint64 fileCount();
     QList<QSharedPointer<DFileInfo>> fileInfoList();
     QList<QSharedPointer<DEnumerator::SortFileInfo>> sortFileInfoList();
+    // only the first firstN sorted entries, the rest is sorted in the background
+    // and comes from remainingSortFileInfoList()
+    QList<QSharedPointer<DEnumerator::SortFileInfo>> sortFileInfoList(int firstN);
+    QList<QSharedPointer<DEnumerator::SortFileInfo>> remainingSortFileInfoList();
+    // the same entries as the sortFileInfoList() calls, stored compactly, see dsortedlisting.h
+    DSortedListing sortedListing();
+    DSortedListing sortedListing(int firstN);
+    DSortedListing remainingSortedListing();
     DFMIOError lastError() const;
     DEnumeratorFuture *asyncIterator();
     void startAsyncIterator();
     bool isAsyncOver() const;
 
 private:
+    friend class DEnumeratorFuture;
     QSharedPointer<DEnumeratorPrivate> d;
 };
 
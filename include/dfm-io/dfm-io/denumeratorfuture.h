@@ -7,6 +7,7 @@
 
 #include <dfm-io/dfmio_global.h>
 #include <dfm-io/denumerator.h>
+#include <dfm-io/dfileinfo.h>
 
 #include <QObject>
 
@@ -27,9 +28,16 @@ public:
 
 public:
     void startAsyncIterator();
+    // emits batchReady for every batch read instead of waiting for the whole dir,
+    // set it before startAsyncIterator
+    void setBatchMode(bool enable);
+    // reading pauses while count batches are not confirmed by batchConsumed, 0 for no limit
+    void setMaxPendingBatches(int count);
 
 Q_SIGNALS:
     void asyncIteratorOver();
+    // batch mode only, the infos read since the last batch
+    void batchReady(const QList<QSharedPointer<DFMIO::DFileInfo>> &infos);
 
 public:
     bool isFinished();
@@ -38,6 +46,10 @@ public:
 
 public Q_SLOTS:
     void onAsyncIteratorOver();
+    void onAsyncBatchReady(const QList<QSharedPointer<DFMIO::DFileInfo>> &infos);
+    // confirms a batch of batchReady, a paused read goes on.
+    // must be called in the thread that started the iterator
+    void batchConsumed();
 
 private:
     QSharedPointer<DEnumerator> enumerator { nullptr };
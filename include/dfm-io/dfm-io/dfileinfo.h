@@ -193,6 +193,15 @@ public:
     using InitQuerierAsyncCallback = std::function<void(bool, void *)>;
     using AttributeAsyncCallback = std::function<void(bool, void *, QVariant)>;
     using AttributeExtendFuncCallback = std::function<void(bool, QMap<AttributeExtendID, QVariant>)>;
+    using QueryBatchCallback = std::function<void(const QUrl &, QSharedPointer<DFileInfo>)>;
+
+    // one file's part of a batch xattr read, keys as gio names them ("xattr::tag")
+    // and values as the raw bytes stored
+    struct ExtendedAttributes
+    {
+        QMap<QByteArray, QByteArray> values;
+        DFMIOError error;
+    };
 
 public:
     explicit DFileInfo(const QUrl &uri, const char *attributes = "*", const FileQueryInfoFlags flag = FileQueryInfoFlags::kTypeNone);
@@ -204,6 +213,10 @@ public:
 
     bool initQuerier();
     QVariant attribute(DFileInfo::AttributeID id, bool *success = nullptr) const;
+    // the attribute in its native type, see DFileAttributeTraits, e.g. get<AttributeID::kStandardSize>().
+    // read straight from the queried info without a QVariant, same defaults as attribute()
+    template<AttributeID id>
+    auto get(bool *success = nullptr) const;
     void initQuerierAsync(int ioPriority = 0, InitQuerierAsyncCallback func = nullptr, void *userData = nullptr);
     void attributeAsync(DFileInfo::AttributeID id, bool *success = nullptr, int ioPriority = 0, AttributeAsyncCallback func = nullptr, void *userData = nullptr);
 
@@ -235,10 +248,157 @@ public:
     DFileInfo::FileQueryInfoFlags queryInfoFlag() const;
     QString dump() const;
 
+    // infos of many urls at once, the same order as urls, null where a file could not be queried.
+    // empty attributes query all of them
+    static QList<QSharedPointer<DFileInfo>> queryBatch(const QList<QUrl> &urls, const QList<AttributeID> &attributes,
+                                                       const FileQueryInfoFlags flag = FileQueryInfoFlags::kTypeNone);
+    // the same, every info is handed to callback as soon as it is there, in any order and
+    // from worker threads, one call at a time. returns when all urls are done
+    static void queryBatch(const QList<QUrl> &urls, const QList<AttributeID> &attributes,
+                           const FileQueryInfoFlags flag, QueryBatchCallback callback);
+
+    // extended attributes of many files at once, the same order as urls. empty keys read
+    // every user attribute, keys a file does not have are left out of its values
+    static QList<ExtendedAttributes> extendedAttributes(const QList<QUrl> &urls, const QList<QByteArray> &keys = {});
+    // sets values on every file, a null value removes the key. returns the error of
+    // each file in the order of urls, a file stops at its first failing key
+    static QList<DFMIOError> setExtendedAttributes(const QList<QUrl> &urls, const QMap<QByteArray, QByteArray> &values);
+
 private:
+    void readAttribute(AttributeID id, bool *value, bool *success) const;
+    void readAttribute(AttributeID id, quint32 *value, bool *success) const;
+    void readAttribute(AttributeID id, qint32 *value, bool *success) const;
+    void readAttribute(AttributeID id, quint64 *value, bool *success) const;
+    void readAttribute(AttributeID id, qint64 *value, bool *success) const;
+    void readAttribute(AttributeID id, QString *value, bool *success) const;
+
     QSharedDataPointer<DFileInfoPrivate> d;
 };
 
+// the native type of each attribute for DFileInfo::get. ids without an entry
+// (icons, permissions) are only there through attribute() and fail to compile
+template<DFileInfo::AttributeID id>
+struct DFileAttributeTraits;
+
+#define DFMIO_ATTRIBUTE_TRAITS(ID, T)                           \
+    template<>                                                  \
+    struct DFileAttributeTraits<DFileInfo::AttributeID::ID>     \
+    {                                                           \
+        using Type = T;                                         \
+    };
+
+DFMIO_ATTRIBUTE_TRAITS(kStandardType, quint32)
+DFMIO_ATTRIBUTE_TRAITS(kStandardIsHidden, bool)
+DFMIO_ATTRIBUTE_TRAITS(kStandardIsBackup, bool)
+DFMIO_ATTRIBUTE_TRAITS(kStandardIsSymlink, bool)
+DFMIO_ATTRIBUTE_TRAITS(kStandardIsVirtual, bool)
+DFMIO_ATTRIBUTE_TRAITS(kStandardIsVolatile, bool)
+DFMIO_ATTRIBUTE_TRAITS(kStandardName, QString)
+DFMIO_ATTRIBUTE_TRAITS(kStandardDisplayName, QString)
+DFMIO_ATTRIBUTE_TRAITS(kStandardEditName, QString)
+DFMIO_ATTRIBUTE_TRAITS(kStandardCopyName, QString)
+DFMIO_ATTRIBUTE_TRAITS(kStandardContentType, QString)
+DFMIO_ATTRIBUTE_TRAITS(kStandardFastContentType, QString)
+DFMIO_ATTRIBUTE_TRAITS(kStandardSize, quint64)
+DFMIO_ATTRIBUTE_TRAITS(kStandardAllocatedSize, quint64)
+DFMIO_ATTRIBUTE_TRAITS(kStandardSymlinkTarget, QString)
+DFMIO_ATTRIBUTE_TRAITS(kStandardTargetUri, QString)
+DFMIO_ATTRIBUTE_TRAITS(kStandardSortOrder, qint32)
+DFMIO_ATTRIBUTE_TRAITS(kStandardDescription, QString)
+
+DFMIO_ATTRIBUTE_TRAITS(kEtagValue, QString)
+DFMIO_ATTRIBUTE_TRAITS(kIdFile, QString)
+DFMIO_ATTRIBUTE_TRAITS(kIdFilesystem, QString)
+
+DFMIO_ATTRIBUTE_TRAITS(kAccessCanRead, bool)
+DFMIO_ATTRIBUTE_TRAITS(kAccessCanWrite, bool)
+DFMIO_ATTRIBUTE_TRAITS(kAccessCanExecute, bool)
+DFMIO_ATTRIBUTE_TRAITS(kAccessCanDelete, bool)
+DFMIO_ATTRIBUTE_TRAITS(kAccessCanTrash, bool)
+DFMIO_ATTRIBUTE_TRAITS(kAccessCanRename, bool)
+
+DFMIO_ATTRIBUTE_TRAITS(kMountableCanMount, bool)
+DFMIO_ATTRIBUTE_TRAITS(kMountableCanUnmount, bool)
+DFMIO_ATTRIBUTE_TRAITS(kMountableCanEject, bool)
+DFMIO_ATTRIBUTE_TRAITS(kMountableUnixDevice, quint32)
+DFMIO_ATTRIBUTE_TRAITS(kMountableUnixDeviceFile, QString)
+DFMIO_ATTRIBUTE_TRAITS(kMountableHalUdi, QString)
+DFMIO_ATTRIBUTE_TRAITS(kMountableCanPoll, bool)
+DFMIO_ATTRIBUTE_TRAITS(kMountableIsMediaCheckAutomatic, bool)
+DFMIO_ATTRIBUTE_TRAITS(kMountableCanStart, bool)
+DFMIO_ATTRIBUTE_TRAITS(kMountableCanStartDegraded, bool)
+DFMIO_ATTRIBUTE_TRAITS(kMountableCanStop, bool)
+DFMIO_ATTRIBUTE_TRAITS(kMountableStartStopType, quint32)
+
+DFMIO_ATTRIBUTE_TRAITS(kTimeModified, quint64)
+DFMIO_ATTRIBUTE_TRAITS(kTimeModifiedUsec, quint32)
+DFMIO_ATTRIBUTE_TRAITS(kTimeAccess, quint64)
+DFMIO_ATTRIBUTE_TRAITS(kTimeAccessUsec, quint32)
+DFMIO_ATTRIBUTE_TRAITS(kTimeChanged, quint64)
+DFMIO_ATTRIBUTE_TRAITS(kTimeChangedUsec, quint32)
+DFMIO_ATTRIBUTE_TRAITS(kTimeCreated, quint64)
+DFMIO_ATTRIBUTE_TRAITS(kTimeCreatedUsec, quint32)
+
+DFMIO_ATTRIBUTE_TRAITS(kUnixDevice, quint32)
+DFMIO_ATTRIBUTE_TRAITS(kUnixInode, quint64)
+DFMIO_ATTRIBUTE_TRAITS(kUnixMode, quint32)
+DFMIO_ATTRIBUTE_TRAITS(kUnixNlink, quint32)
+DFMIO_ATTRIBUTE_TRAITS(kUnixUID, quint32)
+DFMIO_ATTRIBUTE_TRAITS(kUnixGID, quint32)
+DFMIO_ATTRIBUTE_TRAITS(kUnixRdev, quint32)
+DFMIO_ATTRIBUTE_TRAITS(kUnixBlockSize, quint32)
+DFMIO_ATTRIBUTE_TRAITS(kUnixBlocks, quint64)
+DFMIO_ATTRIBUTE_TRAITS(kUnixIsMountPoint, bool)
+
+DFMIO_ATTRIBUTE_TRAITS(kDosIsArchive, bool)
+DFMIO_ATTRIBUTE_TRAITS(kDosIsSystem, bool)
+
+DFMIO_ATTRIBUTE_TRAITS(kOwnerUser, QString)
+DFMIO_ATTRIBUTE_TRAITS(kOwnerUserReal, QString)
+DFMIO_ATTRIBUTE_TRAITS(kOwnerGroup, QString)
+
+DFMIO_ATTRIBUTE_TRAITS(kThumbnailPath, QString)
+DFMIO_ATTRIBUTE_TRAITS(kThumbnailFailed, bool)
+DFMIO_ATTRIBUTE_TRAITS(kThumbnailIsValid, bool)
+
+DFMIO_ATTRIBUTE_TRAITS(kFileSystemSize, quint64)
+DFMIO_ATTRIBUTE_TRAITS(kFileSystemFree, quint64)
+DFMIO_ATTRIBUTE_TRAITS(kFileSystemUsed, quint64)
+DFMIO_ATTRIBUTE_TRAITS(kFileSystemType, QString)
+DFMIO_ATTRIBUTE_TRAITS(kFileSystemReadOnly, bool)
+DFMIO_ATTRIBUTE_TRAITS(kFileSystemUsePreview, quint32)
+DFMIO_ATTRIBUTE_TRAITS(kFileSystemRemote, bool)
+
+DFMIO_ATTRIBUTE_TRAITS(kGvfsBackend, QString)
+DFMIO_ATTRIBUTE_TRAITS(kSelinuxContext, QString)
+
+DFMIO_ATTRIBUTE_TRAITS(kTrashItemCount, quint32)
+DFMIO_ATTRIBUTE_TRAITS(kTrashDeletionDate, QString)
+DFMIO_ATTRIBUTE_TRAITS(kTrashOrigPath, QString)
+
+DFMIO_ATTRIBUTE_TRAITS(kRecentModified, qint64)
+
+DFMIO_ATTRIBUTE_TRAITS(kStandardIsFile, bool)
+DFMIO_ATTRIBUTE_TRAITS(kStandardIsDir, bool)
+DFMIO_ATTRIBUTE_TRAITS(kStandardIsRoot, bool)
+DFMIO_ATTRIBUTE_TRAITS(kStandardSuffix, QString)
+DFMIO_ATTRIBUTE_TRAITS(kStandardCompleteSuffix, QString)
+DFMIO_ATTRIBUTE_TRAITS(kStandardFilePath, QString)
+DFMIO_ATTRIBUTE_TRAITS(kStandardParentPath, QString)
+DFMIO_ATTRIBUTE_TRAITS(kStandardBaseName, QString)
+DFMIO_ATTRIBUTE_TRAITS(kStandardFileName, QString)
+DFMIO_ATTRIBUTE_TRAITS(kStandardCompleteBaseName, QString)
+
+#undef DFMIO_ATTRIBUTE_TRAITS
+
+template<DFileInfo::AttributeID id>
+auto DFileInfo::get(bool *success) const
+{
+    typename DFileAttributeTraits<id>::Type value {};
+    readAttribute(id, &value, success);
+    return value;
+}
+
 END_IO_NAMESPACE
 
 #endif   // DFILEINFO_H
@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DSORTEDLISTING_H
+#define DSORTEDLISTING_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/denumerator.h>
+
+#include <QUrl>
+#include <QString>
+#include <QByteArray>
+#include <QSharedDataPointer>
+
+#include <iterator>
+
+BEGIN_IO_NAMESPACE
+
+class DSortedListingData;
+
+// the sorted children of one directory stored column by column: the names in one
+// buffer, the parent path once, the flags packed in a byte, size and mtime in arrays.
+// urls and paths are only built when asked for. copies share the data.
+class DSortedListing
+{
+public:
+    enum Flag : quint8 {
+        kIsFile = 0x01,
+        kIsDir = 0x02,
+        kIsSymLink = 0x04,
+        kIsHide = 0x08,
+        kIsReadable = 0x10,
+        kIsWriteable = 0x20,
+        kIsExecutable = 0x40,
+    };
+    Q_DECLARE_FLAGS(Flags, Flag)
+
+    // a view of one entry, only valid while the listing it comes from is alive
+    class Entry
+    {
+    public:
+        Entry(const DSortedListing *listing, int index)
+            : listing(listing), i(index) { }
+
+        int index() const { return i; }
+        QByteArray fileNameBytes() const { return listing->fileNameBytes(i); }
+        QString fileName() const { return listing->fileName(i); }
+        QString filePath() const { return listing->filePath(i); }
+        QUrl url() const { return listing->url(i); }
+        Flags flags() const { return listing->flags(i); }
+        bool isDir() const { return listing->flags(i).testFlag(kIsDir); }
+        qint64 size() const { return listing->fileSize(i); }
+        qint64 lastModified() const { return listing->lastModified(i); }
+
+    private:
+        const DSortedListing *listing;
+        int i;
+    };
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Entry;
+        using difference_type = int;
+        using pointer = void;
+        using reference = Entry;
+
+        const_iterator(const DSortedListing *listing, int index)
+            : listing(listing), i(index) { }
+
+        Entry operator*() const { return Entry(listing, i); }
+        Entry operator[](int n) const { return Entry(listing, i + n); }
+        const_iterator &operator++() { ++i; return *this; }
+        const_iterator operator++(int) { const_iterator it = *this; ++i; return it; }
+        const_iterator &operator--() { --i; return *this; }
+        const_iterator operator--(int) { const_iterator it = *this; --i; return it; }
+        const_iterator &operator+=(int n) { i += n; return *this; }
+        const_iterator &operator-=(int n) { i -= n; return *this; }
+        const_iterator operator+(int n) const { return const_iterator(listing, i + n); }
+        const_iterator operator-(int n) const { return const_iterator(listing, i - n); }
+        int operator-(const const_iterator &other) const { return i - other.i; }
+        bool operator==(const const_iterator &other) const { return i == other.i && listing == other.listing; }
+        bool operator!=(const const_iterator &other) const { return !(*this == other); }
+        bool operator<(const const_iterator &other) const { return i < other.i; }
+
+    private:
+        const DSortedListing *listing;
+        int i;
+    };
+
+public:
+    DSortedListing();
+    explicit DSortedListing(const QString &parentPath);
+    DSortedListing(const DSortedListing &other);
+    DSortedListing &operator=(const DSortedListing &other);
+    ~DSortedListing();
+
+    QString parentPath() const;
+    int size() const;
+    bool isEmpty() const;
+    void reserve(int count, int nameBytes);
+    // name is the local 8 bit file name as read from the directory
+    void append(const char *name, int length, Flags flags, qint64 size, qint64 lastModified);
+
+    // points into the name buffer without copying, valid as long as the listing
+    QByteArray fileNameBytes(int index) const;
+    QString fileName(int index) const;
+    QString filePath(int index) const;
+    QUrl url(int index) const;
+    Flags flags(int index) const;
+    qint64 fileSize(int index) const;
+    // seconds since the epoch
+    qint64 lastModified(int index) const;
+    QSharedPointer<DEnumerator::SortFileInfo> sortFileInfo(int index) const;
+
+    Entry at(int index) const { return Entry(this, index); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    // bytes held by the columns
+    size_t memoryUsage() const;
+
+private:
+    QSharedDataPointer<DSortedListingData> d;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(DSortedListing::Flags);
+
+END_IO_NAMESPACE
+
+Q_DECLARE_METATYPE(DFMIO::DSortedListing)
+
+#endif   // DSORTEDLISTING_H
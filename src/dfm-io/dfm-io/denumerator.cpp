@@ -5,6 +5,10 @@
 #include "private/denumerator_p.h"
 
 #include "utils/dlocalhelper.h"
+#include "utils/dlocalsorter.h"
+#include "utils/dhiddenlistcache.h"
+#include "utils/dnamematcher.h"
+#include "utils/dlistingcache.h"
 
 #include <dfm-io/denumerator.h>
 #include <dfm-io/dfileinfo.h>
@@ -16,10 +20,18 @@
 #include <QDebug>
 #include <qobjectdefs.h>
 
+#include <numeric>
+#include <vector>
+
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
-#define FILE_DEFAULT_ATTRIBUTES "standard::*,etag::*,id::*,access::*,mountable::*,time::*,unix::*,dos::*,\
-owner::*,thumbnail::*,preview::*,filesystem::*,gvfs::*,selinux::*,trash::*,recent::*,metadata::*"
+// async batches: a small first one paints fast, later ones follow the latency of the mount
+static constexpr int kFirstBatchSize = 32;
+static constexpr int kMinBatchSize = 16;
+static constexpr int kMaxBatchSize = 2000;
+static constexpr qint64 kBatchLatencyTarget = 100;   // ms
 
 USING_IO_NAMESPACE
 
@@ -34,6 +46,8 @@ DEnumeratorPrivate::DEnumeratorPrivate(DEnumerator *q)
 
 DEnumeratorPrivate::~DEnumeratorPrivate()
 {
+    enumCanceled = true;
+    sortRestFuture.waitForFinished();
     clean();
     if (cancellable) {
         g_object_unref(cancellable);
@@ -46,12 +60,12 @@ bool DEnumeratorPrivate::init(const QUrl &url)
     QPointer<DEnumeratorPrivate> me = this;
     const bool needTimeOut = q->timeout() != 0;
     if (!needTimeOut) {
-        return createEnumerator(url, me);
+        return localEnumerate ? createLocalEnumerator(url, me) : createEnumerator(url, me);
     } else {
         mutex.lock();
         bool succ = false;
         QtConcurrent::run([this, me, url, &succ]() {
-            succ = createEnumerator(url, me);
+            succ = localEnumerate ? createLocalEnumerator(url, me) : createEnumerator(url, me);
         });
         bool wait = waitCondition.wait(&mutex, q->timeout());
         mutex.unlock();
@@ -63,7 +77,32 @@ bool DEnumeratorPrivate::init(const QUrl &url)
 
 bool DEnumeratorPrivate::init()
 {
+    buildQueryAttributes();
     const QUrl &uri = q->uri();
+    // local dirs are read natively when statx answers the projection, everything else goes through gio.
+    // gio fills each entry from its own lstat, a per-url query on top of getdents would only cost more.
+    // the local default projection is answered natively, its thumbnail::*, selinux::* and metadata::*
+    // part is left to DFileInfo, which asks gio for it on first use
+    localEnumerate = uri.isLocalFile() && queryNatively;
+    if (localEnumerate && enumSubDir && maxThreadCount > 1) {
+        walker.reset(new DLocalWalker(uri.toLocalFile().toLocal8Bit(), maxThreadCount, enumLinks));
+        walker->start();
+        inited = true;
+        return true;
+    }
+    // gio dirs listed before are served from the listing cache, otherwise recorded for it
+    if (!uri.isLocalFile() && !enumSubDir) {
+        DListingCache *cache = DListingCache::instance();
+        cachedListing = cache->infoListing(uri, queryAttributes, enumLinks);
+        if (cachedListing) {
+            cachedIndex = 0;
+            inited = true;
+            return true;
+        }
+        cacheTicket = cache->ticket(uri);
+        if (cacheTicket.valid)
+            recording.reset(new DListingCache::InfoListing);
+    }
     bool ret = init(uri);
     inited = true;
     return ret;
@@ -79,6 +118,16 @@ void DEnumeratorPrivate::clean()
                 break;
         }
     }
+    qDeleteAll(stackLocalEnumerator);
+    stackLocalEnumerator.clear();
+    if (pausedData) {
+        releaseEnumUriData(pausedData, false);
+        pausedData = nullptr;
+    }
+    walker.reset();
+    recording.reset();
+    localEntryValid = false;
+    hideListValid = false;
 }
 
 bool DEnumeratorPrivate::createEnumerator(const QUrl &url, QPointer<DEnumeratorPrivate> me)
@@ -89,7 +138,7 @@ bool DEnumeratorPrivate::createEnumerator(const QUrl &url, QPointer<DEnumeratorP
     g_autoptr(GError) gerror = nullptr;
     checkAndResetCancel();
     GFileEnumerator *genumerator = g_file_enumerate_children(gfile,
-                                                             FILE_DEFAULT_ATTRIBUTES,
+                                                             queryAttributes.constData(),
                                                              enumLinks ? G_FILE_QUERY_INFO_NONE : G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
                                                              cancellable,
                                                              &gerror);
@@ -110,6 +159,26 @@ bool DEnumeratorPrivate::createEnumerator(const QUrl &url, QPointer<DEnumeratorP
     return ret;
 }
 
+bool DEnumeratorPrivate::createLocalEnumerator(const QUrl &url, QPointer<DEnumeratorPrivate> me)
+{
+    DLocalEnumerator *enumerator = new DLocalEnumerator(url.toLocalFile());
+    const bool succ = enumerator->open();
+    if (!me) {
+        delete enumerator;
+        error.setCode(DFMIOErrorCode(DFM_IO_ERROR_NOT_FOUND));
+        return false;
+    }
+    if (!succ) {
+        setErrorFromErrno(enumerator->lastErrno());
+        qWarning() << "create local enumerator failed, url: " << url << " error: " << error.errorMsg();
+        delete enumerator;
+    } else {
+        stackLocalEnumerator.push(enumerator);
+    }
+    waitCondition.wakeAll();
+    return succ;
+}
+
 void DEnumeratorPrivate::checkAndResetCancel()
 {
     if (cancellable) {
@@ -129,6 +198,69 @@ void DEnumeratorPrivate::setErrorFromGError(GError *gerror)
         error.setMessage(gerror->message);
 }
 
+void DEnumeratorPrivate::setErrorFromErrno(int errnum)
+{
+    error.setCode(DFMIOErrorCode(g_io_error_from_errno(errnum)));
+    if (error.code() == DFMIOErrorCode::DFM_IO_ERROR_FAILED)
+        error.setMessage(QString::fromLocal8Bit(strerror(errnum)));
+}
+
+void DEnumeratorPrivate::buildQueryAttributes()
+{
+    if (queryAttributeIds.isEmpty()) {
+        queryAttributes = uri.isLocalFile() ? FILE_DEFAULT_ATTRIBUTES : FILE_REMOTE_DEFAULT_ATTRIBUTES;
+    } else {
+        // name and type build the urls and walk sub dirs, symlink decides whether to follow them
+        QList<DFileInfo::AttributeID> ids = queryAttributeIds;
+        ids << DFileInfo::AttributeID::kStandardName
+            << DFileInfo::AttributeID::kStandardType
+            << DFileInfo::AttributeID::kStandardIsSymlink;
+
+        // access is only needed by the rwx filters
+        if (needAccessFilter()) {
+            ids << DFileInfo::AttributeID::kAccessCanRead
+                << DFileInfo::AttributeID::kAccessCanWrite
+                << DFileInfo::AttributeID::kAccessCanExecute;
+        }
+
+        queryAttributes = DLocalHelper::attributesQueryString(ids, uri.isLocalFile());
+    }
+
+    // the native backend fills the projection itself instead of asking gio per entry,
+    // the local default one included
+    queryNatively = DLocalEnumerator::canQueryNatively(queryAttributes.constData());
+    queryStatxMask = queryNatively ? DLocalEnumerator::statxMask(DLocalHelper::attributeMatcher(queryAttributes.constData())) : 0;
+}
+
+bool DEnumeratorPrivate::needAccessFilter() const
+{
+    if (dirFilters.testFlag(DEnumerator::DirFilter::kNoFilter))
+        return false;
+
+    return dirFilters.testFlag(DEnumerator::DirFilter::kReadable)
+            || dirFilters.testFlag(DEnumerator::DirFilter::kWritable)
+            || dirFilters.testFlag(DEnumerator::DirFilter::kExecutable);
+}
+
+void DEnumeratorPrivate::updateNameMatcher()
+{
+    const bool caseSensitive = (dirFilters & DEnumerator::DirFilter::kCaseSensitive).testFlag(DEnumerator::DirFilter::kCaseSensitive);
+    nameMatcher = DNameMatcher(nameFilters, caseSensitive);
+}
+
+bool DEnumeratorPrivate::checkNameFilter(GFileInfo *gfileInfo) const
+{
+    // runs before the DFileInfo is built, checkFilter() does the rest on it
+    if (dirFilters.testFlag(DEnumerator::DirFilter::kNoFilter) || nameMatcher.isEmpty())
+        return true;
+
+    if ((dirFilters & DEnumerator::DirFilter::kAllDirs).testFlag(DEnumerator::DirFilter::kAllDirs)
+        && g_file_info_get_file_type(gfileInfo) == G_FILE_TYPE_DIRECTORY)
+        return true;
+
+    return nameMatcher.matches(QString::fromUtf8(g_file_info_get_name(gfileInfo)));
+}
+
 bool DEnumeratorPrivate::checkFilter()
 {
     if (dirFilters.testFlag(DEnumerator::DirFilter::kNoFilter))
@@ -137,7 +269,28 @@ bool DEnumeratorPrivate::checkFilter()
     if (!dfileInfoNext)
         return false;
 
-    const bool isDir = dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardIsDir).toBool();
+    FilterEntry entry;
+    entry.name = dfileInfoNext->get<DFileInfo::AttributeID::kStandardName>();
+    entry.isDir = dfileInfoNext->get<DFileInfo::AttributeID::kStandardIsDir>();
+    entry.isFile = dfileInfoNext->get<DFileInfo::AttributeID::kStandardIsFile>();
+    entry.isSymlink = dfileInfoNext->get<DFileInfo::AttributeID::kStandardIsSymlink>();
+    if (needAccessFilter()) {
+        entry.readable = dfileInfoNext->get<DFileInfo::AttributeID::kAccessCanRead>();
+        entry.writable = dfileInfoNext->get<DFileInfo::AttributeID::kAccessCanWrite>();
+        entry.executable = dfileInfoNext->get<DFileInfo::AttributeID::kAccessCanExecute>();
+    }
+    if (!(dirFilters & DEnumerator::DirFilter::kHidden).testFlag(DEnumerator::DirFilter::kHidden))
+        entry.parentPath = dfileInfoNext->get<DFileInfo::AttributeID::kStandardParentPath>();
+
+    return checkFilter(entry);
+}
+
+bool DEnumeratorPrivate::checkFilter(const FilterEntry &entry)
+{
+    if (dirFilters.testFlag(DEnumerator::DirFilter::kNoFilter))
+        return true;
+
+    const bool isDir = entry.isDir;
     if ((dirFilters & DEnumerator::DirFilter::kAllDirs).testFlag(DEnumerator::DirFilter::kAllDirs)) {   // all dir, no apply filters rules
         if (isDir)
             return true;
@@ -146,21 +299,17 @@ bool DEnumeratorPrivate::checkFilter()
     // dir filter
     bool ret = true;
 
-    const bool readable = dfileInfoNext->attribute(DFileInfo::AttributeID::kAccessCanRead).toBool();
-    const bool writable = dfileInfoNext->attribute(DFileInfo::AttributeID::kAccessCanWrite).toBool();
-    const bool executable = dfileInfoNext->attribute(DFileInfo::AttributeID::kAccessCanExecute).toBool();
-
     auto checkRWE = [&]() -> bool {
         if ((dirFilters & DEnumerator::DirFilter::kReadable).testFlag(DEnumerator::DirFilter::kReadable)) {
-            if (!readable)
+            if (!entry.readable)
                 return false;
         }
         if ((dirFilters & DEnumerator::DirFilter::kWritable).testFlag(DEnumerator::DirFilter::kWritable)) {
-            if (!writable)
+            if (!entry.writable)
                 return false;
         }
         if ((dirFilters & DEnumerator::DirFilter::kExecutable).testFlag(DEnumerator::DirFilter::kExecutable)) {
-            if (!executable)
+            if (!entry.executable)
                 return false;
         }
         return true;
@@ -180,8 +329,7 @@ bool DEnumeratorPrivate::checkFilter()
                 ret = false;
         }
     } else if ((dirFilters & DEnumerator::DirFilter::kFiles).testFlag(DEnumerator::DirFilter::kFiles)) {
-        const bool isFile = dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardIsFile).toBool();
-        if (!isFile) {
+        if (!entry.isFile) {
             ret = false;
         } else {
             // 判断读写执行
@@ -191,32 +339,26 @@ bool DEnumeratorPrivate::checkFilter()
     }
 
     if ((dirFilters & DEnumerator::DirFilter::kNoSymLinks).testFlag(DEnumerator::DirFilter::kNoSymLinks)) {
-        const bool isSymlinks = dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardIsSymlink).toBool();
-        if (isSymlinks)
+        if (entry.isSymlink)
             ret = false;
     }
 
-    const QString &fileInfoName = dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardName).toString();
+    const QString &fileInfoName = entry.name;
     const bool showHidden = (dirFilters & DEnumerator::DirFilter::kHidden).testFlag(DEnumerator::DirFilter::kHidden);
     if (!showHidden) {   // hide files
-        const QString &parentPath = dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardParentPath).toString();
-        const QUrl &urlHidden = QUrl::fromLocalFile(parentPath + "/.hidden");
-
-        QSet<QString> hideList;
-        if (hideListMap.count(urlHidden) > 0) {
-            hideList = hideListMap.value(urlHidden);
-        } else {
-            hideList = DLocalHelper::hideListFromUrl(urlHidden);
-            hideListMap.insert(urlHidden, hideList);
+        // entries come dir by dir, the shared cache is only asked when the dir changes
+        if (!hideListValid || hideListDir != entry.parentPath) {
+            hideListDir = entry.parentPath;
+            hideList = DHiddenListCache::instance()->hideList(hideListDir);
+            hideListValid = true;
         }
-        bool isHidden = DLocalHelper::fileIsHidden(dfileInfoNext.data(), hideList, false);
+        bool isHidden = fileInfoName.startsWith(".") || hideList.contains(fileInfoName);
         if (isHidden)
             ret = false;
     }
 
-    // filter name
-    const bool caseSensitive = (dirFilters & DEnumerator::DirFilter::kCaseSensitive).testFlag(DEnumerator::DirFilter::kCaseSensitive);
-    if (nameFilters.contains(fileInfoName, caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive))
+    // filter name, only matching names are listed
+    if (!nameMatcher.matches(fileInfoName))
         ret = false;
 
     const bool showDot = !((dirFilters & DEnumerator::DirFilter::kNoDotAndDotDot).testFlag(DEnumerator::DirFilter::kNoDotAndDotDot))
@@ -231,65 +373,234 @@ bool DEnumeratorPrivate::checkFilter()
     return ret;
 }
 
-FTS *DEnumeratorPrivate::openDirByfts()
+quint64 DEnumeratorPrivate::countLocal(const QString &path)
+{
+    DLocalEnumerator enumerator(path);
+    if (!enumerator.open()) {
+        setErrorFromErrno(enumerator.lastErrno());
+        return 0;
+    }
+
+    const bool filter = !dirFilters.testFlag(DEnumerator::DirFilter::kNoFilter);
+    quint64 count = 0;
+    DLocalEnumerator::Entry dirent;
+    while (!enumCanceled && enumerator.next(&dirent, enumLinks)) {
+        const unsigned char type = enumLinks ? dirent.targetType : dirent.type;
+        if (enumSubDir && type == DT_DIR)
+            count += countLocal(enumerator.childPath(dirent.name));
+
+        if (filter) {
+            FilterEntry entry;
+            entry.name = QString::fromLocal8Bit(dirent.name);
+            entry.parentPath = enumerator.path();
+            entry.isDir = type == DT_DIR;
+            entry.isFile = type == DT_REG;
+            entry.isSymlink = dirent.type == DT_LNK;
+            if (needAccessFilter()) {
+                entry.readable = enumerator.access(dirent, R_OK);
+                entry.writable = enumerator.access(dirent, W_OK);
+                entry.executable = enumerator.access(dirent, X_OK);
+            }
+            if (!checkFilter(entry))
+                continue;
+        }
+        ++count;
+    }
+
+    if (enumerator.lastErrno() != 0)
+        setErrorFromErrno(enumerator.lastErrno());
+    return count;
+}
+
+quint64 DEnumeratorPrivate::countGio(const QUrl &url)
 {
-    FTS *fts { nullptr };
-    QString path = q->uri().path();
+    QByteArray attributes = G_FILE_ATTRIBUTE_STANDARD_NAME "," G_FILE_ATTRIBUTE_STANDARD_TYPE "," G_FILE_ATTRIBUTE_STANDARD_IS_SYMLINK;
+    if (needAccessFilter())
+        attributes.append(",access::*");
+
+    g_autoptr(GFile) gfile = g_file_new_for_uri(url.toString().toLocal8Bit().data());
+    g_autoptr(GError) gerror = nullptr;
+    checkAndResetCancel();
+    g_autoptr(GFileEnumerator) enumerator = g_file_enumerate_children(gfile, attributes.constData(),
+                                                                      enumLinks ? G_FILE_QUERY_INFO_NONE : G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+                                                                      cancellable, &gerror);
+    if (!enumerator) {
+        if (gerror)
+            setErrorFromGError(gerror);
+        return 0;
+    }
+
+    const bool filter = !dirFilters.testFlag(DEnumerator::DirFilter::kNoFilter);
+    const QString &parentPath = url.path();
+    quint64 count = 0;
+    while (!enumCanceled) {
+        GFileInfo *gfileInfo = nullptr;
+        GFile *child = nullptr;
+        if (!g_file_enumerator_iterate(enumerator, &gfileInfo, &child, cancellable, &gerror) || !gfileInfo || !child)
+            break;
+
+        const GFileType type = g_file_info_get_file_type(gfileInfo);
+        const bool isSymlink = g_file_info_get_is_symlink(gfileInfo);
+        if (enumSubDir && type == G_FILE_TYPE_DIRECTORY && (!isSymlink || enumLinks)) {
+            g_autofree gchar *childUri = g_file_get_uri(child);
+            count += countGio(QUrl(QString::fromLocal8Bit(childUri)));
+        }
+
+        if (filter) {
+            FilterEntry entry;
+            entry.name = QString::fromUtf8(g_file_info_get_name(gfileInfo));
+            entry.parentPath = parentPath;
+            entry.isDir = type == G_FILE_TYPE_DIRECTORY;
+            entry.isFile = type == G_FILE_TYPE_REGULAR;
+            entry.isSymlink = isSymlink;
+            if (needAccessFilter()) {
+                entry.readable = g_file_info_get_attribute_boolean(gfileInfo, G_FILE_ATTRIBUTE_ACCESS_CAN_READ);
+                entry.writable = g_file_info_get_attribute_boolean(gfileInfo, G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE);
+                entry.executable = g_file_info_get_attribute_boolean(gfileInfo, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE);
+            }
+            if (!checkFilter(entry))
+                continue;
+        }
+        ++count;
+    }
+
+    if (gerror)
+        setErrorFromGError(gerror);
+    return count;
+}
+
+bool DEnumeratorPrivate::readSortEntries()
+{
+    sortRestFuture.waitForFinished();
+    sorter.reset();
+    sortTaken = 0;
+
+    QString path = uri.path();
     if (path != "/" && path.endsWith("/"))
         path = path.left(path.length() - 1);
-    char *paths[2] = { nullptr, nullptr };
-    paths[0] = strdup(path.toUtf8().toStdString().data());
-    int (*compare)(const FTSENT **, const FTSENT **);
-    compare = nullptr;
-    if (sortRoleFlag == DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileName) {
-        compare = DLocalHelper::compareByName;
-    } else if (sortRoleFlag == DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileSize) {
-        compare = DLocalHelper::compareBySize;
-    } else if (sortRoleFlag == DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileLastModified) {
-        compare = DLocalHelper::compareByLastModifed;
-    } else if (sortRoleFlag == DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileLastRead) {
-        compare = DLocalHelper::compareByLastRead;
-    }
-
-    fts = fts_open(paths, FTS_COMFOLLOW, compare);
-
-    if (paths[0])
-        free(paths[0]);
-
-    if (nullptr == fts) {
-        qWarning() << "fts_open open error : " << QString::fromLocal8Bit(strerror(errno));
+
+    // read everything first, then sort the flat array with several threads.
+    // names and sort keys of an unchanged dir come from the listing cache, sizes and times
+    // change without touching the dir so they are read again
+    QScopedPointer<DLocalSorter> localSorter(new DLocalSorter(path));
+    DListingCache *cache = DListingCache::instance();
+    const QSharedPointer<const DListingCache::SortEntries> &cached = cache->sortEntries(path);
+    const DListingCache::Ticket &ticket = cached ? DListingCache::Ticket() : cache->ticket(QUrl::fromLocalFile(path));
+    if (!(cached ? localSorter->restat(*cached, enumCanceled) : localSorter->read(enumCanceled))) {
+        if (enumCanceled)
+            return false;
+        qWarning() << "read dir error : " << QString::fromLocal8Bit(strerror(localSorter->lastErrno()));
         error.setCode(DFMIOErrorCode::DFM_IO_ERROR_FTS_OPEN);
-        return nullptr;
+        return false;
     }
+    if (!cached)
+        cache->insertSortEntries(ticket, localSorter->entries());
+    localSorter->setSorting(sortRoleFlag, sortOrder, isMixDirAndFile);
 
-    return fts;
+    sortHideList = DHiddenListCache::instance()->hideList(path);
+    sorter.swap(localSorter);
+    return true;
 }
 
-void DEnumeratorPrivate::insertSortFileInfoList(QList<QSharedPointer<DEnumerator::SortFileInfo>> &fileList, QList<QSharedPointer<DEnumerator::SortFileInfo>> &dirList, FTSENT *ent, FTS *fts, const QSet<QString> &hideList)
+bool DEnumeratorPrivate::sortAll()
 {
-    QSharedPointer<DFileInfo> info(nullptr);
-    bool isDir = S_ISDIR(ent->fts_statp->st_mode);
-    if (S_ISLNK(ent->fts_statp->st_mode)) {
-        const QUrl &url = QUrl::fromLocalFile(ent->fts_path);
-        info = DLocalHelper::createFileInfoByUri(url);
-        isDir = info->attribute(DFileInfo::AttributeID::kStandardIsDir).toBool();
-    }
+    if (!readSortEntries())
+        return false;
 
-    if (isDir)
-        fts_set(fts, ent, FTS_SKIP);
+    sorter->sortRest(enumCanceled);
+    return !enumCanceled;
+}
 
-    if (isDir && !isMixDirAndFile) {
-        if (sortOrder == Qt::DescendingOrder)
-            dirList.push_front(DLocalHelper::createSortFileInfo(ent, info, hideList));
-        else
-            dirList.push_back(DLocalHelper::createSortFileInfo(ent, info, hideList));
-        return;
-    }
+bool DEnumeratorPrivate::sortFirstPage(size_t count, size_t *end)
+{
+    if (!readSortEntries())
+        return false;
 
-    if (sortOrder == Qt::DescendingOrder)
-        fileList.push_front(DLocalHelper::createSortFileInfo(ent, info, hideList));
-    else
-        fileList.push_back(DLocalHelper::createSortFileInfo(ent, info, hideList));
+    const size_t sorted = sorter->sortFirst(count, enumCanceled);
+    if (enumCanceled)
+        return false;
+
+    *end = qMin(sorted, count);
+    return true;
+}
+
+void DEnumeratorPrivate::startSortRest()
+{
+    // finish the rest while the first page is shown
+    DLocalSorter *localSorter = sorter.data();
+    std::atomic_bool *canceled = &enumCanceled;
+    sortRestFuture = QtConcurrent::run([localSorter, canceled]() {
+        localSorter->sortRest(*canceled);
+    });
+}
+
+bool DEnumeratorPrivate::sortRemaining()
+{
+    if (!sorter)
+        return false;
+
+    sortRestFuture.waitForFinished();
+    sorter->sortRest(enumCanceled);
+    return !enumCanceled;
+}
+
+QList<QSharedPointer<DEnumerator::SortFileInfo>> DEnumeratorPrivate::takeSortFileInfos(size_t end)
+{
+    const std::vector<DLocalSorter::Entry> &entries = sorter->entries();
+    const size_t begin = sortTaken;
+    end = qMin(end, entries.size());
+    if (begin >= end)
+        return {};
+    sortTaken = end;
+
+    QVector<QSharedPointer<DEnumerator::SortFileInfo>> infos(static_cast<int>(end - begin));
+    QSharedPointer<DEnumerator::SortFileInfo> *data = infos.data();
+    QVector<int> indexes(infos.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+    QtConcurrent::blockingMap(indexes, [&](int index) {
+        const DLocalSorter::Entry &entry = entries[begin + static_cast<size_t>(index)];
+        data[index] = DLocalHelper::createSortFileInfo(sorter->childPath(entry), entry, sortHideList);
+    });
+
+    QList<QSharedPointer<DEnumerator::SortFileInfo>> list;
+    list.reserve(infos.size());
+    for (const auto &info : infos)
+        list.append(info);
+    return list;
+}
+
+DSortedListing DEnumeratorPrivate::takeSortedListing(size_t end)
+{
+    const std::vector<DLocalSorter::Entry> &entries = sorter->entries();
+    const size_t begin = sortTaken;
+    end = qMin(end, entries.size());
+    DSortedListing listing(sorter->path());
+    if (begin >= end)
+        return listing;
+    sortTaken = end;
+
+    int nameBytes = 0;
+    for (size_t i = begin; i < end; ++i)
+        nameBytes += entries[i].name.size();
+    listing.reserve(static_cast<int>(end - begin), nameBytes);
+
+    for (size_t i = begin; i < end; ++i) {
+        const DLocalSorter::Entry &entry = entries[i];
+        const QString &name = entry.key.name();
+        DSortedListing::Flags flags = entry.isDir ? DSortedListing::kIsDir : DSortedListing::kIsFile;
+        if (entry.isSymlink)
+            flags |= DSortedListing::kIsSymLink;
+        if (name.startsWith(".") || sortHideList.contains(name))
+            flags |= DSortedListing::kIsHide;
+        if (entry.isReadable)
+            flags |= DSortedListing::kIsReadable;
+        if (entry.isWritable)
+            flags |= DSortedListing::kIsWriteable;
+        if (entry.isExecutable)
+            flags |= DSortedListing::kIsExecutable;
+        listing.append(entry.name.constData(), entry.name.size(), flags, entry.size, entry.modified.tv_sec);
+    }
+    return listing;
 }
 
 void DEnumeratorPrivate::enumUriAsyncOvered(GList *files)
@@ -306,18 +617,150 @@ void DEnumeratorPrivate::enumUriAsyncOvered(GList *files)
     g_list_free(files);
 }
 
+void DEnumeratorPrivate::emitAsyncBatch(GList *files)
+{
+    QList<QSharedPointer<DFileInfo>> infos;
+    int received = 0;
+    for (GList *l = files; l != nullptr; l = l->next) {
+        GFileInfo *gfileInfo = static_cast<GFileInfo *>(l->data);
+        if (!gfileInfo)
+            continue;
+        ++received;
+        if (!checkNameFilter(gfileInfo)) {
+            g_object_unref(gfileInfo);
+            continue;
+        }
+
+        // the info is handed over as is, no dup
+        dfileInfoNext = DLocalHelper::createFileInfoByUri(childUrl(g_file_info_get_name(gfileInfo)), gfileInfo, queryAttributes.constData(),
+                                                          enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone
+                                                                    : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks);
+        if (checkFilter())
+            infos.append(dfileInfoNext);
+    }
+    g_list_free(files);
+    dfileInfoNext.reset();
+
+    adaptAsyncBatchSize(batchTimer.elapsed(), received);
+
+    if (infos.isEmpty())
+        return;
+    ++pendingBatches;
+    Q_EMIT asyncBatchReady(infos);
+}
+
+void DEnumeratorPrivate::adaptAsyncBatchSize(qint64 elapsed, int received)
+{
+    // a short batch means the end of the dir, its latency says nothing
+    if (received < asyncBatchSize)
+        return;
+
+    if (elapsed < kBatchLatencyTarget / 2)
+        asyncBatchSize = qMin(asyncBatchSize * 2, kMaxBatchSize);
+    else if (elapsed > kBatchLatencyTarget * 2)
+        asyncBatchSize = qMax(asyncBatchSize / 2, kMinBatchSize);
+}
+
+void DEnumeratorPrivate::requestMoreFiles(EnumUriData *data, int count)
+{
+    // canceled from a batch handler, checkAndResetCancel() would undo it
+    if (asyncStoped) {
+        releaseEnumUriData(data, true);
+        return;
+    }
+
+    if (asyncBatchMode) {
+        // the consumer is behind, go on in asyncBatchConsumed
+        if (maxPendingBatches > 0 && pendingBatches >= maxPendingBatches) {
+            pausedData = data;
+            return;
+        }
+        count = asyncBatchSize;
+        batchTimer.start();
+    }
+
+    checkAndResetCancel();
+    g_file_enumerator_next_files_async(data->enumerator,
+                                       count,
+                                       G_PRIORITY_DEFAULT,
+                                       cancellable,
+                                       moreFilesCallback,
+                                       data);
+}
+
+void DEnumeratorPrivate::asyncBatchConsumed()
+{
+    if (pendingBatches > 0)
+        --pendingBatches;
+
+    if (!pausedData || asyncStoped)
+        return;
+    if (maxPendingBatches > 0 && pendingBatches >= maxPendingBatches)
+        return;
+
+    EnumUriData *data = pausedData;
+    pausedData = nullptr;
+    requestMoreFiles(data, asyncBatchSize);
+}
+
+bool DEnumeratorPrivate::isCurrentAsync(EnumUriData *data)
+{
+    return data->pointer && !data->pointer->asyncStoped && data->generation == data->pointer->asyncGeneration;
+}
+
+void DEnumeratorPrivate::releaseEnumUriData(EnumUriData *data, bool notifyOver)
+{
+    // data may hold the last reference to the enumerator
+    const QSharedPointer<DEnumeratorPrivate> self = data->pointer;
+    if (data->enumerator) {
+        if (!g_file_enumerator_is_closed(data->enumerator))
+            g_file_enumerator_close_async(data->enumerator, 0, nullptr, nullptr, nullptr);
+        g_object_unref(data->enumerator);
+    }
+    delete data;
+
+    if (notifyOver && self) {
+        self->asyncOvered = true;
+        Q_EMIT self->asyncIteratorOver();
+    }
+}
+
+QUrl DEnumeratorPrivate::childUrl(const char *name) const
+{
+    if (uri.isLocalFile())
+        return QUrl::fromLocalFile(uri.path() + "/" + QString(name));
+
+    QUrl url = uri;
+    QString path = url.path();
+    if (!path.endsWith("/"))
+        path.append("/");
+    url.setPath(path + QString(name));
+    return url;
+}
+
 void DEnumeratorPrivate::startAsyncIterator()
 {
     qInfo() << "start Async Iterator，uri = " << uri;
+    // a paused run of an earlier call is dropped, one still in flight drops itself
+    if (pausedData) {
+        releaseEnumUriData(pausedData, false);
+        pausedData = nullptr;
+    }
+    ++asyncGeneration;
     asyncStoped = false;
+    asyncOvered = false;
+    asyncBatchSize = kFirstBatchSize;
+    pendingBatches = 0;
+    buildQueryAttributes();
     const QString &uriPath = uri.toString();
     g_autoptr(GFile) gfile = g_file_new_for_uri(uriPath.toLocal8Bit().data());
 
     checkAndResetCancel();
     EnumUriData *userData = new EnumUriData();
     userData->pointer = sharedFromThis();
+    userData->generation = asyncGeneration;
     g_file_enumerate_children_async(gfile,
-                                    FILE_DEFAULT_ATTRIBUTES,
+                                    queryAttributes.constData(),
                                     G_FILE_QUERY_INFO_NONE,
                                     G_PRIORITY_DEFAULT,
                                     cancellable,
@@ -330,41 +773,191 @@ bool DEnumeratorPrivate::hasNext()
     if (!asyncOvered)
         return false;
 
-    if (asyncInfos.isEmpty())
-        return false;
+    // filters select the entries, most may be rejected in a row
+    while (!asyncInfos.isEmpty()) {
+        auto gfileInfo = asyncInfos.takeFirst();
+        if (!gfileInfo)
+            continue;
+
+        if (!checkNameFilter(gfileInfo)) {
+            g_object_unref(gfileInfo);
+            continue;
+        }
+
+        nextUrl = QUrl::fromLocalFile(uri.path() + "/" + QString(g_file_info_get_name(gfileInfo)));
+
+        // the taken info is handed over, no copy
+        dfileInfoNext = DLocalHelper::createFileInfoByUri(nextUrl, gfileInfo, queryAttributes.constData(),
+                                                          enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks);
+
+        if (checkFilter())
+            return true;
+    }
+
+    return false;
+}
 
-    auto gfileInfo = asyncInfos.takeFirst();
+bool DEnumeratorPrivate::hasNextCached()
+{
+    dfileInfoNext.reset();
+
+    while (!enumCanceled && cachedIndex < cachedListing->infos.size()) {
+        const int index = cachedIndex++;
+        GFileInfo *gfileInfo = cachedListing->infos.at(index);
+        if (!checkNameFilter(gfileInfo))
+            continue;
 
-    if (!gfileInfo)
-        return hasNext();
+        // the cached info stays as it is, the DFileInfo gets a copy
+        nextUrl = cachedListing->urls.at(index);
+        dfileInfoNext = DLocalHelper::createFileInfoByUri(nextUrl, g_file_info_dup(gfileInfo), queryAttributes.constData(),
+                                                          enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks);
+        if (checkFilter())
+            return true;
+    }
 
-    nextUrl = QUrl::fromLocalFile(uri.path() + "/" + QString(g_file_info_get_name(gfileInfo)));
+    dfileInfoNext.reset();
+    return false;
+}
 
-    dfileInfoNext = DLocalHelper::createFileInfoByUri(nextUrl, g_file_info_dup(gfileInfo), FILE_DEFAULT_ATTRIBUTES,
-                                                      enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks);
+void DEnumeratorPrivate::commitRecording()
+{
+    // only a listing read to the end is complete
+    if (recording && !enumCanceled)
+        DListingCache::instance()->insertInfoListing(cacheTicket, queryAttributes, enumLinks, recording.take());
+    recording.reset();
+}
 
-    g_object_unref(gfileInfo);
+bool DEnumeratorPrivate::hasNextLocal()
+{
+    localEntryValid = false;
+    dfileInfoNext.reset();
+
+    while (!enumCanceled) {
+        // walk into the dir returned last time before reading on, like the gio path does
+        if (localDescend && !stackLocalEnumerator.isEmpty()) {
+            localDescend = false;
+            init(QUrl::fromLocalFile(stackLocalEnumerator.top()->childPath(localEntry.name)));
+        }
 
-    if (!checkFilter())
-        return hasNext();
+        if (stackLocalEnumerator.isEmpty())
+            return false;
 
-    return true;
+        DLocalEnumerator *enumerator = stackLocalEnumerator.top();
+        if (!enumerator->next(&localEntry, enumLinks)) {
+            const int errnum = enumerator->lastErrno();
+            delete stackLocalEnumerator.pop();
+            if (errnum != 0) {
+                setErrorFromErrno(errnum);
+                return false;
+            }
+            continue;
+        }
+
+        const bool isSymlink = localEntry.type == DT_LNK;
+        const unsigned char type = enumLinks ? localEntry.targetType : localEntry.type;
+        localDescend = enumSubDir && type == DT_DIR;
+
+        if (!dirFilters.testFlag(DEnumerator::DirFilter::kNoFilter)) {
+            FilterEntry entry;
+            entry.name = QString::fromLocal8Bit(localEntry.name);
+            entry.parentPath = enumerator->path();
+            entry.isDir = type == DT_DIR;
+            entry.isFile = type == DT_REG;
+            entry.isSymlink = isSymlink;
+            if (needAccessFilter()) {
+                entry.readable = enumerator->access(localEntry, R_OK);
+                entry.writable = enumerator->access(localEntry, W_OK);
+                entry.executable = enumerator->access(localEntry, X_OK);
+            }
+            if (!checkFilter(entry))
+                continue;
+        }
+
+        nextUrl = QUrl::fromLocalFile(enumerator->childPath(localEntry.name));
+        localEntryValid = true;
+        return true;
+    }
+
+    return false;
+}
+
+bool DEnumeratorPrivate::hasNextWalker()
+{
+    localEntryValid = false;
+    dfileInfoNext.reset();
+
+    while (!enumCanceled && walker->next(&walkerEntry)) {
+        walkerPath = walkerEntry.path();
+        const unsigned char type = enumLinks ? walkerEntry.targetType : walkerEntry.type;
+
+        // the workers only read, filters run here so the hide list memo stays single threaded
+        if (!dirFilters.testFlag(DEnumerator::DirFilter::kNoFilter)) {
+            FilterEntry entry;
+            entry.name = QString::fromLocal8Bit(walkerEntry.name);
+            entry.parentPath = QString::fromLocal8Bit(walkerEntry.parentPath);
+            entry.isDir = type == DT_DIR;
+            entry.isFile = type == DT_REG;
+            entry.isSymlink = walkerEntry.type == DT_LNK;
+            if (needAccessFilter()) {
+                entry.readable = DLocalEnumerator::accessAt(AT_FDCWD, walkerPath.constData(), R_OK);
+                entry.writable = DLocalEnumerator::accessAt(AT_FDCWD, walkerPath.constData(), W_OK);
+                entry.executable = DLocalEnumerator::accessAt(AT_FDCWD, walkerPath.constData(), X_OK);
+            }
+            if (!checkFilter(entry))
+                continue;
+        }
+
+        nextUrl = QUrl::fromLocalFile(QString::fromLocal8Bit(walkerPath));
+        localEntryValid = true;
+        return true;
+    }
+
+    if (walker->lastErrno() != 0)
+        setErrorFromErrno(walker->lastErrno());
+    return false;
+}
+
+QSharedPointer<DFileInfo> DEnumeratorPrivate::createLocalFileInfo()
+{
+    if (!localEntryValid || (!walker && stackLocalEnumerator.isEmpty()))
+        return nullptr;
+
+    const DFileInfo::FileQueryInfoFlags flag = enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone
+                                                         : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks;
+    GFileAttributeMatcher *matcher = DLocalHelper::attributeMatcher(queryAttributes.constData());
+    GFileInfo *gfileInfo = nullptr;
+    if (walker) {
+        // the entries of one dir come in a row, its access is read once for them
+        const bool needsParent = DLocalEnumerator::needsParentAccess(matcher);
+        if (needsParent && walkerEntry.parentPath != walkerParentPath) {
+            walkerParentPath = walkerEntry.parentPath;
+            walkerParent = DLocalEnumerator::parentAccess(walkerParentPath, matcher);
+        }
+        gfileInfo = DLocalEnumerator::createFileInfoAt(AT_FDCWD, walkerPath.constData(), walkerEntry.name.constData(),
+                                                       walkerEntry.type, walkerEntry.targetType, matcher, queryStatxMask, enumLinks,
+                                                       needsParent ? &walkerParent : nullptr);
+    } else {
+        gfileInfo = stackLocalEnumerator.top()->createFileInfo(localEntry, matcher, queryStatxMask, enumLinks);
+    }
+    return DLocalHelper::createFileInfoByUri(nextUrl, gfileInfo, queryAttributes.constData(), flag);
 }
 
 QList<QSharedPointer<DFileInfo>> DEnumeratorPrivate::fileInfoList()
 {
     if (asyncOvered)
         return QList<QSharedPointer<DFileInfo>>();
+    // the infos are handed over to the DFileInfos, no copies
+    infoList.reserve(infoList.size() + asyncInfos.size());
     for (auto gfileInfo : asyncInfos) {
         if (!gfileInfo)
             continue;
         auto url = QUrl::fromLocalFile(uri.path() + "/" + QString(g_file_info_get_name(gfileInfo)));
 
-        infoList.append(DLocalHelper::createFileInfoByUri(url, g_file_info_dup(gfileInfo), FILE_DEFAULT_ATTRIBUTES,
+        infoList.append(DLocalHelper::createFileInfoByUri(url, gfileInfo, queryAttributes.constData(),
                                                           enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone
                                                                     : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks));
-        g_object_unref(gfileInfo);
     }
+    asyncInfos.clear();
 
     return infoList;
 }
@@ -372,78 +965,58 @@ QList<QSharedPointer<DFileInfo>> DEnumeratorPrivate::fileInfoList()
 void DEnumeratorPrivate::enumUriAsyncCallBack(GObject *sourceObject, GAsyncResult *res, gpointer userData)
 {
     EnumUriData *data = static_cast<EnumUriData *>(userData);
-    if (!data || !data->pointer || data->pointer->asyncStoped) {
-        qInfo() << "user data error " << data;
+    if (!data)
         return;
-    }
 
-    GFileEnumerator *enumerator;
-    GError *error { nullptr };
-    enumerator = g_file_enumerate_children_finish(G_FILE(sourceObject), res, &error);
+    g_autoptr(GError) error = nullptr;
+    data->enumerator = g_file_enumerate_children_finish(G_FILE(sourceObject), res, &error);
+    if (!isCurrentAsync(data)) {
+        // canceled, or restarted by another startAsyncIterator()
+        releaseEnumUriData(data, data->pointer && data->generation == data->pointer->asyncGeneration);
+        return;
+    }
 
     if (error) {
         qInfo() << "enumerator url : " << data->pointer->uri << ". error msg : " << error->message;
         data->pointer->setErrorFromGError(error);
     }
 
-    if (enumerator == nullptr || error) {
+    if (data->enumerator == nullptr || error) {
         data->pointer->enumUriAsyncOvered(nullptr);
+        releaseEnumUriData(data, false);
     } else {
-        data->enumerator = enumerator;
-        data->pointer->checkAndResetCancel();
-        g_file_enumerator_next_files_async(enumerator,
-                                           1000,
-                                           G_PRIORITY_DEFAULT,
-                                           data->pointer->cancellable,
-                                           moreFilesCallback,
-                                           data);
+        data->pointer->requestMoreFiles(data, 1000);
     }
-
-    if (error)
-        g_error_free(error);
-
-    return;
 }
 
 void DEnumeratorPrivate::moreFilesCallback(GObject *sourceObject, GAsyncResult *res, gpointer userData)
 {
     Q_UNUSED(sourceObject);
     EnumUriData *data = static_cast<EnumUriData *>(userData);
-    if (!data || !data->pointer || data->pointer->asyncStoped) {
-        qInfo() << "user data error " << data;
+    if (!data)
         return;
-    }
-
-    GError *error;
-    GList *files;
-    error = nullptr;
-    GFileEnumerator *enumerator = data->enumerator;
-    files = g_file_enumerator_next_files_finish(enumerator,
-                                                res, &error);
-    if (error)
-        data->pointer->setErrorFromGError(error);
 
-    data->pointer->enumUriAsyncOvered(files);
-    if (files && !error) {
-        data->pointer->checkAndResetCancel();
-        g_file_enumerator_next_files_async(enumerator,
-                                           100,
-                                           G_PRIORITY_DEFAULT,
-                                           data->pointer->cancellable,
-                                           moreFilesCallback,
-                                           data);
-    } else {
-        if (!g_file_enumerator_is_closed(data->enumerator)) {
-            g_file_enumerator_close_async(data->enumerator,
-                                          0, nullptr, nullptr, nullptr);
-        }
-        g_object_unref(data->enumerator);
-        data->enumerator = nullptr;
+    g_autoptr(GError) error = nullptr;
+    GList *files = g_file_enumerator_next_files_finish(data->enumerator, res, &error);
+    if (!isCurrentAsync(data)) {
+        // canceled, or restarted by another startAsyncIterator()
+        g_list_free_full(files, g_object_unref);
+        releaseEnumUriData(data, data->pointer && data->generation == data->pointer->asyncGeneration);
+        return;
     }
 
     if (error)
-        g_error_free(error);
+        data->pointer->setErrorFromGError(error);
 
+    const bool hasFiles = files != nullptr;
+    if (hasFiles && data->pointer->asyncBatchMode)
+        data->pointer->emitAsyncBatch(files);
+    else
+        data->pointer->enumUriAsyncOvered(files);
+    if (hasFiles && !error)
+        data->pointer->requestMoreFiles(data, 100);
+    else
+        releaseEnumUriData(data, false);
 }
 
 /************************************************
@@ -463,6 +1036,7 @@ DEnumerator::DEnumerator(const QUrl &uri, const QStringList &nameFilters, DirFil
     d->nameFilters = nameFilters;
     d->dirFilters = filters;
     d->iteratorFlags = flags;
+    d->updateNameMatcher();
 
     d->enumSubDir = d->iteratorFlags & DEnumerator::IteratorFlag::kSubdirectories;
     d->enumLinks = d->iteratorFlags & DEnumerator::IteratorFlag::kFollowSymlinks;
@@ -480,6 +1054,7 @@ QUrl DEnumerator::uri() const
 void DEnumerator::setNameFilters(const QStringList &filters)
 {
     d->nameFilters = filters;
+    d->updateNameMatcher();
 }
 
 QStringList DEnumerator::nameFilters() const
@@ -490,6 +1065,7 @@ QStringList DEnumerator::nameFilters() const
 void DEnumerator::setDirFilters(DirFilters filters)
 {
     d->dirFilters = filters;
+    d->updateNameMatcher();
 }
 
 DEnumerator::DirFilters DEnumerator::dirFilters() const
@@ -547,12 +1123,50 @@ bool DEnumerator::isSortMixed() const
     return d->isMixDirAndFile;
 }
 
+void DEnumerator::setQueryAttributes(const QList<DFileInfo::AttributeID> &attributes)
+{
+    d->queryAttributeIds = attributes;
+}
+
+QList<DFileInfo::AttributeID> DEnumerator::queryAttributes() const
+{
+    return d->queryAttributeIds;
+}
+
+void DEnumerator::setMaxThreadCount(int count)
+{
+    d->maxThreadCount = qMax(1, count);
+}
+
+int DEnumerator::maxThreadCount() const
+{
+    return d->maxThreadCount;
+}
+
+void DEnumerator::setListingCacheLimit(qint64 bytes)
+{
+    DListingCache::instance()->setMaxCost(bytes);
+}
+
+qint64 DEnumerator::listingCacheLimit()
+{
+    return DListingCache::instance()->maxCost();
+}
+
 bool DEnumerator::cancel()
 {
     if (d->cancellable && !g_cancellable_is_cancelled(d->cancellable))
         g_cancellable_cancel(d->cancellable);
-    d->ftsCanceled = true;
+    d->enumCanceled = true;
+    if (d->walker)
+        d->walker->cancel();
     d->asyncStoped = true;
+    // a paused run has no callback left to end it
+    if (d->pausedData) {
+        DEnumeratorPrivate::EnumUriData *data = d->pausedData;
+        d->pausedData = nullptr;
+        DEnumeratorPrivate::releaseEnumUriData(data, true);
+    }
     return true;
 }
 
@@ -564,35 +1178,56 @@ bool DEnumerator::hasNext() const
     if (!d->inited)
         d->init();
 
-    if (d->stackEnumerator.isEmpty())
-        return false;
-
-    // sub dir enumerator
-    if (d->enumSubDir && d->dfileInfoNext && d->dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardIsDir).toBool()) {
-        bool showDir = true;
-        if (d->dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardIsSymlink).toBool()) {
-            // is symlink, need enumSymlink
-            showDir = d->enumLinks;
+    if (d->walker)
+        return d->hasNextWalker();
+
+    if (d->localEnumerate)
+        return d->hasNextLocal();
+
+    if (d->cachedListing)
+        return d->hasNextCached();
+
+    // filters select the entries, most may be rejected in a row
+    for (;;) {
+        if (d->stackEnumerator.isEmpty())
+            return false;
+
+        // sub dir enumerator, the dir last handed out or rejected by the filters
+        if (d->enumSubDir && d->dfileInfoNext && d->dfileInfoNext->get<DFileInfo::AttributeID::kStandardIsDir>()) {
+            bool showDir = true;
+            if (d->dfileInfoNext->get<DFileInfo::AttributeID::kStandardIsSymlink>()) {
+                // is symlink, need enumSymlink
+                showDir = d->enumLinks;
+            }
+            if (showDir)
+                d->init(d->nextUrl);
+        }
+        // walked once, a popped enumerator must not enter it again
+        d->dfileInfoNext.reset();
+        if (d->stackEnumerator.isEmpty())
+            return false;
+
+        GFileEnumerator *enumerator = d->stackEnumerator.top();
+
+        GFileInfo *gfileInfo = nullptr;
+        GFile *gfile = nullptr;
+
+        g_autoptr(GError) gerror = nullptr;
+        d->checkAndResetCancel();
+        bool hasNext = g_file_enumerator_iterate(enumerator, &gfileInfo, &gfile, d->cancellable, &gerror);
+        if (!hasNext) {
+            if (gerror)
+                d->setErrorFromGError(gerror);
+            d->recording.reset();
+            return false;
         }
-        if (showDir)
-            d->init(d->nextUrl);
-    }
-    if (d->stackEnumerator.isEmpty())
-        return false;
-
-    GFileEnumerator *enumerator = d->stackEnumerator.top();
-
-    GFileInfo *gfileInfo = nullptr;
-    GFile *gfile = nullptr;
 
-    g_autoptr(GError) gerror = nullptr;
-    d->checkAndResetCancel();
-    bool hasNext = g_file_enumerator_iterate(enumerator, &gfileInfo, &gfile, d->cancellable, &gerror);
-    if (hasNext) {
         if (!gfileInfo || !gfile) {
             GFileEnumerator *enumeratorPop = d->stackEnumerator.pop();
             g_object_unref(enumeratorPop);
-            return this->hasNext();
+            if (d->stackEnumerator.isEmpty())
+                d->commitRecording();
+            continue;
         }
 
         g_autofree gchar *path = g_file_get_path(gfile);
@@ -602,19 +1237,20 @@ bool DEnumerator::hasNext() const
             g_autofree gchar *uri = g_file_get_uri(gfile);
             d->nextUrl = QUrl(QString::fromLocal8Bit(uri));
         }
-        d->dfileInfoNext = DLocalHelper::createFileInfoByUri(d->nextUrl, g_file_info_dup(gfileInfo), FILE_DEFAULT_ATTRIBUTES,
-                                                             d->enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks);
+        // the cache keeps every entry, the filters run on each use
+        if (d->recording)
+            d->recording->append(d->nextUrl, g_file_info_dup(gfileInfo));
 
-        if (!d->checkFilter())
-            return this->hasNext();
+        // sub dirs are walked from dfileInfoNext, they need the full check
+        if (!d->enumSubDir && !d->checkNameFilter(gfileInfo))
+            continue;
+        // the enumerator drops its own reference on the next iterate
+        d->dfileInfoNext = DLocalHelper::createFileInfoByUri(d->nextUrl, G_FILE_INFO(g_object_ref(gfileInfo)), d->queryAttributes.constData(),
+                                                             d->enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks);
 
-        return true;
+        if (d->checkFilter())
+            return true;
     }
-
-    if (gerror)
-        d->setErrorFromGError(gerror);
-
-    return false;
 }
 
 QUrl DEnumerator::next() const
@@ -624,11 +1260,23 @@ QUrl DEnumerator::next() const
 
 QSharedPointer<DFileInfo> DEnumerator::fileInfo() const
 {
+    // native entries are only turned into a DFileInfo when someone asks for it
+    if (d->localEnumerate && !d->dfileInfoNext)
+        d->dfileInfoNext = d->createLocalFileInfo();
     return d->dfileInfoNext;
 }
 
 quint64 DEnumerator::fileCount()
 {
+    // nothing read yet: count names and types only, no info is built
+    if (!d->async && !d->inited) {
+        const QUrl &url = uri();
+        if (url.isLocalFile() && !(d->enumSubDir && d->maxThreadCount > 1))
+            return d->countLocal(url.toLocalFile());
+        if (!url.isLocalFile() && timeout() == 0)
+            return d->countGio(url);
+    }
+
     if (!d->inited)
         d->init();
 
@@ -650,9 +1298,25 @@ QList<QSharedPointer<DFileInfo>> DEnumerator::fileInfoList()
 
     g_autoptr(GFile) gfile = g_file_new_for_uri(d->uri.toString().toStdString().c_str());
 
+    d->buildQueryAttributes();
+    const DFileInfo::FileQueryInfoFlags flag = d->enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks;
+
+    // a listing in the cache needs no trip to the dir, every DFileInfo gets a copy of its info.
+    // local dirs are not kept, their children change without the dir noticing
+    DListingCache *cache = DListingCache::instance();
+    const bool useCache = !d->uri.isLocalFile();
+    const QSharedPointer<const DListingCache::InfoListing> &cached = useCache ? cache->infoListing(d->uri, d->queryAttributes, d->enumLinks) : nullptr;
+    if (cached) {
+        d->infoList.reserve(d->infoList.size() + cached->infos.size());
+        for (int i = 0; i < cached->infos.size(); ++i)
+            d->infoList.append(DLocalHelper::createFileInfoByUri(cached->urls.at(i), g_file_info_dup(cached->infos.at(i)), d->queryAttributes.constData(), flag));
+        return d->infoList;
+    }
+    const DListingCache::Ticket &ticket = useCache ? cache->ticket(d->uri) : DListingCache::Ticket();
+
     d->checkAndResetCancel();
     enumerator = g_file_enumerate_children(gfile,
-                                           FILE_DEFAULT_ATTRIBUTES,
+                                           d->queryAttributes.constData(),
                                            d->enumLinks ? G_FILE_QUERY_INFO_NONE : G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
                                            d->cancellable,
                                            &gerror);
@@ -664,69 +1328,91 @@ QList<QSharedPointer<DFileInfo>> DEnumerator::fileInfoList()
         return d->infoList;
     }
 
-    GFile *gfileIn = nullptr;
-    GFileInfo *gfileInfoIn = nullptr;
-
+    // one pass over the dir, every enumerated info is handed over to its DFileInfo
+    // instead of being queried again on the first attribute read
+    std::vector<GFileInfo *> gfileInfos;
     d->checkAndResetCancel();
-    while (g_file_enumerator_iterate(enumerator, &gfileInfoIn, &gfileIn, d->cancellable, &gerror)) {
-        if (!gfileInfoIn)
-            break;
-
-        g_autofree gchar *uri = g_file_get_uri(gfileIn);
-        const QUrl &url = QUrl(QString::fromLocal8Bit(uri));
-        QSharedPointer<DFileInfo> info = DLocalHelper::createFileInfoByUri(url);
-        if (info)
-            d->infoList.append(info);
-
-        if (gerror) {
-            d->setErrorFromGError(gerror);
-            gerror = nullptr;
-        }
-    }
+    while (GFileInfo *gfileInfo = g_file_enumerator_next_file(enumerator, d->cancellable, &gerror))
+        gfileInfos.push_back(gfileInfo);
 
     if (gerror)
         d->setErrorFromGError(gerror);
 
+    // only a complete listing goes into the cache
+    QScopedPointer<DListingCache::InfoListing> listing(ticket.valid && !gerror ? new DListingCache::InfoListing : nullptr);
+    d->infoList.reserve(d->infoList.size() + static_cast<int>(gfileInfos.size()));
+    for (GFileInfo *gfileInfo : gfileInfos) {
+        g_autoptr(GFile) child = g_file_enumerator_get_child(enumerator, gfileInfo);
+        g_autofree gchar *uri = g_file_get_uri(child);
+        const QUrl &url = QUrl(QString::fromLocal8Bit(uri));
+        if (listing)
+            listing->append(url, g_file_info_dup(gfileInfo));
+        d->infoList.append(DLocalHelper::createFileInfoByUri(url, gfileInfo, d->queryAttributes.constData(), flag));
+    }
+    if (listing)
+        cache->insertInfoListing(ticket, d->queryAttributes, d->enumLinks, listing.take());
+
     return d->infoList;
 }
 
 QList<QSharedPointer<DEnumerator::SortFileInfo>> DEnumerator::sortFileInfoList()
 {
-    FTS *fts = d->openDirByfts();
-    if (!fts)
+    if (!d->sortAll())
+        return {};
+
+    return d->takeSortFileInfos(d->sorter->entries().size());
+}
+
+QList<QSharedPointer<DEnumerator::SortFileInfo>> DEnumerator::sortFileInfoList(int firstN)
+{
+    if (firstN <= 0)
+        return sortFileInfoList();
+
+    size_t end = 0;
+    if (!d->sortFirstPage(static_cast<size_t>(firstN), &end))
         return {};
 
-    QList<QSharedPointer<DEnumerator::SortFileInfo>> listFile;
-    QList<QSharedPointer<DEnumerator::SortFileInfo>> listDir;
-    QSet<QString> hideList;
-    const QUrl &urlHidden = QUrl::fromLocalFile(d->uri.path() + "/.hidden");
-    hideList = DLocalHelper::hideListFromUrl(urlHidden);
-    while (1) {
-        FTSENT *ent = fts_read(fts);
+    const QList<QSharedPointer<DEnumerator::SortFileInfo>> &list = d->takeSortFileInfos(end);
+    d->startSortRest();
+    return list;
+}
 
-        if (ent == nullptr) {
-            break;
-        }
+QList<QSharedPointer<DEnumerator::SortFileInfo>> DEnumerator::remainingSortFileInfoList()
+{
+    if (!d->sortRemaining())
+        return {};
 
-        if (d->ftsCanceled)
-            break;
+    return d->takeSortFileInfos(d->sorter->entries().size());
+}
 
-        unsigned short flag = ent->fts_info;
+DSortedListing DEnumerator::sortedListing()
+{
+    if (!d->sortAll())
+        return DSortedListing();
 
-        if (QString(ent->fts_path) == d->uri.path() || flag == FTS_DP)
-            continue;
+    return d->takeSortedListing(d->sorter->entries().size());
+}
 
-        d->insertSortFileInfoList(listFile, listDir, ent, fts, hideList);
-    }
+DSortedListing DEnumerator::sortedListing(int firstN)
+{
+    if (firstN <= 0)
+        return sortedListing();
 
-    fts_close(fts);
-    fts = nullptr;
+    size_t end = 0;
+    if (!d->sortFirstPage(static_cast<size_t>(firstN), &end))
+        return DSortedListing();
 
-    if (d->isMixDirAndFile)
-        return listFile;
+    const DSortedListing &listing = d->takeSortedListing(end);
+    d->startSortRest();
+    return listing;
+}
+
+DSortedListing DEnumerator::remainingSortedListing()
+{
+    if (!d->sortRemaining())
+        return DSortedListing();
 
-    listDir.append(listFile);
-    return listDir;
+    return d->takeSortedListing(d->sorter->entries().size());
 }
 
 DFMIOError DEnumerator::lastError() const
@@ -739,6 +1425,7 @@ DEnumeratorFuture *DEnumerator::asyncIterator()
     d->async = true;
     DEnumeratorFuture *future = new DEnumeratorFuture(sharedFromThis());
     QObject::connect(d.data(), &DEnumeratorPrivate::asyncIteratorOver, future, &DEnumeratorFuture::onAsyncIteratorOver);
+    QObject::connect(d.data(), &DEnumeratorPrivate::asyncBatchReady, future, &DEnumeratorFuture::onAsyncBatchReady);
     return future;
 }
 
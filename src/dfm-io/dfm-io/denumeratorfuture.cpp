@@ -2,14 +2,34 @@
 //
 // SPDX-License-Identifier: GPL-3.0-or-later
 
+#include "private/denumerator_p.h"
+
 #include <dfm-io/denumeratorfuture.h>
 #include <dfm-io/dfileinfo.h>
 #include <dfm-io/dfmio_utils.h>
 
 USING_IO_NAMESPACE
+
+namespace {
+// queued batches need the types, registered by the names the signals spell them with.
+// a Q_DECLARE_METATYPE in the public header would collide with clients declaring them
+void registerBatchTypes()
+{
+    static const bool registered = [] {
+        qRegisterMetaType<QSharedPointer<DFileInfo>>("QSharedPointer<dfmio::DFileInfo>");
+        qRegisterMetaType<QList<QSharedPointer<DFileInfo>>>("QList<QSharedPointer<dfmio::DFileInfo>>");
+        // DEnumeratorPrivate::asyncBatchReady, declared inside the namespace
+        qRegisterMetaType<QList<QSharedPointer<DFileInfo>>>("QList<QSharedPointer<DFileInfo>>");
+        return true;
+    }();
+    Q_UNUSED(registered)
+}
+}   // namespace
+
 DEnumeratorFuture::DEnumeratorFuture(const QSharedPointer<DEnumerator> &enumerator, QObject *parent)
     : QObject(parent), enumerator(enumerator)
 {
+    registerBatchTypes();
 }
 
 DEnumeratorFuture::~DEnumeratorFuture()
@@ -21,6 +41,16 @@ void DEnumeratorFuture::startAsyncIterator()
     enumerator->startAsyncIterator();
 }
 
+void DEnumeratorFuture::setBatchMode(bool enable)
+{
+    enumerator->d->asyncBatchMode = enable;
+}
+
+void DEnumeratorFuture::setMaxPendingBatches(int count)
+{
+    enumerator->d->maxPendingBatches = qMax(0, count);
+}
+
 bool DEnumeratorFuture::isFinished()
 {
     return enumerator->isAsyncOver();
@@ -50,3 +80,13 @@ void DEnumeratorFuture::onAsyncIteratorOver()
 {
     Q_EMIT asyncIteratorOver();
 }
+
+void DEnumeratorFuture::onAsyncBatchReady(const QList<QSharedPointer<DFileInfo>> &infos)
+{
+    Q_EMIT batchReady(infos);
+}
+
+void DEnumeratorFuture::batchConsumed()
+{
+    enumerator->d->asyncBatchConsumed();
+}
@@ -84,8 +84,8 @@ DFile::Permissions DFilePrivate::permissionsFromGFileInfo(GFileInfo *gfileinfo)
     if (!gfileinfo)
         return retValue;
 
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
-    const quint32 &stMode = g_file_info_get_attribute_uint32(gfileinfo, attributeKey.c_str());
+    const char *attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
+    const quint32 &stMode = g_file_info_get_attribute_uint32(gfileinfo, attributeKey);
     if (!stMode)
         return retValue;
 
@@ -525,8 +525,8 @@ void DFilePrivate::existsAsyncCallback(GObject *sourceObject, GAsyncResult *res,
         return;
     }
 
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kStandardType);
-    const quint32 exists = g_file_info_get_attribute_uint32(gfileinfo, attributeKey.c_str());
+    const char *attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kStandardType);
+    const quint32 exists = g_file_info_get_attribute_uint32(gfileinfo, attributeKey);
 
     future->infoExists(exists != G_FILE_TYPE_UNKNOWN);
     future->finished();
@@ -557,8 +557,8 @@ void DFilePrivate::sizeAsyncCallback(GObject *sourceObject, GAsyncResult *res, g
         return;
     }
 
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kStandardSize);
-    const quint64 size = g_file_info_get_attribute_uint64(gfileinfo, attributeKey.c_str());
+    const char *attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kStandardSize);
+    const quint64 size = g_file_info_get_attribute_uint64(gfileinfo, attributeKey);
 
     future->infoSize(size);
     future->finished();
@@ -727,10 +727,10 @@ DFile::Permissions DFile::permissions() const
 
     g_autoptr(GError) gerror = nullptr;
     d->checkAndResetCancel();
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
-    if (attributeKey.empty())
+    const char *attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
+    if (!*attributeKey)
         return retValue;
-    g_autoptr(GFileInfo) fileInfo = g_file_query_info(gfile, attributeKey.c_str(), G_FILE_QUERY_INFO_NONE, d->cancellable, &gerror);
+    g_autoptr(GFileInfo) fileInfo = g_file_query_info(gfile, attributeKey, G_FILE_QUERY_INFO_NONE, d->cancellable, &gerror);
 
     if (gerror)
         d->setErrorFromGError(gerror);
@@ -841,8 +841,8 @@ bool DFile::setPermissions(Permissions permission)
     g_autoptr(GFile) gfile = g_file_new_for_uri(d->uri.toString().toStdString().c_str());
     g_autoptr(GError) gerror = nullptr;
     d->checkAndResetCancel();
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
-    bool succ = g_file_set_attribute_uint32(gfile, attributeKey.c_str(), stMode, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, d->cancellable, &gerror);
+    const char *attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
+    bool succ = g_file_set_attribute_uint32(gfile, attributeKey, stMode, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, d->cancellable, &gerror);
     if (gerror)
         d->setErrorFromGError(gerror);
     return succ;
@@ -1185,8 +1185,8 @@ DFileFuture *DFile::sizeAsync(int ioPriority, QObject *parent)
 
     g_autoptr(GFile) gfile = g_file_new_for_uri(d->uri.toString().toStdString().c_str());
     d->checkAndResetCancel();
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kStandardSize);
-    g_file_query_info_async(gfile, attributeKey.c_str(), G_FILE_QUERY_INFO_NONE, ioPriority, d->cancellable, DFilePrivate::sizeAsyncCallback, data);
+    const char *attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kStandardSize);
+    g_file_query_info_async(gfile, attributeKey, G_FILE_QUERY_INFO_NONE, ioPriority, d->cancellable, DFilePrivate::sizeAsyncCallback, data);
 
     return future;
 }
@@ -1201,8 +1201,8 @@ DFileFuture *DFile::existsAsync(int ioPriority, QObject *parent)
 
     g_autoptr(GFile) gfile = g_file_new_for_uri(d->uri.toString().toStdString().c_str());
     d->checkAndResetCancel();
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kStandardType);
-    g_file_query_info_async(gfile, attributeKey.c_str(), G_FILE_QUERY_INFO_NONE, ioPriority, d->cancellable, d->existsAsyncCallback, data);
+    const char *attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kStandardType);
+    g_file_query_info_async(gfile, attributeKey, G_FILE_QUERY_INFO_NONE, ioPriority, d->cancellable, d->existsAsyncCallback, data);
 
     return future;
 }
@@ -1217,8 +1217,8 @@ DFileFuture *DFile::permissionsAsync(int ioPriority, QObject *parent)
 
     g_autoptr(GFile) gfile = g_file_new_for_uri(d->uri.toString().toStdString().c_str());
     d->checkAndResetCancel();
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
-    g_file_query_info_async(gfile, attributeKey.c_str(), G_FILE_QUERY_INFO_NONE, ioPriority, d->cancellable, d->permissionsAsyncCallback, data);
+    const char *attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
+    g_file_query_info_async(gfile, attributeKey, G_FILE_QUERY_INFO_NONE, ioPriority, d->cancellable, d->permissionsAsyncCallback, data);
 
     return future;
 }
@@ -1233,11 +1233,11 @@ DFileFuture *DFile::setPermissionsAsync(Permissions permission, int ioPriority,
     g_autoptr(GFile) gfile = g_file_new_for_uri(d->uri.toString().toStdString().c_str());
     d->checkAndResetCancel();
     g_autoptr(GError) gerror = nullptr;
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
+    const char *attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
 
     QPointer<DFilePrivate> me = d.data();
     QtConcurrent::run([&]() {
-        g_file_set_attribute_uint32(gfile, attributeKey.c_str(), stMode, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, d->cancellable, &gerror);
+        g_file_set_attribute_uint32(gfile, attributeKey, stMode, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, d->cancellable, &gerror);
         if (!me)
             return;
         if (gerror)
@@ -6,20 +6,78 @@
 
 #include "utils/dmediainfo.h"
 #include "utils/dlocalhelper.h"
+#include "utils/dbatchquerier.h"
+#include "utils/dxattrbatch.h"
+#include "utils/dfixedpool.h"
+#include "utils/dfilesystemcache.h"
+#include "utils/dqueryflight.h"
+#include "utils/downernames.h"
+#include "utils/dcontenttypecache.h"
 
 #include <dfm-io/dfilefuture.h>
 
 #include <QVariant>
-#include <QPointer>
 #include <QTimer>
 #include <QDebug>
 #include <QThread>
 
 #include <sys/stat.h>
+#include <sys/sysmacros.h>
 #include <fcntl.h>
 
 USING_IO_NAMESPACE
 
+namespace {
+const struct statx_timestamp &selfStatTime(const struct statx &stx, DFileInfo::AttributeID id)
+{
+    switch (id) {
+    case DFileInfo::AttributeID::kTimeCreated:
+    case DFileInfo::AttributeID::kTimeCreatedUsec:
+        return stx.stx_btime;
+    case DFileInfo::AttributeID::kTimeModified:
+    case DFileInfo::AttributeID::kTimeModifiedUsec:
+        return stx.stx_mtime;
+    default:
+        return stx.stx_atime;
+    }
+}
+
+int defaultOf(DFileInfo::AttributeID id)
+{
+    const DLocalHelper::AttributeInfo *info = DLocalHelper::attributeInfo(id);
+    return info ? info->defaultValue : 0;
+}
+
+DFixedPool *privatePool()
+{
+    // left alive on exit, infos held by other statics may still be freed then
+    static DFixedPool *pool = new DFixedPool(sizeof(DFileInfoPrivate), 256);
+    return pool;
+}
+
+// the first one made is kept, a later one is dropped
+GFileInfo *installInfo(QAtomicPointer<GFileInfo> &slot, GFileInfo *created)
+{
+    if (created && slot.testAndSetOrdered(nullptr, created))
+        return created;
+    if (created)
+        g_object_unref(created);
+    return slot.loadAcquire();
+}
+
+void releaseInfo(QAtomicPointer<GFileInfo> &slot)
+{
+    if (GFileInfo *info = slot.fetchAndStoreOrdered(nullptr))
+        g_object_unref(info);
+}
+
+// one of FILE_DEFERRED_ATTRIBUTES
+bool isDeferredKey(const char *key)
+{
+    return g_str_has_prefix(key, "thumbnail::") || g_str_has_prefix(key, "selinux::") || g_str_has_prefix(key, "metadata::");
+}
+}   // namespace
+
 /************************************************
  * DFileInfoPrivate
  ***********************************************/
@@ -29,7 +87,7 @@ typedef struct
     DFileInfo::AttributeAsyncCallback callback;
     gpointer user_data;
     DFileInfo::AttributeID id;
-    QPointer<DFileInfoPrivate> me;
+    DFileInfoPrivate::Token me;
 } QueryFileInfoFromAttributeOp;
 
 static void queryFileInfoFromAttributeCallback(bool ok, void *userData)
@@ -39,9 +97,10 @@ static void queryFileInfoFromAttributeCallback(bool ok, void *userData)
         return;
 
     if (dataOp->callback) {
-        if (ok) {
+        DFileInfoPrivate *me = DFileInfoPrivate::alive(dataOp->me);
+        if (ok && me) {
             bool success = false;
-            const QVariant &value = dataOp->me->q->attribute(dataOp->id, &success);
+            const QVariant &value = me->q->attribute(dataOp->id, &success);
             dataOp->callback(success, dataOp->user_data, value);
         } else {
             dataOp->callback(false, dataOp->user_data, QVariant());
@@ -50,32 +109,13 @@ static void queryFileInfoFromAttributeCallback(bool ok, void *userData)
 
     dataOp->callback = nullptr;
     dataOp->user_data = nullptr;
-    dataOp->me = nullptr;
+    dataOp->me.reset();
     g_free(dataOp);
 }
 
 DFileInfoPrivate::DFileInfoPrivate(DFileInfo *qq)
     : q(qq)
 {
-    attributesRealizationSelf.push_back(DFileInfo::AttributeID::kStandardIsHidden);
-    attributesRealizationSelf.push_back(DFileInfo::AttributeID::kTimeCreated);
-    attributesRealizationSelf.push_back(DFileInfo::AttributeID::kTimeCreatedUsec);
-    attributesRealizationSelf.push_back(DFileInfo::AttributeID::kTimeModified);
-    attributesRealizationSelf.push_back(DFileInfo::AttributeID::kTimeModifiedUsec);
-    attributesRealizationSelf.push_back(DFileInfo::AttributeID::kTimeAccess);
-    attributesRealizationSelf.push_back(DFileInfo::AttributeID::kTimeAccessUsec);
-
-    attributesNoBlockIO.push_back(DFileInfo::AttributeID::kStandardName);
-    attributesNoBlockIO.push_back(DFileInfo::AttributeID::kStandardDisplayName);
-    attributesNoBlockIO.push_back(DFileInfo::AttributeID::kStandardEditName);
-    attributesNoBlockIO.push_back(DFileInfo::AttributeID::kStandardCopyName);
-    attributesNoBlockIO.push_back(DFileInfo::AttributeID::kStandardSuffix);
-    attributesNoBlockIO.push_back(DFileInfo::AttributeID::kStandardCompleteSuffix);
-    attributesNoBlockIO.push_back(DFileInfo::AttributeID::kStandardFilePath);
-    attributesNoBlockIO.push_back(DFileInfo::AttributeID::kStandardParentPath);
-    attributesNoBlockIO.push_back(DFileInfo::AttributeID::kStandardBaseName);
-    attributesNoBlockIO.push_back(DFileInfo::AttributeID::kStandardFileName);
-    attributesNoBlockIO.push_back(DFileInfo::AttributeID::kStandardCompleteBaseName);
 }
 
 DFileInfoPrivate::DFileInfoPrivate(const DFileInfoPrivate &other)
@@ -91,14 +131,21 @@ DFileInfoPrivate &DFileInfoPrivate::operator=(const DFileInfoPrivate &other)
 
 DFileInfoPrivate::~DFileInfoPrivate()
 {
+    if (selfToken)
+        *selfToken = nullptr;
+    // a media read calls back into the members, it has to be over before they go
+    mediaInfo.reset();
+
     if (gfileinfo) {
         g_object_unref(gfileinfo);
         gfileinfo = nullptr;
     }
-    if (gfile) {
-        g_object_unref(gfile);
-        gfile = nullptr;
-    }
+    releaseInfo(fileSystem);
+    releaseInfo(contentType);
+    releaseInfo(deferred);
+    delete selfStatData.fetchAndStoreOrdered(nullptr);
+    if (GFile *file = gfile.fetchAndStoreOrdered(nullptr))
+        g_object_unref(file);
 
     if (gcancellable) {
         g_object_unref(gcancellable);
@@ -106,15 +153,132 @@ DFileInfoPrivate::~DFileInfoPrivate()
     }
 }
 
-void DFileInfoPrivate::initNormal()
+void *DFileInfoPrivate::operator new(size_t size)
 {
-    if (this->gfile)
+    if (size > privatePool()->blockSize())
+        return ::operator new(size);
+    return privatePool()->allocate();
+}
+
+void DFileInfoPrivate::operator delete(void *block, size_t size)
+{
+    if (size > privatePool()->blockSize()) {
+        ::operator delete(block);
         return;
+    }
+    privatePool()->deallocate(block);
+}
 
-    const QUrl &url = q->uri();
-    const QString &urlStr = url.toString();
+DFileInfoPrivate::Token DFileInfoPrivate::token()
+{
+    if (!selfToken)
+        selfToken.reset(new DFileInfoPrivate *(this));
+    return selfToken;
+}
+
+DFileInfoPrivate *DFileInfoPrivate::alive(const Token &token)
+{
+    return token ? *token : nullptr;
+}
+
+GFile *DFileInfoPrivate::file()
+{
+    GFile *file = gfile.loadAcquire();
+    if (file)
+        return file;
+
+    // most infos of a listing never need one, so it is not made up front
+    GFile *created = g_file_new_for_uri(uri.toString().toLocal8Bit().constData());
+    if (gfile.testAndSetOrdered(nullptr, created))
+        return created;
+    g_object_unref(created);
+    return gfile.loadAcquire();
+}
 
-    this->gfile = g_file_new_for_uri(urlStr.toLocal8Bit().data());
+bool DFileInfoPrivate::isRealizedBySelf(DFileInfo::AttributeID id)
+{
+    switch (id) {
+    case DFileInfo::AttributeID::kStandardIsHidden:
+    case DFileInfo::AttributeID::kTimeCreated:
+    case DFileInfo::AttributeID::kTimeCreatedUsec:
+    case DFileInfo::AttributeID::kTimeModified:
+    case DFileInfo::AttributeID::kTimeModifiedUsec:
+    case DFileInfo::AttributeID::kTimeAccess:
+    case DFileInfo::AttributeID::kTimeAccessUsec:
+        return true;
+    default:
+        return isFileSystemAttribute(id) || isOwnerAttribute(id) || isContentTypeAttribute(id);
+    }
+}
+
+bool DFileInfoPrivate::isSelfTime(DFileInfo::AttributeID id)
+{
+    switch (id) {
+    case DFileInfo::AttributeID::kTimeCreated:
+    case DFileInfo::AttributeID::kTimeCreatedUsec:
+    case DFileInfo::AttributeID::kTimeModified:
+    case DFileInfo::AttributeID::kTimeModifiedUsec:
+    case DFileInfo::AttributeID::kTimeAccess:
+    case DFileInfo::AttributeID::kTimeAccessUsec:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool DFileInfoPrivate::isContentTypeAttribute(DFileInfo::AttributeID id)
+{
+    switch (id) {
+    case DFileInfo::AttributeID::kStandardContentType:
+    case DFileInfo::AttributeID::kStandardIcon:
+    case DFileInfo::AttributeID::kStandardSymbolicIcon:
+    case DFileInfo::AttributeID::kStandardDescription:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool DFileInfoPrivate::isOwnerAttribute(DFileInfo::AttributeID id)
+{
+    return id == DFileInfo::AttributeID::kOwnerUser || id == DFileInfo::AttributeID::kOwnerUserReal
+            || id == DFileInfo::AttributeID::kOwnerGroup;
+}
+
+bool DFileInfoPrivate::isFileSystemAttribute(DFileInfo::AttributeID id)
+{
+    switch (id) {
+    case DFileInfo::AttributeID::kFileSystemSize:
+    case DFileInfo::AttributeID::kFileSystemFree:
+    case DFileInfo::AttributeID::kFileSystemUsed:
+    case DFileInfo::AttributeID::kFileSystemType:
+    case DFileInfo::AttributeID::kFileSystemReadOnly:
+    case DFileInfo::AttributeID::kFileSystemUsePreview:
+    case DFileInfo::AttributeID::kFileSystemRemote:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool DFileInfoPrivate::isNoBlockIO(DFileInfo::AttributeID id)
+{
+    switch (id) {
+    case DFileInfo::AttributeID::kStandardName:
+    case DFileInfo::AttributeID::kStandardDisplayName:
+    case DFileInfo::AttributeID::kStandardEditName:
+    case DFileInfo::AttributeID::kStandardCopyName:
+    case DFileInfo::AttributeID::kStandardSuffix:
+    case DFileInfo::AttributeID::kStandardCompleteSuffix:
+    case DFileInfo::AttributeID::kStandardFilePath:
+    case DFileInfo::AttributeID::kStandardParentPath:
+    case DFileInfo::AttributeID::kStandardBaseName:
+    case DFileInfo::AttributeID::kStandardFileName:
+    case DFileInfo::AttributeID::kStandardCompleteBaseName:
+        return true;
+    default:
+        return false;
+    }
 }
 
 void DFileInfoPrivate::attributeExtend(DFileInfo::MediaType type, QList<DFileInfo::AttributeExtendID> ids, DFileInfo::AttributeExtendFuncCallback callback)
@@ -125,12 +289,28 @@ void DFileInfoPrivate::attributeExtend(DFileInfo::MediaType type, QList<DFileInf
 
         const QString &filePath = q->attribute(DFileInfo::AttributeID::kStandardFilePath, nullptr).toString();
         if (!filePath.isEmpty()) {
+            DMediaCache::Key key;
+            DMediaCache::Values values;
+            const bool keyValid = uri.isLocalFile() && DMediaCache::keyOf(filePath, &key);
+            if (keyValid && DMediaCache::instance()->find(key, type, &values)) {
+                // answered from the event loop like a parsed file, never from inside this call
+                if (callback) {
+                    const Token me = token();
+                    const QMap<DFileInfo::AttributeExtendID, QVariant> &map = mediaMap(ids, values);
+                    QTimer::singleShot(0, [me, callback, map]() {
+                        if (alive(me))
+                            callback(true, map);
+                    });
+                }
+                return;
+            }
+
             mediaType = type;
             extendIDs = ids;
             attributeExtendFuncCallback = callback;
 
             this->mediaInfo.reset(new DMediaInfo(filePath));
-            this->mediaInfo->startReadInfo(std::bind(&DFileInfoPrivate::attributeExtendCallback, this));
+            this->mediaInfo->startReadInfo([this, key, keyValid]() { attributeExtendCallback(keyValid ? &key : nullptr); });
         } else {
             if (callback)
                 callback(false, {});
@@ -140,8 +320,6 @@ void DFileInfoPrivate::attributeExtend(DFileInfo::MediaType type, QList<DFileInf
 
 DFileFuture *DFileInfoPrivate::attributeExtend(DFileInfo::MediaType type, QList<DFileInfo::AttributeExtendID> ids, int ioPriority, QObject *parent)
 {
-    Q_UNUSED(ioPriority);
-
     if (ids.contains(DFileInfo::AttributeExtendID::kExtendMediaDuration)
         || ids.contains(DFileInfo::AttributeExtendID::kExtendMediaWidth)
         || ids.contains(DFileInfo::AttributeExtendID::kExtendMediaHeight)) {
@@ -150,12 +328,25 @@ DFileFuture *DFileInfoPrivate::attributeExtend(DFileInfo::MediaType type, QList<
 
         const QString &filePath = q->attribute(DFileInfo::AttributeID::kStandardFilePath, nullptr).toString();
         if (!filePath.isEmpty()) {
+            DMediaCache::Key key;
+            DMediaCache::Values values;
+            const bool keyValid = uri.isLocalFile() && DMediaCache::keyOf(filePath, &key);
+            if (keyValid && DMediaCache::instance()->find(key, type, &values)) {
+                // the caller connects to the future once it is returned
+                const QUrl url = uri;
+                const QMap<DFileInfo::AttributeExtendID, QVariant> &map = mediaMap(ids, values);
+                QTimer::singleShot(0, future, [future, url, map]() {
+                    future->infoMedia(url, map);
+                });
+                return future;
+            }
+
             mediaType = type;
             extendIDs = ids;
             this->future = future;
 
             this->mediaInfo.reset(new DMediaInfo(filePath));
-            this->mediaInfo->startReadInfo(std::bind(&DFileInfoPrivate::attributeExtendCallback, this));
+            this->mediaInfo->startReadInfo([this, key, keyValid]() { attributeExtendCallback(keyValid ? &key : nullptr); }, ioPriority);
 
             return future;
         } else {
@@ -181,27 +372,35 @@ bool DFileInfoPrivate::cancelAttributes()
     return cancelAttributeExtend();
 }
 
-void DFileInfoPrivate::attributeExtendCallback()
+QMap<DFileInfo::AttributeExtendID, QVariant> DFileInfoPrivate::mediaMap(const QList<DFileInfo::AttributeExtendID> &ids, const DMediaCache::Values &values)
 {
-    if (this->mediaInfo) {
-        QMap<DFileInfo::AttributeExtendID, QVariant> map;
+    QMap<DFileInfo::AttributeExtendID, QVariant> map;
+    if (ids.contains(DFileInfo::AttributeExtendID::kExtendMediaDuration))
+        map.insert(DFileInfo::AttributeExtendID::kExtendMediaDuration, values.duration);
+    if (ids.contains(DFileInfo::AttributeExtendID::kExtendMediaWidth))
+        map.insert(DFileInfo::AttributeExtendID::kExtendMediaWidth, values.width);
+    if (ids.contains(DFileInfo::AttributeExtendID::kExtendMediaHeight))
+        map.insert(DFileInfo::AttributeExtendID::kExtendMediaHeight, values.height);
+    return map;
+}
 
-        if (extendIDs.contains(DFileInfo::AttributeExtendID::kExtendMediaDuration)) {
-            QString duration = mediaInfo->value("Duration", mediaType);
-            if (duration.isEmpty()) {
-                duration = mediaInfo->value("Duration", DFileInfo::MediaType::kGeneral);
-            }
-            map.insert(DFileInfo::AttributeExtendID::kExtendMediaDuration, duration);
-        }
-        if (extendIDs.contains(DFileInfo::AttributeExtendID::kExtendMediaWidth)) {
-            const QString &width = mediaInfo->value("Width", mediaType);
-            map.insert(DFileInfo::AttributeExtendID::kExtendMediaWidth, width);
-        }
-        if (extendIDs.contains(DFileInfo::AttributeExtendID::kExtendMediaHeight)) {
-            const QString &height = mediaInfo->value("Height", mediaType);
-            map.insert(DFileInfo::AttributeExtendID::kExtendMediaHeight, height);
+void DFileInfoPrivate::attributeExtendCallback(const DMediaCache::Key *key)
+{
+    if (this->mediaInfo) {
+        // all three are kept, a later request may ask for the others
+        DMediaCache::Values values;
+        values.duration = mediaInfo->value("Duration", mediaType);
+        if (values.duration.isEmpty()) {
+            values.duration = mediaInfo->value("Duration", DFileInfo::MediaType::kGeneral);
         }
-
+        values.width = mediaInfo->value("Width", mediaType);
+        values.height = mediaInfo->value("Height", mediaType);
+        // nothing parsed may be a file still being written or a read that failed
+        const bool parsed = !values.duration.isEmpty() || !values.width.isEmpty() || !values.height.isEmpty();
+        if (key && parsed)
+            DMediaCache::instance()->insert(*key, mediaType, values);
+
+        const QMap<DFileInfo::AttributeExtendID, QVariant> &map = mediaMap(extendIDs, values);
         if (attributeExtendFuncCallback)
             attributeExtendFuncCallback(true, map);
 
@@ -234,7 +433,7 @@ bool DFileInfoPrivate::queryInfoSync()
 
     g_autoptr(GError) gerror = nullptr;
     checkAndResetCancel();
-    GFileInfo *fileinfo = g_file_query_info(gfile, attributes, GFileQueryInfoFlags(flag), gcancellable, &gerror);
+    GFileInfo *fileinfo = g_file_query_info(file(), attributes, GFileQueryInfoFlags(flag), gcancellable, &gerror);
     if (gerror)
         setErrorFromGError(gerror);
 
@@ -248,6 +447,7 @@ bool DFileInfoPrivate::queryInfoSync()
         this->gfileinfo = nullptr;
     }
     this->gfileinfo = fileinfo;
+    resetSelfStat();
     initFinished = true;
     isQuquerying = false;
     return true;
@@ -269,9 +469,9 @@ void DFileInfoPrivate::queryInfoAsync(int ioPriority, DFileInfo::InitQuerierAsyn
     QueryInfoAsyncOp *dataOp = g_new0(QueryInfoAsyncOp, 1);
     dataOp->callback = func;
     dataOp->userData = userData;
-    dataOp->me = this;
+    dataOp->me = token();
     checkAndResetCancel();
-    g_file_query_info_async(this->gfile, attributes, GFileQueryInfoFlags(flag), ioPriority, gcancellable, queryInfoAsyncCallback, dataOp);
+    DQueryFlight::instance()->queryInfo(file(), attributes, GFileQueryInfoFlags(flag), ioPriority, gcancellable, queryInfoAsyncCallback, dataOp);
 }
 
 QVariant DFileInfoPrivate::attributesBySelf(DFileInfo::AttributeID id)
@@ -282,123 +482,305 @@ QVariant DFileInfoPrivate::attributesBySelf(DFileInfo::AttributeID id)
         retValue = DLocalHelper::fileIsHidden(q, {});
         break;
     }
-    case DFileInfo::AttributeID::kTimeCreated: {
-        const std::string &key = DLocalHelper::attributeStringById(id);
-        if (key.empty())
-            return QVariant();
-        uint64_t ret = g_file_info_get_attribute_uint64(gfileinfo, key.c_str());
-        if (ret == 0) {
-            struct statx statxBuffer;
-            unsigned mask = STATX_BASIC_STATS | STATX_BTIME;
-            const QUrl &url = q->uri();
-            int ret = statx(AT_FDCWD, url.path().toStdString().data(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &statxBuffer);
-            if (ret == 0) {
-                return statxBuffer.stx_btime.tv_sec > 0
-                        ? quint64(statxBuffer.stx_btime.tv_sec)
-                        : quint64(statxBuffer.stx_ctime.tv_sec);
-            }
+    case DFileInfo::AttributeID::kTimeCreated:
+    case DFileInfo::AttributeID::kTimeModified:
+    case DFileInfo::AttributeID::kTimeAccess:
+        return qulonglong(selfTime(id));
+    case DFileInfo::AttributeID::kTimeCreatedUsec:
+    case DFileInfo::AttributeID::kTimeModifiedUsec:
+    case DFileInfo::AttributeID::kTimeAccessUsec:
+        return selfTimeMsec(id);
+    case DFileInfo::AttributeID::kFileSystemSize:
+    case DFileInfo::AttributeID::kFileSystemFree:
+    case DFileInfo::AttributeID::kFileSystemUsed:
+    case DFileInfo::AttributeID::kFileSystemType:
+    case DFileInfo::AttributeID::kFileSystemReadOnly:
+    case DFileInfo::AttributeID::kFileSystemUsePreview:
+    case DFileInfo::AttributeID::kFileSystemRemote: {
+        // queried explicitly the info has them, otherwise they come per device
+        GFileInfo *info = gfileinfo;
+        if (!g_file_info_has_attribute(info, DLocalHelper::attributeStringById(id)))
+            info = fileSystemInfo();
+        DFMIOErrorCode errorCode(DFM_IO_ERROR_NONE);
+        retValue = DLocalHelper::attributeFromGFileInfo(info, id, errorCode);
+        if (errorCode != DFM_IO_ERROR_NONE)
+            error.setCode(errorCode);
+        break;
+    }
+    case DFileInfo::AttributeID::kOwnerUser:
+    case DFileInfo::AttributeID::kOwnerUserReal:
+    case DFileInfo::AttributeID::kOwnerGroup: {
+        const QString &name = ownerName(id);
+        if (!name.isEmpty())
+            retValue = name;
+        break;
+    }
+    case DFileInfo::AttributeID::kStandardContentType:
+    case DFileInfo::AttributeID::kStandardIcon:
+    case DFileInfo::AttributeID::kStandardSymbolicIcon:
+    case DFileInfo::AttributeID::kStandardDescription: {
+        GFileInfo *info = contentTypeInfo();
+        if (!info)
+            break;
+        DFMIOErrorCode errorCode(DFM_IO_ERROR_NONE);
+        retValue = DLocalHelper::attributeFromGFileInfo(info, id, errorCode);
+        if (errorCode != DFM_IO_ERROR_NONE)
+            error.setCode(errorCode);
+        break;
+    }
+    default:
+        return retValue;
+    }
+    return retValue;
+}
+
+quint64 DFileInfoPrivate::selfTime(DFileInfo::AttributeID id)
+{
+    const quint64 ret = g_file_info_get_attribute_uint64(gfileinfo, DLocalHelper::attributeStringById(id));
+    if (ret == 0) {
+        if (const struct statx *stx = selfStat()) {
+            const struct statx_timestamp &time = selfStatTime(*stx, id);
+            return time.tv_sec > 0 ? quint64(time.tv_sec) : quint64(stx->stx_ctime.tv_sec);
         }
-        return qulonglong(ret);
     }
-    case DFileInfo::AttributeID::kTimeCreatedUsec: {
-        const std::string &key = DLocalHelper::attributeStringById(id);
-        if (key.empty())
-            return QVariant();
-        uint32_t ret = g_file_info_get_attribute_uint32(gfileinfo, key.c_str());
-        if (ret == 0) {
-            struct statx statxBuffer;
-            unsigned mask = STATX_BASIC_STATS | STATX_BTIME;
-            const QUrl &url = q->uri();
-            int ret = statx(AT_FDCWD, url.path().toStdString().data(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &statxBuffer);
-            if (ret == 0) {
-                return statxBuffer.stx_btime.tv_nsec > 0
-                        ? statxBuffer.stx_btime.tv_nsec / 1000000
-                        : statxBuffer.stx_ctime.tv_nsec / 1000000;
-            }
+    return ret;
+}
+
+quint32 DFileInfoPrivate::selfTimeMsec(DFileInfo::AttributeID id)
+{
+    const quint32 ret = g_file_info_get_attribute_uint32(gfileinfo, DLocalHelper::attributeStringById(id));
+    if (ret == 0) {
+        if (const struct statx *stx = selfStat()) {
+            const struct statx_timestamp &time = selfStatTime(*stx, id);
+            return quint32(time.tv_nsec > 0 ? time.tv_nsec / 1000000 : stx->stx_ctime.tv_nsec / 1000000);
         }
-        return QVariant(ret);
     }
-    case DFileInfo::AttributeID::kTimeModified: {
-        const std::string &key = DLocalHelper::attributeStringById(id);
-        if (key.empty())
-            return QVariant();
-        uint64_t ret = g_file_info_get_attribute_uint64(gfileinfo, key.c_str());
-        if (ret == 0) {
-            struct statx statxBuffer;
-            unsigned mask = STATX_BASIC_STATS | STATX_BTIME;
-            const QUrl &url = q->uri();
-            int ret = statx(AT_FDCWD, url.path().toStdString().data(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &statxBuffer);
-            if (ret == 0) {
-                return statxBuffer.stx_mtime.tv_sec > 0
-                        ? quint64(statxBuffer.stx_mtime.tv_sec)
-                        : quint64(statxBuffer.stx_ctime.tv_sec);
-            }
+    return ret;
+}
+
+GFileInfo *DFileInfoPrivate::typedSource(DFileInfo::AttributeID id, const char **key)
+{
+    // the same checks attribute() does, null means the default is used
+    if (!isAttributeRequested(id))
+        return nullptr;
+    if (!initFinished && !queryInfoSync())
+        return nullptr;
+    if (!gfileinfo)
+        return nullptr;
+
+    *key = DLocalHelper::attributeStringById(id);
+    if (isFileSystemAttribute(id) && !g_file_info_has_attribute(gfileinfo, *key)) {
+        GFileInfo *info = fileSystemInfo();
+        if (!info || !g_file_info_has_attribute(info, *key)) {
+            error.setCode(DFM_IO_ERROR_INFO_NO_ATTRIBUTE);
+            return nullptr;
         }
-        return qulonglong(ret);
+        return info;
     }
-    case DFileInfo::AttributeID::kTimeModifiedUsec: {
-        const std::string &key = DLocalHelper::attributeStringById(id);
-        if (key.empty())
-            return QVariant();
-        uint32_t ret = g_file_info_get_attribute_uint32(gfileinfo, key.c_str());
-        if (ret == 0) {
-            struct statx statxBuffer;
-            unsigned mask = STATX_BASIC_STATS | STATX_BTIME;
-            const QUrl &url = q->uri();
-            int ret = statx(AT_FDCWD, url.path().toStdString().data(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &statxBuffer);
-            if (ret == 0) {
-                return statxBuffer.stx_mtime.tv_nsec > 0
-                        ? statxBuffer.stx_mtime.tv_nsec / 1000000
-                        : statxBuffer.stx_ctime.tv_nsec / 1000000;
-            }
+    if (isContentTypeAttribute(id)) {
+        GFileInfo *info = contentTypeInfo();
+        if (!info || !g_file_info_has_attribute(info, *key)) {
+            error.setCode(DFM_IO_ERROR_INFO_NO_ATTRIBUTE);
+            return nullptr;
         }
-        return QVariant(ret);
+        return info;
     }
-    case DFileInfo::AttributeID::kTimeAccess: {
-        const std::string &key = DLocalHelper::attributeStringById(id);
-        if (key.empty())
-            return QVariant();
-        uint64_t ret = g_file_info_get_attribute_uint64(gfileinfo, key.c_str());
-        if (ret == 0) {
-            struct statx statxBuffer;
-            unsigned mask = STATX_BASIC_STATS | STATX_BTIME;
-            const QUrl &url = q->uri();
-            int ret = statx(AT_FDCWD, url.path().toStdString().data(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &statxBuffer);
-            if (ret == 0) {
-                return statxBuffer.stx_atime.tv_sec > 0
-                        ? quint64(statxBuffer.stx_atime.tv_sec)
-                        : quint64(statxBuffer.stx_ctime.tv_sec);
-            }
+    if (id > DFileInfo::AttributeID::kCustomStart || isRealizedBySelf(id))
+        return gfileinfo;
+    if (**key && !g_file_info_has_attribute(gfileinfo, *key)) {
+        GFileInfo *info = deferredInfo(*key);
+        if (info && g_file_info_has_attribute(info, *key))
+            return info;
+    }
+    if (!**key || !g_file_info_has_attribute(gfileinfo, *key)) {
+        error.setCode(DFM_IO_ERROR_INFO_NO_ATTRIBUTE);
+        return nullptr;
+    }
+    return gfileinfo;
+}
+
+const struct statx *DFileInfoPrivate::selfStat()
+{
+    // all the time attributes come from one statx, until the info is queried again.
+    // most infos of a listing never need it, so it is not carried up front
+    SelfStat *stat = selfStatData.loadAcquire();
+    if (!stat) {
+        SelfStat *created = new SelfStat;
+        const unsigned mask = STATX_BASIC_STATS | STATX_BTIME;
+        const QByteArray &path = q->uri().path().toLocal8Bit();
+        created->valid = statx(AT_FDCWD, path.constData(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &created->stx) == 0;
+        if (selfStatData.testAndSetOrdered(nullptr, created)) {
+            stat = created;
+        } else {
+            delete created;
+            stat = selfStatData.loadAcquire();
         }
-        return qulonglong(ret);
     }
-    case DFileInfo::AttributeID::kTimeAccessUsec: {
-        const std::string &key = DLocalHelper::attributeStringById(id);
-        if (key.empty())
-            return QVariant();
-        uint32_t ret = g_file_info_get_attribute_uint32(gfileinfo, key.c_str());
-        if (ret == 0) {
-            struct statx statxBuffer;
-            unsigned mask = STATX_BASIC_STATS | STATX_BTIME;
-            const QUrl &url = q->uri();
-            int ret = statx(AT_FDCWD, url.path().toStdString().data(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &statxBuffer);
-            if (ret == 0) {
-                return statxBuffer.stx_atime.tv_nsec > 0
-                        ? statxBuffer.stx_atime.tv_nsec / 1000000
-                        : statxBuffer.stx_ctime.tv_nsec / 1000000;
-            }
+    return stat && stat->valid ? &stat->stx : nullptr;
+}
+
+GFileInfo *DFileInfoPrivate::fileSystemInfo()
+{
+    if (GFileInfo *info = fileSystem.loadAcquire())
+        return info;
+
+    // which filesystem the file is on, without a statfs
+    QByteArray key;
+    if (gfileinfo && g_file_info_has_attribute(gfileinfo, G_FILE_ATTRIBUTE_ID_FILESYSTEM)) {
+        key = g_file_info_get_attribute_string(gfileinfo, G_FILE_ATTRIBUTE_ID_FILESYSTEM);
+    } else if (uri.isLocalFile()) {
+        if (const struct statx *stx = selfStat())
+            key = DFileSystemCache::localKey(makedev(stx->stx_dev_major, stx->stx_dev_minor));
+    }
+
+    return installInfo(fileSystem, DFileSystemCache::instance()->info(key, file()));
+}
+
+QString DFileInfoPrivate::ownerName(DFileInfo::AttributeID id)
+{
+    // queried explicitly the info has the name
+    const char *key = DLocalHelper::attributeStringById(id);
+    if (gfileinfo && g_file_info_has_attribute(gfileinfo, key))
+        return QString::fromUtf8(g_file_info_get_attribute_string(gfileinfo, key));
+
+    // the ids of a remote file mean nothing to the local user database
+    if (!uri.isLocalFile())
+        return QString();
+
+    const bool isGroup = id == DFileInfo::AttributeID::kOwnerGroup;
+    const char *idKey = isGroup ? G_FILE_ATTRIBUTE_UNIX_GID : G_FILE_ATTRIBUTE_UNIX_UID;
+    quint32 ownerId = 0;
+    if (gfileinfo && g_file_info_has_attribute(gfileinfo, idKey)) {
+        ownerId = g_file_info_get_attribute_uint32(gfileinfo, idKey);
+    } else {
+        const struct statx *stx = selfStat();
+        if (!stx)
+            return QString();
+        ownerId = isGroup ? stx->stx_gid : stx->stx_uid;
+    }
+
+    if (isGroup)
+        return DOwnerNames::instance()->groupName(ownerId);
+    if (id == DFileInfo::AttributeID::kOwnerUserReal)
+        return DOwnerNames::instance()->userRealName(ownerId);
+    return DOwnerNames::instance()->userName(ownerId);
+}
+
+GFileInfo *DFileInfoPrivate::contentTypeInfo()
+{
+    // queried explicitly the info has them
+    if (!gfileinfo)
+        return nullptr;
+    if (g_file_info_has_attribute(gfileinfo, G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE))
+        return gfileinfo;
+    if (GFileInfo *info = contentType.loadAcquire())
+        return info;
+
+    // only regular files are sniffed, the type of anything else is told without reading it
+    DContentTypeCache::Key key;
+    bool cacheable = false;
+    if (uri.isLocalFile()) {
+        const struct statx *stx = selfStat();
+        if (stx && S_ISREG(stx->stx_mode)) {
+            key.dev = makedev(stx->stx_dev_major, stx->stx_dev_minor);
+            key.ino = stx->stx_ino;
+            key.modifiedNs = static_cast<qint64>(stx->stx_mtime.tv_sec) * 1000000000 + stx->stx_mtime.tv_nsec;
+            key.size = static_cast<qint64>(stx->stx_size);
+            cacheable = true;
         }
-        return QVariant(ret);
     }
-    default:
-        return retValue;
+
+    QByteArray cached = cacheable ? DContentTypeCache::instance()->find(key) : QByteArray();
+    // sniffing a remote file is one more round trip per file, the guess of its backend is taken instead
+    if (cached.isEmpty() && !uri.isLocalFile() && g_file_info_has_attribute(gfileinfo, G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE))
+        cached = g_file_info_get_attribute_string(gfileinfo, G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE);
+
+    // kept aside, gfileinfo is shared with the threads reading it
+    GFileInfo *info = nullptr;
+    if (!cached.isEmpty()) {
+        // what the gio local backend derives from the type of a file
+        info = g_file_info_new();
+        g_file_info_set_content_type(info, cached.constData());
+        g_autoptr(GIcon) icon = g_content_type_get_icon(cached.constData());
+        if (icon)
+            g_file_info_set_icon(info, icon);
+        g_autoptr(GIcon) symbolicIcon = g_content_type_get_symbolic_icon(cached.constData());
+        if (symbolicIcon)
+            g_file_info_set_symbolic_icon(info, symbolicIcon);
+        g_autofree gchar *description = g_content_type_get_description(cached.constData());
+        if (description)
+            g_file_info_set_attribute_string(info, G_FILE_ATTRIBUTE_STANDARD_DESCRIPTION, description);
+    } else {
+        g_autoptr(GError) gerror = nullptr;
+        checkAndResetCancel();
+        info = g_file_query_info(file(), "standard::content-type,standard::icon,standard::symbolic-icon,standard::description",
+                                 GFileQueryInfoFlags(flag), gcancellable, &gerror);
+        if (!info) {
+            setErrorFromGError(gerror);
+            return nullptr;
+        }
+        const char *type = g_file_info_get_attribute_string(info, G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE);
+        if (!type) {
+            g_object_unref(info);
+            return nullptr;
+        }
+        if (cacheable)
+            DContentTypeCache::instance()->insert(key, type);
     }
-    return retValue;
+
+    return installInfo(contentType, info);
+}
+
+GFileInfo *DFileInfoPrivate::deferredInfo(const char *key)
+{
+    // asked for, gio has told already whether the file has them
+    if (!gfileinfo || !uri.isLocalFile() || !isDeferredKey(key))
+        return nullptr;
+    if (!attributes || strcmp(attributes, "*") == 0)
+        return nullptr;
+    if (!attributesMatcher)
+        attributesMatcher = DLocalHelper::attributeMatcher(attributes);
+    if (g_file_attribute_matcher_matches(attributesMatcher, key))
+        return nullptr;
+    if (GFileInfo *info = deferred.loadAcquire())
+        return info;
+
+    g_autoptr(GError) gerror = nullptr;
+    checkAndResetCancel();
+    GFileInfo *info = g_file_query_info(file(), FILE_DEFERRED_ATTRIBUTES, GFileQueryInfoFlags(flag), gcancellable, &gerror);
+    if (!info) {
+        setErrorFromGError(gerror);
+        return nullptr;
+    }
+    return installInfo(deferred, info);
+}
+
+void DFileInfoPrivate::resetSelfStat()
+{
+    delete selfStatData.fetchAndStoreOrdered(nullptr);
+    releaseInfo(fileSystem);
+    releaseInfo(contentType);
+    releaseInfo(deferred);
+}
+
+bool DFileInfoPrivate::isAttributeRequested(DFileInfo::AttributeID id)
+{
+    // a plain gio attribute that was not queried is just missing from gfileinfo,
+    // only the derived ones would go and fetch it some other way
+    if (id < DFileInfo::AttributeID::kCustomStart && !isRealizedBySelf(id))
+        return true;
+
+    if (!attributes || strcmp(attributes, "*") == 0)
+        return true;
+
+    if (!attributesMatcher)
+        attributesMatcher = DLocalHelper::attributeMatcher(attributes);
+    return DLocalHelper::attributeMatched(attributesMatcher, id);
 }
 
 QVariant DFileInfoPrivate::attributesFromUrl(DFileInfo::AttributeID id)
 {
-    if (!attributesNoBlockIO.contains(id))
+    if (!isNoBlockIO(id))
         return QVariant();
 
     QVariant retValue;
@@ -489,34 +871,28 @@ DFileFuture *DFileInfoPrivate::initQuerierAsync(int ioPriority, QObject *parent)
     DFileFuture *future = new DFileFuture(parent);
     QueryInfoAsyncOp2 *dataOp = g_new0(QueryInfoAsyncOp2, 1);
     dataOp->future = future;
-    dataOp->me = const_cast<DFileInfoPrivate *>(this);
+    dataOp->me = const_cast<DFileInfoPrivate *>(this)->token();
 
     const_cast<DFileInfoPrivate *>(this)->checkAndResetCancel();
-    g_file_query_info_async(this->gfile, attributes, GFileQueryInfoFlags(flag), ioPriority, gcancellable, queryInfoAsyncCallback2, dataOp);
+    DQueryFlight::instance()->queryInfo(const_cast<DFileInfoPrivate *>(this)->file(), attributes, GFileQueryInfoFlags(flag), ioPriority, gcancellable, queryInfoAsyncCallback2, dataOp);
     return future;
 }
 
 QFuture<void> DFileInfoPrivate::refreshAsync()
 {
+    if (!futureRefresh)
+        futureRefresh.reset(new QFuture<void>);
+
     if (refreshing)
-        return futureRefresh;
+        return *futureRefresh;
 
     refreshing = true;
 
-    if (futureRefresh.isRunning())
-        return futureRefresh;
+    if (futureRefresh->isRunning())
+        return *futureRefresh;
 
     stoped = false;
-    futureRefresh = QtConcurrent::run([=]() {
-        if (stoped) {
-            refreshing = false;
-            return;
-        }
-        if (gfile) {
-            g_object_unref(gfile);
-            gfile = nullptr;
-        }
-        initNormal();
+    *futureRefresh = QtConcurrent::run([=]() {
         if (stoped) {
             refreshing = false;
             return;
@@ -531,14 +907,14 @@ QFuture<void> DFileInfoPrivate::refreshAsync()
         fileExists = exists();
         refreshing = false;
     });
-    return futureRefresh;
+    return *futureRefresh;
 }
 
 void DFileInfoPrivate::cacheAttributes()
 {
     QMap<DFileInfo::AttributeID, QVariant> tmp;
-    for (const auto &[id, key] : DLocalHelper::attributeInfoMapFunc()) {
-        tmp.insert(id, q->attribute(id));
+    for (const DLocalHelper::AttributeInfo &info : DLocalHelper::attributeInfos()) {
+        tmp.insert(info.id, q->attribute(info.id));
     }
 
     tmp.insert(DFileInfo::AttributeID::kAccessPermissions, QVariant::fromValue(permissions()));
@@ -599,30 +975,31 @@ bool DFileInfoPrivate::exists() const
     return g_file_info_get_file_type(gfileinfo) != G_FILE_TYPE_UNKNOWN;
 }
 
-void DFileInfoPrivate::queryInfoAsyncCallback(GObject *sourceObject, GAsyncResult *res, gpointer userData)
+void DFileInfoPrivate::queryInfoAsyncCallback(GFileInfo *fileinfo, GError *gerror, gpointer userData)
 {
     QueryInfoAsyncOp *data = static_cast<QueryInfoAsyncOp *>(userData);
-    if (!data)
-        return;
-
-    GFile *file = G_FILE(sourceObject);
-    if (!file) {
-        freeQueryInfoAsyncOp(data);
+    if (!data) {
+        if (fileinfo)
+            g_object_unref(fileinfo);
         return;
     }
 
-    g_autoptr(GError) gerror = nullptr;
-    GFileInfo *fileinfo = g_file_query_info_finish(file, res, &gerror);
-
+    DFileInfoPrivate *me = alive(data->me);
     if (gerror) {
-        data->me->setErrorFromGError(gerror);
+        if (me)
+            me->setErrorFromGError(gerror);
         freeQueryInfoAsyncOp(data);
         return;
     }
 
-    if (data->me) {
-        data->me->gfileinfo = fileinfo;
-        data->me->initFinished = true;
+    if (me) {
+        if (me->gfileinfo)
+            g_object_unref(me->gfileinfo);
+        me->gfileinfo = fileinfo;
+        me->resetSelfStat();
+        me->initFinished = true;
+    } else if (fileinfo) {
+        g_object_unref(fileinfo);
     }
 
     if (data->callback)
@@ -631,38 +1008,36 @@ void DFileInfoPrivate::queryInfoAsyncCallback(GObject *sourceObject, GAsyncResul
     freeQueryInfoAsyncOp(data);
 }
 
-void DFileInfoPrivate::queryInfoAsyncCallback2(GObject *sourceObject, GAsyncResult *res, gpointer userData)
+void DFileInfoPrivate::queryInfoAsyncCallback2(GFileInfo *fileinfo, GError *gerror, gpointer userData)
 {
     QueryInfoAsyncOp2 *data = static_cast<QueryInfoAsyncOp2 *>(userData);
-    if (!data)
-        return;
-
-    DFileFuture *future = data->future;
-    if (!future) {
-        freeQueryInfoAsyncOp2(data);
-        return;
-    }
-
-    GFile *file = G_FILE(sourceObject);
-    if (!file) {
-        freeQueryInfoAsyncOp2(data);
+    if (!data || !data->future) {
+        if (fileinfo)
+            g_object_unref(fileinfo);
+        if (data)
+            freeQueryInfoAsyncOp2(data);
         return;
     }
 
-    g_autoptr(GError) gerror = nullptr;
-    GFileInfo *fileinfo = g_file_query_info_finish(file, res, &gerror);
-
+    DFileFuture *future = data->future;
+    DFileInfoPrivate *me = alive(data->me);
     if (gerror) {
-        data->me->setErrorFromGError(gerror);
+        if (me)
+            me->setErrorFromGError(gerror);
         freeQueryInfoAsyncOp2(data);
         return;
     }
 
-    if (data->me) {
-        data->me->gfileinfo = fileinfo;
-        data->me->initFinished = true;
+    if (me) {
+        if (me->gfileinfo)
+            g_object_unref(me->gfileinfo);
+        me->gfileinfo = fileinfo;
+        me->resetSelfStat();
+        me->initFinished = true;
 
         future->finished();
+    } else if (fileinfo) {
+        g_object_unref(fileinfo);
     }
 
     freeQueryInfoAsyncOp2(data);
@@ -672,13 +1047,13 @@ void DFileInfoPrivate::freeQueryInfoAsyncOp(DFileInfoPrivate::QueryInfoAsyncOp *
 {
     op->callback = nullptr;
     op->userData = nullptr;
-    op->me = nullptr;
+    op->me.reset();
     g_free(op);
 }
 
 void DFileInfoPrivate::freeQueryInfoAsyncOp2(DFileInfoPrivate::QueryInfoAsyncOp2 *op)
 {
-    op->me = nullptr;
+    op->me.reset();
     g_free(op);
 }
 
@@ -690,10 +1065,9 @@ DFileInfo::DFileInfo(const QUrl &uri, const char *attributes, const FileQueryInf
     : d(new DFileInfoPrivate(this))
 {
     d->uri = uri;
-    d->attributes = strdup(attributes);
+    // a listing passes the same string for every entry, one copy serves them all
+    d->attributes = g_intern_string(attributes);
     d->flag = flag;
-
-    d->initNormal();
 }
 
 DFileInfo::DFileInfo(const QUrl &uri, void *fileInfo, const char *attributes, const DFileInfo::FileQueryInfoFlags flag)
@@ -715,7 +1089,6 @@ DFileInfo &DFileInfo::operator=(const DFileInfo &info)
 
 DFileInfo::~DFileInfo()
 {
-    free(d->attributes);
 }
 
 bool DFileInfo::initQuerier()
@@ -725,10 +1098,17 @@ bool DFileInfo::initQuerier()
 
 QVariant DFileInfo::attribute(DFileInfo::AttributeID id, bool *success) const
 {
+    // not in the projection this info was queried with, report it as not loaded
+    if (!const_cast<DFileInfoPrivate *>(d.data())->isAttributeRequested(id)) {
+        if (success)
+            *success = false;
+        return DLocalHelper::attributeDefault(id);
+    }
+
     if (!d->initFinished) {
         bool succ = const_cast<DFileInfoPrivate *>(d.data())->queryInfoSync();
         if (!succ) {
-            if (!d->attributesNoBlockIO.contains(id))
+            if (!DFileInfoPrivate::isNoBlockIO(id))
                 return QVariant();
             else
                 return const_cast<DFileInfoPrivate *>(d.data())->attributesFromUrl(id);
@@ -742,8 +1122,15 @@ QVariant DFileInfo::attribute(DFileInfo::AttributeID id, bool *success) const
     } else {
         if (d->gfileinfo) {
             DFMIOErrorCode errorCode(DFM_IO_ERROR_NONE);
-            if (!d->attributesRealizationSelf.contains(id)) {
-                retValue = DLocalHelper::attributeFromGFileInfo(d->gfileinfo, id, errorCode);
+            if (!DFileInfoPrivate::isRealizedBySelf(id)) {
+                // thumbnails and the like are read apart from a listing, see FILE_DEFERRED_ATTRIBUTES
+                GFileInfo *info = d->gfileinfo;
+                const char *key = DLocalHelper::attributeStringById(id);
+                if (*key && !g_file_info_has_attribute(info, key)) {
+                    if (GFileInfo *deferred = const_cast<DFileInfoPrivate *>(d.data())->deferredInfo(key))
+                        info = deferred;
+                }
+                retValue = DLocalHelper::attributeFromGFileInfo(info, id, errorCode);
                 if (errorCode != DFM_IO_ERROR_NONE)
                     const_cast<DFileInfoPrivate *>(d.data())->error.setCode(errorCode);
             } else {
@@ -755,10 +1142,127 @@ QVariant DFileInfo::attribute(DFileInfo::AttributeID id, bool *success) const
         *success = retValue.isValid();
 
     if (!retValue.isValid())
-        retValue = std::get<1>(DLocalHelper::attributeInfoMapFunc().at(id));
+        retValue = DLocalHelper::attributeDefault(id);
     return retValue;
 }
 
+void DFileInfo::readAttribute(AttributeID id, bool *value, bool *success) const
+{
+    DFileInfoPrivate *dp = const_cast<DFileInfoPrivate *>(d.data());
+    const char *key = nullptr;
+    GFileInfo *info = dp->typedSource(id, &key);
+    if (success)
+        *success = info != nullptr;
+
+    if (!info) {
+        *value = defaultOf(id) != 0;
+        return;
+    }
+
+    switch (id) {
+    case AttributeID::kStandardIsHidden:
+        *value = DLocalHelper::fileIsHidden(this, {});
+        break;
+    case AttributeID::kStandardIsFile:
+        *value = g_file_info_get_file_type(info) == G_FILE_TYPE_REGULAR;
+        break;
+    case AttributeID::kStandardIsDir:
+        *value = g_file_info_get_file_type(info) == G_FILE_TYPE_DIRECTORY;
+        break;
+    case AttributeID::kStandardIsRoot:
+        *value = d->uri.path() == "/";
+        break;
+    default:
+        *value = g_file_info_get_attribute_boolean(info, key);
+        break;
+    }
+}
+
+void DFileInfo::readAttribute(AttributeID id, quint32 *value, bool *success) const
+{
+    DFileInfoPrivate *dp = const_cast<DFileInfoPrivate *>(d.data());
+    const char *key = nullptr;
+    GFileInfo *info = dp->typedSource(id, &key);
+    if (success)
+        *success = info != nullptr;
+
+    if (!info)
+        *value = quint32(defaultOf(id));
+    else if (DFileInfoPrivate::isSelfTime(id))
+        *value = dp->selfTimeMsec(id);
+    else
+        *value = g_file_info_get_attribute_uint32(info, key);
+}
+
+void DFileInfo::readAttribute(AttributeID id, qint32 *value, bool *success) const
+{
+    const char *key = nullptr;
+    GFileInfo *info = const_cast<DFileInfoPrivate *>(d.data())->typedSource(id, &key);
+    if (success)
+        *success = info != nullptr;
+    *value = info ? g_file_info_get_attribute_int32(info, key) : defaultOf(id);
+}
+
+void DFileInfo::readAttribute(AttributeID id, quint64 *value, bool *success) const
+{
+    DFileInfoPrivate *dp = const_cast<DFileInfoPrivate *>(d.data());
+    const char *key = nullptr;
+    GFileInfo *info = dp->typedSource(id, &key);
+    if (success)
+        *success = info != nullptr;
+
+    if (!info)
+        *value = quint64(defaultOf(id));
+    else if (DFileInfoPrivate::isSelfTime(id))
+        *value = dp->selfTime(id);
+    else
+        *value = g_file_info_get_attribute_uint64(info, key);
+}
+
+void DFileInfo::readAttribute(AttributeID id, qint64 *value, bool *success) const
+{
+    const char *key = nullptr;
+    GFileInfo *info = const_cast<DFileInfoPrivate *>(d.data())->typedSource(id, &key);
+    if (success)
+        *success = info != nullptr;
+    *value = info ? g_file_info_get_attribute_int64(info, key) : defaultOf(id);
+}
+
+void DFileInfo::readAttribute(AttributeID id, QString *value, bool *success) const
+{
+    DFileInfoPrivate *dp = const_cast<DFileInfoPrivate *>(d.data());
+    const char *key = nullptr;
+    GFileInfo *info = dp->typedSource(id, &key);
+    if (success)
+        *success = info != nullptr;
+
+    if (!info) {
+        // names can still be told from the url when the query failed
+        if (!d->initFinished && DFileInfoPrivate::isNoBlockIO(id))
+            *value = dp->attributesFromUrl(id).toString();
+        else
+            value->clear();
+        return;
+    }
+
+    if (id > AttributeID::kCustomStart) {
+        *value = DLocalHelper::customAttributeFromPathAndInfo(d->uri.path(), info, id).toString();
+        return;
+    }
+    if (DFileInfoPrivate::isOwnerAttribute(id)) {
+        *value = dp->ownerName(id);
+        if (success)
+            *success = !value->isEmpty();
+        return;
+    }
+
+    // byte strings are read as utf8 too, as attribute() does
+    const GFileAttributeType type = g_file_info_get_attribute_type(info, key);
+    const char *ret = type == G_FILE_ATTRIBUTE_TYPE_BYTE_STRING ? g_file_info_get_attribute_byte_string(info, key)
+                                                                : g_file_info_get_attribute_string(info, key);
+    *value = QString::fromUtf8(ret);
+}
+
 void DFileInfo::initQuerierAsync(int ioPriority, DFileInfo::InitQuerierAsyncCallback func, void *userData)
 {
     if (!d->infoReseted && d->gfileinfo) {
@@ -775,9 +1279,9 @@ void DFileInfo::initQuerierAsync(int ioPriority, DFileInfo::InitQuerierAsyncCall
     DFileInfoPrivate::QueryInfoAsyncOp *dataOp = g_new0(DFileInfoPrivate::QueryInfoAsyncOp, 1);
     dataOp->callback = func;
     dataOp->userData = userData;
-    dataOp->me = d.data();
+    dataOp->me = d->token();
 
-    g_file_query_info_async(d->gfile, attributes, GFileQueryInfoFlags(flag), ioPriority, nullptr, DFileInfoPrivate::queryInfoAsyncCallback, dataOp);
+    DQueryFlight::instance()->queryInfo(d->file(), attributes, GFileQueryInfoFlags(flag), ioPriority, nullptr, DFileInfoPrivate::queryInfoAsyncCallback, dataOp);
 }
 
 void DFileInfo::attributeAsync(DFileInfo::AttributeID id, bool *success, int ioPriority, DFileInfo::AttributeAsyncCallback func, void *userData)
@@ -788,7 +1292,7 @@ void DFileInfo::attributeAsync(DFileInfo::AttributeID id, bool *success, int ioP
         dataOp->callback = func;
         dataOp->user_data = userData;
         dataOp->id = id;
-        dataOp->me = d.data();
+        dataOp->me = d->token();
 
         d->queryInfoAsync(ioPriority, queryFileInfoFromAttributeCallback, dataOp);
         return;
@@ -807,10 +1311,10 @@ DFileFuture *DFileInfo::initQuerierAsync(int ioPriority, QObject *parent)
     DFileFuture *future = new DFileFuture(parent);
     DFileInfoPrivate::QueryInfoAsyncOp2 *dataOp = g_new0(DFileInfoPrivate::QueryInfoAsyncOp2, 1);
     dataOp->future = future;
-    dataOp->me = d.data();
+    dataOp->me = d->token();
 
     d->checkAndResetCancel();
-    g_file_query_info_async(d->gfile, attributes, GFileQueryInfoFlags(flag), ioPriority, d->gcancellable, DFileInfoPrivate::queryInfoAsyncCallback2, dataOp);
+    DQueryFlight::instance()->queryInfo(d->file(), attributes, GFileQueryInfoFlags(flag), ioPriority, d->gcancellable, DFileInfoPrivate::queryInfoAsyncCallback2, dataOp);
     return future;
 }
 
@@ -819,8 +1323,9 @@ DFileFuture *DFileInfo::attributeAsync(DFileInfo::AttributeID id, int ioPriority
     DFileFuture *futureRet = new DFileFuture(parent);
     if (!d->initFinished) {
         DFileFuture *future = d->initQuerierAsync(ioPriority, nullptr);
-        QObject::connect(future, &DFileFuture::finished, d.data(), [=]() {
-            if (!future->hasError()) {
+        const DFileInfoPrivate::Token me = const_cast<DFileInfoPrivate *>(d.data())->token();
+        QObject::connect(future, &DFileFuture::finished, future, [=]() {
+            if (!future->hasError() && DFileInfoPrivate::alive(me)) {
                 futureRet->infoAttribute(id, attribute(id));
                 futureRet->finished();
             }
@@ -839,8 +1344,9 @@ DFileFuture *DFileInfo::attributeAsync(const QByteArray &key, const DFileInfo::D
     DFileFuture *futureRet = new DFileFuture(parent);
     if (!d->initFinished) {
         DFileFuture *future = d->initQuerierAsync(ioPriority, nullptr);
-        QObject::connect(future, &DFileFuture::finished, d.data(), [=]() {
-            if (!future->hasError()) {
+        const DFileInfoPrivate::Token me = const_cast<DFileInfoPrivate *>(d.data())->token();
+        QObject::connect(future, &DFileFuture::finished, future, [=]() {
+            if (!future->hasError() && DFileInfoPrivate::alive(me)) {
                 futureRet->infoAttribute(key, customAttribute(key, type));
                 futureRet->finished();
             }
@@ -861,8 +1367,9 @@ DFileFuture *DFileInfo::existsAsync(int ioPriority, QObject *parent) const
     DFileFuture *futureRet = new DFileFuture(parent);
     if (!d->initFinished) {
         DFileFuture *future = d->initQuerierAsync(ioPriority, nullptr);
-        QObject::connect(future, &DFileFuture::finished, d.data(), [=]() {
-            if (!future->hasError()) {
+        const DFileInfoPrivate::Token me = const_cast<DFileInfoPrivate *>(d.data())->token();
+        QObject::connect(future, &DFileFuture::finished, future, [=]() {
+            if (!future->hasError() && DFileInfoPrivate::alive(me)) {
                 const bool exists = this->exists();
                 futureRet->infoExists(exists);
                 futureRet->finished();
@@ -881,7 +1388,10 @@ DFileFuture *DFileInfo::existsAsync(int ioPriority, QObject *parent) const
 DFileFuture *DFileInfo::refreshAsync(int ioPriority, QObject *parent)
 {
     DFileFuture *future = this->initQuerierAsync(ioPriority, parent);
-    QObject::connect(future, &DFileFuture::finished, d.data(), [=]() {
+    const DFileInfoPrivate::Token me = d->token();
+    QObject::connect(future, &DFileFuture::finished, future, [=]() {
+        if (!DFileInfoPrivate::alive(me))
+            return;
         future->finished();
     });
     return future;
@@ -890,7 +1400,10 @@ DFileFuture *DFileInfo::refreshAsync(int ioPriority, QObject *parent)
 DFileFuture *DFileInfo::permissionsAsync(int ioPriority, QObject *parent)
 {
     DFileFuture *future = this->initQuerierAsync(ioPriority, parent);
-    QObject::connect(future, &DFileFuture::finished, d.data(), [=]() {
+    const DFileInfoPrivate::Token me = d->token();
+    QObject::connect(future, &DFileFuture::finished, future, [=]() {
+        if (!DFileInfoPrivate::alive(me))
+            return;
         future->infoPermissions(this->permissions());
         future->finished();
     });
@@ -911,10 +1424,10 @@ bool DFileInfo::hasAttribute(DFileInfo::AttributeID id) const
     }
 
     if (d->gfileinfo) {
-        const std::string &key = DLocalHelper::attributeStringById(id);
-        if (key.empty())
+        const char *key = DLocalHelper::attributeStringById(id);
+        if (!*key)
             return false;
-        return g_file_info_has_attribute(d->gfileinfo, key.c_str());
+        return g_file_info_has_attribute(d->gfileinfo, key);
     }
 
     return false;
@@ -947,12 +1460,15 @@ DFile::Permissions DFileInfo::permissions() const
 
 bool DFileInfo::setCustomAttribute(const char *key, const DFileInfo::DFileAttributeType type, const void *value, const DFileInfo::FileQueryInfoFlags flag)
 {
-    if (d->gfile) {
+    if (GFile *file = d->file()) {
         g_autoptr(GError) gerror = nullptr;
-        bool ret = g_file_set_attribute(d->gfile, key, GFileAttributeType(type), (gpointer)(value), GFileQueryInfoFlags(flag), nullptr, &gerror);
+        bool ret = g_file_set_attribute(file, key, GFileAttributeType(type), (gpointer)(value), GFileQueryInfoFlags(flag), nullptr, &gerror);
 
         if (gerror)
             d->setErrorFromGError(gerror);
+        // read again on the next use
+        if (ret && isDeferredKey(key))
+            releaseInfo(d->deferred);
         return ret;
     }
     return false;
@@ -969,37 +1485,43 @@ QVariant DFileInfo::customAttribute(const char *key, const DFileInfo::DFileAttri
     if (!d->gfileinfo)
         return QVariant();
 
+    GFileInfo *info = d->gfileinfo;
+    if (key && !g_file_info_has_attribute(info, key)) {
+        if (GFileInfo *deferred = const_cast<DFileInfoPrivate *>(d.data())->deferredInfo(key))
+            info = deferred;
+    }
+
     switch (type) {
     case DFileInfo::DFileAttributeType::kTypeString: {
-        const char *ret = g_file_info_get_attribute_string(d->gfileinfo, key);
+        const char *ret = g_file_info_get_attribute_string(info, key);
         return QVariant(ret);
     }
     case DFileInfo::DFileAttributeType::kTypeByteString: {
-        const char *ret = g_file_info_get_attribute_byte_string(d->gfileinfo, key);
+        const char *ret = g_file_info_get_attribute_byte_string(info, key);
         return QVariant(ret);
     }
     case DFileInfo::DFileAttributeType::kTypeBool: {
-        bool ret = g_file_info_get_attribute_boolean(d->gfileinfo, key);
+        bool ret = g_file_info_get_attribute_boolean(info, key);
         return QVariant(ret);
     }
     case DFileInfo::DFileAttributeType::kTypeUInt32: {
-        uint32_t ret = g_file_info_get_attribute_uint32(d->gfileinfo, key);
+        uint32_t ret = g_file_info_get_attribute_uint32(info, key);
         return QVariant(ret);
     }
     case DFileInfo::DFileAttributeType::kTypeInt32: {
-        int32_t ret = g_file_info_get_attribute_int32(d->gfileinfo, key);
+        int32_t ret = g_file_info_get_attribute_int32(info, key);
         return QVariant(ret);
     }
     case DFileInfo::DFileAttributeType::kTypeUInt64: {
-        uint64_t ret = g_file_info_get_attribute_uint64(d->gfileinfo, key);
+        uint64_t ret = g_file_info_get_attribute_uint64(info, key);
         return QVariant(qulonglong(ret));
     }
     case DFileInfo::DFileAttributeType::kTypeInt64: {
-        int64_t ret = g_file_info_get_attribute_int64(d->gfileinfo, key);
+        int64_t ret = g_file_info_get_attribute_int64(info, key);
         return QVariant(qulonglong(ret));
     }
     case DFileInfo::DFileAttributeType::kTypeStringV: {
-        char **ret = g_file_info_get_attribute_stringv(d->gfileinfo, key);
+        char **ret = g_file_info_get_attribute_stringv(info, key);
         QStringList retValue;
         for (int i = 0; ret && ret[i]; ++i) {
             retValue.append(QString::fromLocal8Bit(ret[i]));
@@ -1047,7 +1569,7 @@ QUrl DFileInfo::uri() const
 
 char *DFileInfo::queryAttributes() const
 {
-    return d->attributes;
+    return const_cast<char *>(d->attributes);
 }
 
 DFileInfo::FileQueryInfoFlags DFileInfo::queryInfoFlag() const
@@ -1058,10 +1580,10 @@ DFileInfo::FileQueryInfoFlags DFileInfo::queryInfoFlag() const
 QString DFileInfo::dump() const
 {
     QString ret;
-    for (const auto &[id, key] : DLocalHelper::attributeInfoMapFunc()) {
-        const QVariant &&value = attribute(id);
+    for (const DLocalHelper::AttributeInfo &info : DLocalHelper::attributeInfos()) {
+        const QVariant &&value = attribute(info.id);
         if (value.isValid()) {
-            ret.append(std::get<0>(DLocalHelper::attributeInfoMapFunc().at(id)).c_str());
+            ret.append(info.key);
             ret.append(":");
             ret.append(value.toString());
             ret.append("\n");
@@ -1069,3 +1591,34 @@ QString DFileInfo::dump() const
     }
     return ret;
 }
+
+QList<QSharedPointer<DFileInfo>> DFileInfo::queryBatch(const QList<QUrl> &urls, const QList<AttributeID> &attributes,
+                                                       const FileQueryInfoFlags flag)
+{
+    QVector<QSharedPointer<DFileInfo>> infos(urls.size());
+    DBatchQuerier(urls, attributes, flag).run([&infos](int index, const QSharedPointer<DFileInfo> &info) {
+        infos[index] = info;
+    });
+    return infos.toList();
+}
+
+void DFileInfo::queryBatch(const QList<QUrl> &urls, const QList<AttributeID> &attributes,
+                           const FileQueryInfoFlags flag, QueryBatchCallback callback)
+{
+    if (!callback)
+        return;
+
+    DBatchQuerier(urls, attributes, flag).run([&urls, &callback](int index, const QSharedPointer<DFileInfo> &info) {
+        callback(urls.at(index), info);
+    });
+}
+
+QList<DFileInfo::ExtendedAttributes> DFileInfo::extendedAttributes(const QList<QUrl> &urls, const QList<QByteArray> &keys)
+{
+    return DXattrBatch(urls).read(keys);
+}
+
+QList<DFMIOError> DFileInfo::setExtendedAttributes(const QList<QUrl> &urls, const QMap<QByteArray, QByteArray> &values)
+{
+    return DXattrBatch(urls).write(values);
+}
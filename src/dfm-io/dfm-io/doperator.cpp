@@ -499,9 +499,9 @@ bool DOperator::setFileInfo(const DFileInfo &fileInfo)
     g_autoptr(GFile) gfile = d->makeGFile(uri);
 
     bool ret = true;
-    for (const auto &[key, value] : DLocalHelper::attributeInfoMapFunc()) {
+    for (const DLocalHelper::AttributeInfo &info : DLocalHelper::attributeInfos()) {
         g_autoptr(GError) gerror = nullptr;
-        bool succ = DLocalHelper::setAttributeByGFile(gfile, key, fileInfo.attribute(key, nullptr), &gerror);
+        bool succ = DLocalHelper::setAttributeByGFile(gfile, info.id, fileInfo.attribute(info.id, nullptr), &gerror);
         if (!succ)
             ret = false;
         if (gerror)
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "private/dsortedlisting_p.h"
+
+USING_IO_NAMESPACE
+
+DSortedListing::DSortedListing()
+    : d(new DSortedListingData)
+{
+}
+
+DSortedListing::DSortedListing(const QString &parentPath)
+    : d(new DSortedListingData)
+{
+    d->parentPath = parentPath;
+    if (d->parentPath.length() > 1 && d->parentPath.endsWith('/'))
+        d->parentPath.chop(1);
+}
+
+DSortedListing::DSortedListing(const DSortedListing &other) = default;
+
+DSortedListing &DSortedListing::operator=(const DSortedListing &other) = default;
+
+DSortedListing::~DSortedListing() = default;
+
+QString DSortedListing::parentPath() const
+{
+    return d->parentPath;
+}
+
+int DSortedListing::size() const
+{
+    return d->flags.size();
+}
+
+bool DSortedListing::isEmpty() const
+{
+    return d->flags.isEmpty();
+}
+
+void DSortedListing::reserve(int count, int nameBytes)
+{
+    d->names.reserve(nameBytes);
+    d->nameOffsets.reserve(count + 1);
+    d->flags.reserve(count);
+    d->sizes.reserve(count);
+    d->modified.reserve(count);
+}
+
+void DSortedListing::append(const char *name, int length, Flags flags, qint64 size, qint64 lastModified)
+{
+    d->names.append(name, length);
+    d->nameOffsets.append(static_cast<quint32>(d->names.size()));
+    d->flags.append(static_cast<quint8>(flags));
+    d->sizes.append(size);
+    d->modified.append(lastModified);
+}
+
+QByteArray DSortedListing::fileNameBytes(int index) const
+{
+    const quint32 begin = d->nameOffsets.at(index);
+    const quint32 end = d->nameOffsets.at(index + 1);
+    return QByteArray::fromRawData(d->names.constData() + begin, static_cast<int>(end - begin));
+}
+
+QString DSortedListing::fileName(int index) const
+{
+    const quint32 begin = d->nameOffsets.at(index);
+    const quint32 end = d->nameOffsets.at(index + 1);
+    return QString::fromLocal8Bit(d->names.constData() + begin, static_cast<int>(end - begin));
+}
+
+QString DSortedListing::filePath(int index) const
+{
+    if (d->parentPath.endsWith('/'))
+        return d->parentPath + fileName(index);
+    return d->parentPath + '/' + fileName(index);
+}
+
+QUrl DSortedListing::url(int index) const
+{
+    return QUrl::fromLocalFile(filePath(index));
+}
+
+DSortedListing::Flags DSortedListing::flags(int index) const
+{
+    return Flags(d->flags.at(index));
+}
+
+qint64 DSortedListing::fileSize(int index) const
+{
+    return d->sizes.at(index);
+}
+
+qint64 DSortedListing::lastModified(int index) const
+{
+    return d->modified.at(index);
+}
+
+QSharedPointer<DEnumerator::SortFileInfo> DSortedListing::sortFileInfo(int index) const
+{
+    const Flags entryFlags = flags(index);
+    auto sortPointer = QSharedPointer<DEnumerator::SortFileInfo>(new DEnumerator::SortFileInfo);
+    sortPointer->url = url(index);
+    sortPointer->isFile = entryFlags.testFlag(kIsFile);
+    sortPointer->isDir = entryFlags.testFlag(kIsDir);
+    sortPointer->isSymLink = entryFlags.testFlag(kIsSymLink);
+    sortPointer->isHide = entryFlags.testFlag(kIsHide);
+    sortPointer->isReadable = entryFlags.testFlag(kIsReadable);
+    sortPointer->isWriteable = entryFlags.testFlag(kIsWriteable);
+    sortPointer->isExecutable = entryFlags.testFlag(kIsExecutable);
+    return sortPointer;
+}
+
+size_t DSortedListing::memoryUsage() const
+{
+    return sizeof(DSortedListingData)
+            + static_cast<size_t>(d->parentPath.capacity()) * sizeof(QChar)
+            + static_cast<size_t>(d->names.capacity())
+            + static_cast<size_t>(d->nameOffsets.capacity()) * sizeof(quint32)
+            + static_cast<size_t>(d->flags.capacity()) * sizeof(quint8)
+            + static_cast<size_t>(d->sizes.capacity()) * sizeof(qint64)
+            + static_cast<size_t>(d->modified.capacity()) * sizeof(qint64);
+}
@@ -5,6 +5,8 @@
 #include <dfm-io/dwatcher.h>
 
 #include "private/dwatcher_p.h"
+#include "utils/dhiddenlistcache.h"
+#include "utils/dlistingcache.h"
 
 #include <QDebug>
 
@@ -21,6 +23,8 @@ DWatcherPrivate::DWatcherPrivate(DWatcher *q)
 
 DWatcherPrivate::~DWatcherPrivate()
 {
+    if (!cacheKey.isEmpty())
+        DListingCache::instance()->unwatch(cacheKey);
 }
 
 GFileMonitor *DWatcherPrivate::createMonitor(GFile *gfile, DWatcher::WatchType type)
@@ -73,6 +77,25 @@ void DWatcherPrivate::watchCallback(GFileMonitor *monitor, GFile *child, GFile *
     if (otherUrl.path().startsWith("//"))
         otherUrl.setPath(otherUrl.path().mid(1));
 
+    // the cached hide list of the dir is stale now
+    if (childUrl.isLocalFile() && childUrl.fileName() == ".hidden")
+        DHiddenListCache::instance()->invalidate(childUrl.adjusted(QUrl::RemoveFilename).path());
+    if (otherUrl.isLocalFile() && otherUrl.fileName() == ".hidden")
+        DHiddenListCache::instance()->invalidate(otherUrl.adjusted(QUrl::RemoveFilename).path());
+
+    // cached listings holding the changed files are stale, the watched dir itself
+    // may be the one that changed
+    if (eventType != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT) {
+        for (GFile *file : { child, other }) {
+            if (!file)
+                continue;
+            g_autoptr(GFile) parent = g_file_get_parent(file);
+            if (parent)
+                DListingCache::instance()->invalidate(DListingCache::dirKey(parent));
+            DListingCache::instance()->invalidate(DListingCache::dirKey(file));
+        }
+    }
+
     switch (eventType) {
     case G_FILE_MONITOR_EVENT_CHANGED:
         watcher->fileChanged(childUrl);
@@ -194,11 +217,19 @@ bool DWatcher::start(int timeRate)
 
     g_signal_connect(d->gmonitor, "changed", G_CALLBACK(&DWatcherPrivate::watchCallback), this);
 
+    d->cacheKey = DListingCache::dirKey(d->gfile);
+    DListingCache::instance()->watch(d->cacheKey);
+
     return true;
 }
 
 bool DWatcher::stop()
 {
+    if (!d->cacheKey.isEmpty()) {
+        DListingCache::instance()->unwatch(d->cacheKey);
+        d->cacheKey.clear();
+    }
+
     if (d->gmonitor) {
         g_file_monitor_cancel(d->gmonitor);
         g_object_unref(d->gmonitor);
@@ -5,20 +5,29 @@
 #ifndef DENUMERATOR_P_H
 #define DENUMERATOR_P_H
 
+#include "utils/dlocalenumerator.h"
+#include "utils/dlocalwalker.h"
+#include "utils/dlocalsorter.h"
+#include "utils/dnamematcher.h"
+#include "utils/dlistingcache.h"
+
 #include <dfm-io/dfmio_global.h>
 #include <dfm-io/denumerator.h>
+#include <dfm-io/dsortedlisting.h>
 
 #include <QList>
 #include <QMap>
 #include <QSet>
 #include <QStack>
 #include <QSharedPointer>
+#include <QScopedPointer>
 #include <QMutex>
 #include <QWaitCondition>
 #include <QPointer>
+#include <QElapsedTimer>
+#include <QFuture>
 
 #include <gio/gio.h>
-#include <fts.h>
 
 BEGIN_IO_NAMESPACE
 
@@ -33,6 +42,20 @@ public:
     {
         QSharedPointer<DEnumeratorPrivate> pointer { nullptr };
         GFileEnumerator *enumerator { nullptr };
+        int generation { 0 };   // the startAsyncIterator() call it belongs to
+    };
+
+    // what checkFilter needs of an entry, filled from a DFileInfo or straight from the dirent
+    struct FilterEntry
+    {
+        QString name;
+        QString parentPath;
+        bool isDir { false };
+        bool isFile { false };
+        bool isSymlink { false };
+        bool readable { true };
+        bool writable { true };
+        bool executable { true };
     };
 
 public:
@@ -42,15 +65,38 @@ public:
     bool init();
     void clean();
     bool createEnumerator(const QUrl &url, QPointer<DEnumeratorPrivate> me);
+    bool createLocalEnumerator(const QUrl &url, QPointer<DEnumeratorPrivate> me);
     void checkAndResetCancel();
     void setErrorFromGError(GError *gerror);
+    void setErrorFromErrno(int errnum);
+    void buildQueryAttributes();
+    bool needAccessFilter() const;
+    void updateNameMatcher();
+    bool checkNameFilter(GFileInfo *gfileInfo) const;
     bool checkFilter();
-    FTS *openDirByfts();
-    void insertSortFileInfoList(QList<QSharedPointer<DEnumerator::SortFileInfo>> &fileList,
-                                QList<QSharedPointer<DEnumerator::SortFileInfo>> &dirList,
-                                FTSENT *ent,
-                                FTS *fts, const QSet<QString> &hideList);
+    bool checkFilter(const FilterEntry &entry);
+    bool hasNextLocal();
+    bool hasNextWalker();
+    bool hasNextCached();
+    void commitRecording();
+    QSharedPointer<DFileInfo> createLocalFileInfo();
+    quint64 countLocal(const QString &path);
+    quint64 countGio(const QUrl &url);
+    bool readSortEntries();
+    bool sortAll();
+    bool sortFirstPage(size_t count, size_t *end);
+    void startSortRest();
+    bool sortRemaining();
+    QList<QSharedPointer<DEnumerator::SortFileInfo>> takeSortFileInfos(size_t end);
+    DSortedListing takeSortedListing(size_t end);
     void enumUriAsyncOvered(GList *files);
+    void emitAsyncBatch(GList *files);
+    void adaptAsyncBatchSize(qint64 elapsed, int received);
+    void requestMoreFiles(EnumUriData *data, int count);
+    void asyncBatchConsumed();
+    static bool isCurrentAsync(EnumUriData *data);
+    static void releaseEnumUriData(EnumUriData *data, bool notifyOver);
+    QUrl childUrl(const char *name) const;
     void startAsyncIterator();
     bool hasNext();
     QList<QSharedPointer<DFileInfo>> fileInfoList();
@@ -65,6 +111,7 @@ public:
 
 Q_SIGNALS:
     void asyncIteratorOver();
+    void asyncBatchReady(const QList<QSharedPointer<DFileInfo>> &infos);
 
 public:
     DEnumerator *q { nullptr };
@@ -74,12 +121,35 @@ public:
 
     GCancellable *cancellable { nullptr };
     QStack<GFileEnumerator *> stackEnumerator;
+    QStack<DLocalEnumerator *> stackLocalEnumerator;
+    DLocalEnumerator::Entry localEntry;
+    QScopedPointer<DLocalWalker> walker;
+    DLocalWalker::Entry walkerEntry;
+    QByteArray walkerPath;
+    QByteArray walkerParentPath;   // whose access walkerParent holds
+    DLocalEnumerator::ParentAccess walkerParent;
+    int maxThreadCount { 1 };
+    QScopedPointer<DLocalSorter> sorter;
+    size_t sortTaken { 0 };   // sorted entries already handed out
+    QSet<QString> sortHideList;
+    QFuture<void> sortRestFuture;
+    QSharedPointer<const DListingCache::InfoListing> cachedListing;   // served instead of the dir
+    int cachedIndex { 0 };
+    QScopedPointer<DListingCache::InfoListing> recording;   // filled while the dir is read, for the cache
+    DListingCache::Ticket cacheTicket;
     QSharedPointer<DFileInfo> dfileInfoNext { nullptr };
-    QMap<QUrl, QSet<QString>> hideListMap;
+    QString hideListDir;   // dir of hideList, read from DHiddenListCache
+    QSet<QString> hideList;
+    bool hideListValid { false };
     QList<QSharedPointer<DFileInfo>> infoList;
     QList<GFileInfo *> asyncInfos;
 
+    QList<DFileInfo::AttributeID> queryAttributeIds;
+    QByteArray queryAttributes;
+    bool queryNatively { false };
+    unsigned int queryStatxMask { 0 };
     QStringList nameFilters;
+    DNameMatcher nameMatcher;
     DEnumerator::DirFilters dirFilters { DEnumerator::DirFilter::kNoFilter };
     DEnumerator::IteratorFlags iteratorFlags { DEnumerator::IteratorFlag::kNoIteratorFlags };
     bool isMixDirAndFile { false };
@@ -89,13 +159,25 @@ public:
     QUrl uri;
     QUrl nextUrl;
     ulong enumTimeout { 0 };
-    bool ftsCanceled { false };
     std::atomic_bool inited { false };
     bool enumSubDir { false };
     bool enumLinks { false };
+    bool localEnumerate { false };
+    bool localEntryValid { false };
+    bool localDescend { false };
+    std::atomic_bool enumCanceled { false };
     std::atomic_bool async { false };
     std::atomic_bool asyncStoped { false };
     std::atomic_bool asyncOvered { false };
+
+    // streaming batches of the async iterator
+    bool asyncBatchMode { false };
+    int asyncBatchSize { 0 };
+    int maxPendingBatches { 0 };
+    int pendingBatches { 0 };
+    int asyncGeneration { 0 };
+    EnumUriData *pausedData { nullptr };
+    QElapsedTimer batchTimer;
 };
 
 END_IO_NAMESPACE
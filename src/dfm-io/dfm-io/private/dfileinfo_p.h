@@ -6,6 +6,7 @@
 #define DFILEINFO_P_H
 
 #include "utils/dmediainfo.h"
+#include "utils/dmediacache.h"
 
 #include <dfm-io/dfileinfo.h>
 #include <dfm-io/dfmio_global.h>
@@ -13,47 +14,78 @@
 #include <QUrl>
 #include <QVariant>
 #include <QSharedData>
-#include <QPointer>
+#include <QSharedPointer>
+#include <QAtomicPointer>
+#include <QFuture>
 
 #include <gio/gio.h>
 
-#include <unordered_map>
-#include <string>
+#include <sys/stat.h>
+
+#include <memory>
 
 BEGIN_IO_NAMESPACE
 
-class DFileInfoPrivate : public QObject, public QSharedData
+// one per listing entry, so kept plain: no QObject, nothing allocated until it is used
+class DFileInfoPrivate : public QSharedData
 {
 public:
+    // what a QPointer did for async ops, points to the private until it is destroyed
+    using Token = QSharedPointer<DFileInfoPrivate *>;
+
     typedef struct
     {
         DFileInfo::InitQuerierAsyncCallback callback;
         gpointer userData;
-        QPointer<DFileInfoPrivate> me;
+        Token me;
     } QueryInfoAsyncOp;
     typedef struct
     {
-        QPointer<DFileInfoPrivate> me;
+        Token me;
         DFileFuture *future = nullptr;
     } QueryInfoAsyncOp2;
 
     explicit DFileInfoPrivate(DFileInfo *qq);
     DFileInfoPrivate(const DFileInfoPrivate &other);
     DFileInfoPrivate &operator=(const DFileInfoPrivate &other);
-    virtual ~DFileInfoPrivate() override;
-    void initNormal();
+    ~DFileInfoPrivate();
+
+    static void *operator new(size_t size);
+    static void operator delete(void *block, size_t size);
+
+    Token token();
+    static DFileInfoPrivate *alive(const Token &token);
+    GFile *file();
+    static bool isRealizedBySelf(DFileInfo::AttributeID id);
+    static bool isSelfTime(DFileInfo::AttributeID id);
+    static bool isFileSystemAttribute(DFileInfo::AttributeID id);
+    static bool isOwnerAttribute(DFileInfo::AttributeID id);
+    static bool isContentTypeAttribute(DFileInfo::AttributeID id);
+    static bool isNoBlockIO(DFileInfo::AttributeID id);
 
     void attributeExtend(DFileInfo::MediaType type, QList<DFileInfo::AttributeExtendID> ids, DFileInfo::AttributeExtendFuncCallback callback = nullptr);
     [[nodiscard]] DFileFuture *attributeExtend(DFileInfo::MediaType type, QList<DFileInfo::AttributeExtendID> ids, int ioPriority, QObject *parent = nullptr);
     bool cancelAttributeExtend();
     bool cancelAttributes();
-    void attributeExtendCallback();
+    static QMap<DFileInfo::AttributeExtendID, QVariant> mediaMap(const QList<DFileInfo::AttributeExtendID> &ids, const DMediaCache::Values &values);
+    // key is null when the file could not be stat'ed, nothing is cached then
+    void attributeExtendCallback(const DMediaCache::Key *key);
 
     void setErrorFromGError(GError *gerror);
     bool queryInfoSync();
     void queryInfoAsync(int ioPriority = 0, DFileInfo::InitQuerierAsyncCallback func = nullptr, void *userData = nullptr);
     QVariant attributesBySelf(DFileInfo::AttributeID id);
+    quint64 selfTime(DFileInfo::AttributeID id);
+    quint32 selfTimeMsec(DFileInfo::AttributeID id);
+    GFileInfo *typedSource(DFileInfo::AttributeID id, const char **key);
+    const struct statx *selfStat();
+    GFileInfo *fileSystemInfo();
+    QString ownerName(DFileInfo::AttributeID id);
+    GFileInfo *contentTypeInfo();
+    GFileInfo *deferredInfo(const char *key);
+    void resetSelfStat();
     QVariant attributesFromUrl(DFileInfo::AttributeID id);
+    bool isAttributeRequested(DFileInfo::AttributeID id);
     void checkAndResetCancel();
 
     [[nodiscard]] DFileFuture *initQuerierAsync(int ioPriority, QObject *parent = nullptr) const;
@@ -63,8 +95,8 @@ public:
     DFile::Permissions permissions() const;
     bool exists() const;
 
-    static void queryInfoAsyncCallback(GObject *sourceObject, GAsyncResult *res, gpointer userData);
-    static void queryInfoAsyncCallback2(GObject *sourceObject, GAsyncResult *res, gpointer userData);
+    static void queryInfoAsyncCallback(GFileInfo *fileinfo, GError *gerror, gpointer userData);
+    static void queryInfoAsyncCallback2(GFileInfo *fileinfo, GError *gerror, gpointer userData);
     static void freeQueryInfoAsyncOp(QueryInfoAsyncOp *op);
     static void freeQueryInfoAsyncOp2(QueryInfoAsyncOp2 *op);
 
@@ -72,7 +104,8 @@ public:
     DFileInfo *q { nullptr };
 
     QUrl uri = QUrl();
-    char *attributes { nullptr };
+    const char *attributes { nullptr };   // interned, never freed
+    GFileAttributeMatcher *attributesMatcher { nullptr };   // shared, not owned
     DFileInfo::FileQueryInfoFlags flag = DFileInfo::FileQueryInfoFlags::kTypeNone;
 
     QSharedPointer<DFMIO::DMediaInfo> mediaInfo { nullptr };
@@ -81,22 +114,32 @@ public:
     DFileInfo::MediaType mediaType = DFileInfo::MediaType::kGeneral;
     DFileInfo::AttributeExtendFuncCallback attributeExtendFuncCallback { nullptr };
 
-    QList<DFileInfo::AttributeID> attributesRealizationSelf;
-    QList<DFileInfo::AttributeID> attributesNoBlockIO;
-    GFile *gfile { nullptr };
+    Token selfToken;
+    QAtomicPointer<GFile> gfile { nullptr };   // made on first use
     GFileInfo *gfileinfo { nullptr };
     std::atomic_bool initFinished { false };
     std::atomic_bool infoReseted { false };
     std::atomic_bool isQuquerying { false };
     GCancellable *gcancellable { nullptr };
 
-    QFuture<void> futureRefresh;
+    std::unique_ptr<QFuture<void>> futureRefresh;   // a default QFuture allocates
     std::atomic_bool stoped { false };
     std::atomic_bool fileExists { false };
     QMap<DFileInfo::AttributeID, QVariant> caches;
     std::atomic_bool cacheing { false };
     std::atomic_bool refreshing { false };
 
+    struct SelfStat
+    {
+        bool valid { false };
+        struct statx stx;
+    };
+    // made on first use like gfile, until the info is queried again
+    QAtomicPointer<SelfStat> selfStatData { nullptr };
+    QAtomicPointer<GFileInfo> fileSystem { nullptr };   // filesystem::* of the device, same lifetime as the statx
+    QAtomicPointer<GFileInfo> contentType { nullptr };   // sniffed content type, icons and description, same lifetime
+    QAtomicPointer<GFileInfo> deferred { nullptr };   // FILE_DEFERRED_ATTRIBUTES left out of the projection, same lifetime
+
     DFMIOError error;
 };
 
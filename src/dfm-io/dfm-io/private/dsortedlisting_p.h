@@ -0,0 +1,29 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DSORTEDLISTING_P_H
+#define DSORTEDLISTING_P_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/dsortedlisting.h>
+
+#include <QSharedData>
+#include <QVector>
+
+BEGIN_IO_NAMESPACE
+
+class DSortedListingData : public QSharedData
+{
+public:
+    QString parentPath;
+    QByteArray names;   // all names back to back, no terminators
+    QVector<quint32> nameOffsets { 0 };   // one more than entries, entry i is [i, i + 1)
+    QVector<quint8> flags;
+    QVector<qint64> sizes;
+    QVector<qint64> modified;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DSORTEDLISTING_P_H
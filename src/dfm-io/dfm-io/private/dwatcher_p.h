@@ -36,6 +36,7 @@ public:
     int timeRate { 200 };
     DWatcher::WatchType type = DWatcher::WatchType::kAuto;
     QUrl uri;
+    QString cacheKey;   // of the watched dir in DListingCache
     DFMIOError error;
 };
 
@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dbatchquerier.h"
+#include "dlocalhelper.h"
+#include "dlocalenumerator.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QThreadPool>
+#include <QFutureSynchronizer>
+#include <QtConcurrent>
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+// threads asking gio at the same time, a remote mount serves only so many requests
+constexpr int kMaxQueryThreads = 8;
+// urls one task handles, gio ones wait on the mount, local ones only on statx
+constexpr int kGioChunkSize = 16;
+constexpr int kLocalChunkSize = 256;
+
+QThreadPool *queryPool()
+{
+    static QThreadPool *pool = [] {
+        QThreadPool *threadPool = new QThreadPool;
+        threadPool->setMaxThreadCount(kMaxQueryThreads);
+        return threadPool;
+    }();
+    return pool;
+}
+
+unsigned char direntType(mode_t mode)
+{
+    return static_cast<unsigned char>(IFTODT(mode));
+}
+}   // namespace
+
+DBatchQuerier::DBatchQuerier(const QList<QUrl> &urls, const QList<DFileInfo::AttributeID> &attributes, DFileInfo::FileQueryInfoFlags flag)
+    : urls(urls), flag(flag)
+{
+    followSymlinks = flag != DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks;
+    if (attributes.isEmpty()) {
+        this->attributes = FILE_DEFAULT_ATTRIBUTES;
+        remoteAttributes = FILE_REMOTE_DEFAULT_ATTRIBUTES;
+    } else {
+        QList<DFileInfo::AttributeID> ids = attributes;
+        ids << DFileInfo::AttributeID::kStandardName << DFileInfo::AttributeID::kStandardType;
+        this->attributes = DLocalHelper::attributesQueryString(ids);
+        remoteAttributes = DLocalHelper::attributesQueryString(ids, false);
+    }
+    queryNatively = DLocalEnumerator::canQueryNatively(this->attributes.constData());
+    if (queryNatively)
+        statxMask = DLocalEnumerator::statxMask(DLocalHelper::attributeMatcher(this->attributes.constData()));
+}
+
+void DBatchQuerier::run(const ResultCallback &callback)
+{
+    // local files by their dir, the rest in chunks for gio
+    QHash<QString, QVector<int>> localDirs;
+    QVector<int> gioIndexes;
+    for (int i = 0; i < urls.size(); ++i) {
+        const QUrl &url = urls.at(i);
+        if (queryNatively && url.isLocalFile()) {
+            const QString &path = url.toLocalFile();
+            const int slash = path.lastIndexOf('/');
+            if (slash >= 0 && slash < path.length() - 1) {
+                localDirs[slash == 0 ? QString("/") : path.left(slash)].append(i);
+                continue;
+            }
+        }
+        gioIndexes.append(i);
+    }
+
+    QMutex callbackMutex;
+    const ResultCallback deliver = [&callbackMutex, &callback](int index, const QSharedPointer<DFileInfo> &info) {
+        QMutexLocker locker(&callbackMutex);
+        callback(index, info);
+    };
+
+    QFutureSynchronizer<void> synchronizer;
+    for (auto it = localDirs.constBegin(); it != localDirs.constEnd(); ++it) {
+        const QString dirPath = it.key();
+        for (int begin = 0; begin < it.value().size(); begin += kLocalChunkSize) {
+            const QVector<int> indexes = it.value().mid(begin, kLocalChunkSize);
+            synchronizer.addFuture(QtConcurrent::run(queryPool(), [this, dirPath, indexes, &deliver]() {
+                queryLocalDir(dirPath, indexes, deliver);
+            }));
+        }
+    }
+    for (int begin = 0; begin < gioIndexes.size(); begin += kGioChunkSize) {
+        const QVector<int> indexes = gioIndexes.mid(begin, kGioChunkSize);
+        synchronizer.addFuture(QtConcurrent::run(queryPool(), [this, indexes, &deliver]() {
+            queryGio(indexes, deliver);
+        }));
+    }
+    synchronizer.waitForFinished();
+}
+
+void DBatchQuerier::queryLocalDir(const QString &dirPath, const QVector<int> &indexes, const ResultCallback &callback)
+{
+    // O_PATH is enough for the *at calls and works on dirs that can't be read
+    const int dirFd = open(dirPath.toLocal8Bit().constData(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) {
+        queryGio(indexes, callback);
+        return;
+    }
+
+    GFileAttributeMatcher *matcher = DLocalHelper::attributeMatcher(attributes.constData());
+    const bool needsParent = DLocalEnumerator::needsParentAccess(matcher);
+    const DLocalEnumerator::ParentAccess parent = needsParent ? DLocalEnumerator::parentAccess(dirPath.toLocal8Bit(), matcher)
+                                                              : DLocalEnumerator::ParentAccess();
+    for (int index : indexes) {
+        const QUrl &url = urls.at(index);
+        const QByteArray &name = url.fileName(QUrl::FullyDecoded).toLocal8Bit();
+
+        struct stat st;
+        if (fstatat(dirFd, name.constData(), &st, AT_SYMLINK_NOFOLLOW) != 0) {
+            callback(index, nullptr);
+            continue;
+        }
+        const unsigned char type = direntType(st.st_mode);
+        unsigned char targetType = type;
+        if (type == DT_LNK && followSymlinks) {
+            struct stat target;
+            if (fstatat(dirFd, name.constData(), &target, 0) == 0)
+                targetType = direntType(target.st_mode);
+        }
+
+        GFileInfo *gfileInfo = DLocalEnumerator::createFileInfoAt(dirFd, name.constData(), name.constData(), type, targetType,
+                                                                  matcher, statxMask, followSymlinks, needsParent ? &parent : nullptr);
+        callback(index, DLocalHelper::createFileInfoByUri(url, gfileInfo, attributes.constData(), flag));
+    }
+    close(dirFd);
+}
+
+void DBatchQuerier::queryGio(const QVector<int> &indexes, const ResultCallback &callback)
+{
+    for (int index : indexes) {
+        const QUrl &url = urls.at(index);
+        const QByteArray &keys = url.isLocalFile() ? attributes : remoteAttributes;
+        g_autoptr(GFile) gfile = g_file_new_for_uri(url.toString().toLocal8Bit().constData());
+        g_autoptr(GError) gerror = nullptr;
+        GFileInfo *gfileInfo = g_file_query_info(gfile, keys.constData(),
+                                                 followSymlinks ? G_FILE_QUERY_INFO_NONE : G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+                                                 nullptr, &gerror);
+        if (!gfileInfo) {
+            callback(index, nullptr);
+            continue;
+        }
+        callback(index, DLocalHelper::createFileInfoByUri(url, gfileInfo, keys.constData(), flag));
+    }
+}
@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DBATCHQUERIER_H
+#define DBATCHQUERIER_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/dfileinfo.h>
+
+#include <QUrl>
+#include <QList>
+#include <QVector>
+#include <QByteArray>
+#include <QSharedPointer>
+
+#include <functional>
+
+BEGIN_IO_NAMESPACE
+
+// queries the infos of many urls at once. local files are grouped by their dir and
+// stat'ed relative to one dir fd when statx can answer the attributes, everything
+// else is asked from gio, spread over a small pool so remote mounts are not flooded
+class DBatchQuerier
+{
+public:
+    // index into the queried urls, info is null when the file could not be queried
+    using ResultCallback = std::function<void(int index, const QSharedPointer<DFileInfo> &info)>;
+
+    DBatchQuerier(const QList<QUrl> &urls, const QList<DFileInfo::AttributeID> &attributes, DFileInfo::FileQueryInfoFlags flag);
+
+    // blocks until every url is done, callback runs in the pool threads one call at a time
+    void run(const ResultCallback &callback);
+
+private:
+    void queryLocalDir(const QString &dirPath, const QVector<int> &indexes, const ResultCallback &callback);
+    void queryGio(const QVector<int> &indexes, const ResultCallback &callback);
+
+    QList<QUrl> urls;
+    QByteArray attributes;
+    QByteArray remoteAttributes;   // what gio is asked for urls of other schemes
+    DFileInfo::FileQueryInfoFlags flag;
+    bool followSymlinks { true };
+    bool queryNatively { false };
+    unsigned int statxMask { 0 };
+};
+
+END_IO_NAMESPACE
+
+#endif   // DBATCHQUERIER_H
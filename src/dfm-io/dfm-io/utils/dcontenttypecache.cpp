@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dcontenttypecache.h"
+
+#include <QMutexLocker>
+
+USING_IO_NAMESPACE
+
+namespace {
+// files remembered at most, the cache starts over when full
+constexpr int kMaxEntries = 65536;
+}   // namespace
+
+DContentTypeCache *DContentTypeCache::instance()
+{
+    static DContentTypeCache cache;
+    return &cache;
+}
+
+QByteArray DContentTypeCache::find(const Key &key)
+{
+    QMutexLocker locker(&mutex);
+    auto it = types.find(Slot { key.dev, key.ino });
+    if (it == types.end())
+        return QByteArray();
+    if (it->modifiedNs != key.modifiedNs || it->size != key.size) {
+        // the file changed, its type is sniffed again
+        types.erase(it);
+        return QByteArray();
+    }
+    return it->contentType;
+}
+
+void DContentTypeCache::insert(const Key &key, const QByteArray &contentType)
+{
+    if (contentType.isEmpty())
+        return;
+
+    const Slot slot { key.dev, key.ino };
+    QMutexLocker locker(&mutex);
+    if (types.size() >= kMaxEntries && !types.contains(slot))
+        types.clear();
+    types.insert(slot, Entry { key.modifiedNs, key.size, contentType });
+}
+
+int DContentTypeCache::size()
+{
+    QMutexLocker locker(&mutex);
+    return types.size();
+}
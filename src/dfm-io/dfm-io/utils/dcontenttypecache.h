@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DCONTENTTYPECACHE_H
+#define DCONTENTTYPECACHE_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+
+BEGIN_IO_NAMESPACE
+
+// content types gio sniffed from the headers of regular files, so a file is read once
+// per process. an entry holds while the file keeps its device, inode, mtime and size,
+// a file found with another mtime or size is dropped
+class DContentTypeCache
+{
+public:
+    struct Key
+    {
+        quint64 dev { 0 };
+        quint64 ino { 0 };
+        qint64 modifiedNs { 0 };
+        qint64 size { 0 };
+    };
+
+    static DContentTypeCache *instance();
+
+    DContentTypeCache() = default;
+
+    QByteArray find(const Key &key);
+    void insert(const Key &key, const QByteArray &contentType);
+    int size();
+
+private:
+    Q_DISABLE_COPY(DContentTypeCache)
+
+    struct Slot
+    {
+        quint64 dev;
+        quint64 ino;
+        bool operator==(const Slot &other) const { return dev == other.dev && ino == other.ino; }
+    };
+    friend uint qHash(const Slot &slot, uint seed = 0)
+    {
+        return qHash(slot.ino, seed) ^ qHash(slot.dev, seed);
+    }
+
+    struct Entry
+    {
+        qint64 modifiedNs;
+        qint64 size;
+        QByteArray contentType;
+    };
+
+    QMutex mutex;
+    QHash<Slot, Entry> types;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DCONTENTTYPECACHE_H
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dfilesystemcache.h"
+
+#include <QMutexLocker>
+#include <QtConcurrent>
+
+USING_IO_NAMESPACE
+
+namespace {
+// free space moves while files are copied, so values are not trusted for long
+constexpr qint64 kTimeToLive = 3000;   // ms
+// past this a stale entry is not handed out, e.g. after a long idle the free space
+// of hours ago would pass a copy's space check
+constexpr qint64 kMaxAge = 4 * kTimeToLive;   // ms
+constexpr int kMaxRefreshThreads = 2;
+// filesystems remembered at most, the cache starts over when full
+constexpr int kMaxEntries = 256;
+}   // namespace
+
+DFileSystemCache *DFileSystemCache::instance()
+{
+    static DFileSystemCache cache;
+    return &cache;
+}
+
+QByteArray DFileSystemCache::localKey(dev_t dev)
+{
+    return "l" + QByteArray::number(static_cast<quint64>(dev));
+}
+
+DFileSystemCache::DFileSystemCache()
+{
+    refreshPool.setMaxThreadCount(kMaxRefreshThreads);
+}
+
+DFileSystemCache::~DFileSystemCache()
+{
+    // a running refresh still stores into the cache
+    refreshPool.clear();
+    refreshPool.waitForDone();
+    for (const Entry &entry : qAsConst(entries)) {
+        if (entry.info)
+            g_object_unref(entry.info);
+    }
+}
+
+GFileInfo *DFileSystemCache::info(const QByteArray &key, GFile *file)
+{
+    if (!file)
+        return nullptr;
+    if (key.isEmpty())
+        return query(file);
+
+    {
+        QMutexLocker locker(&mutex);
+        auto it = entries.find(key);
+        if (it != entries.end() && it->info && !it->age.hasExpired(kMaxAge)) {
+            GFileInfo *info = G_FILE_INFO(g_object_ref(it->info));
+            if (it->age.hasExpired(kTimeToLive) && !it->refreshing) {
+                // a slow mount should not hold up the caller, the stale values do for now
+                it->refreshing = true;
+                locker.unlock();
+                refresh(key, file);
+            }
+            return info;
+        }
+    }
+
+    GFileInfo *info = query(file);
+    if (info)
+        store(key, G_FILE_INFO(g_object_ref(info)));
+    return info;
+}
+
+GFileInfo *DFileSystemCache::query(GFile *file)
+{
+    return g_file_query_filesystem_info(file, "filesystem::*", nullptr, nullptr);
+}
+
+void DFileSystemCache::store(const QByteArray &key, GFileInfo *info)
+{
+    QMutexLocker locker(&mutex);
+    if (entries.size() >= kMaxEntries && !entries.contains(key)) {
+        for (const Entry &entry : qAsConst(entries)) {
+            if (entry.info)
+                g_object_unref(entry.info);
+        }
+        entries.clear();
+    }
+
+    Entry &entry = entries[key];
+    if (entry.info)
+        g_object_unref(entry.info);
+    entry.info = info;
+    entry.age.start();
+    entry.refreshing = false;
+}
+
+void DFileSystemCache::refresh(const QByteArray &key, GFile *file)
+{
+    g_object_ref(file);
+    QtConcurrent::run(&refreshPool, [this, key, file]() {
+        GFileInfo *info = query(file);
+        g_object_unref(file);
+        if (info) {
+            store(key, info);
+            return;
+        }
+
+        // keep the old values and try again on a later lookup, their age stays
+        // so they still run out
+        QMutexLocker locker(&mutex);
+        auto it = entries.find(key);
+        if (it != entries.end())
+            it->refreshing = false;
+    });
+}
@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DFILESYSTEMCACHE_H
+#define DFILESYSTEMCACHE_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QThreadPool>
+
+#include <gio/gio.h>
+
+#include <sys/types.h>
+
+BEGIN_IO_NAMESPACE
+
+// the filesystem::* attributes of each filesystem, shared by all the files on it so a
+// listing asks statfs once per device instead of once per entry. an entry is used as
+// is for a short while, after that it is still handed out while a fresh one is read,
+// until it is too old to be handed out at all and the caller waits for a fresh one
+class DFileSystemCache
+{
+public:
+    static DFileSystemCache *instance();
+    // the key gio gives local files in id::filesystem
+    static QByteArray localKey(dev_t dev);
+
+    // a new reference to the filesystem attributes of file or null. key names the
+    // filesystem, as id::filesystem does, files without one are queried every time
+    GFileInfo *info(const QByteArray &key, GFile *file);
+
+private:
+    DFileSystemCache();
+    ~DFileSystemCache();
+    Q_DISABLE_COPY(DFileSystemCache)
+
+    struct Entry
+    {
+        GFileInfo *info { nullptr };
+        QElapsedTimer age;
+        bool refreshing { false };
+    };
+
+    static GFileInfo *query(GFile *file);
+    void store(const QByteArray &key, GFileInfo *info);
+    void refresh(const QByteArray &key, GFile *file);
+
+    QMutex mutex;
+    QHash<QByteArray, Entry> entries;
+    // runs the refreshes, waited for before the cache goes away at exit
+    QThreadPool refreshPool;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DFILESYSTEMCACHE_H
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dfixedpool.h"
+
+#include <QMutexLocker>
+
+#include <new>
+
+USING_IO_NAMESPACE
+
+namespace {
+// empty chunks kept, a listing made again right after the last one went needs no new memory
+constexpr int kMaxEmptyChunks = 1;
+}   // namespace
+
+DFixedPool::DFixedPool(size_t blockSize, int blocksPerChunk)
+    : perChunk(qMax(blocksPerChunk, 1))
+{
+    // every block can hold a free list link and is aligned for any type
+    const size_t align = alignof(std::max_align_t);
+    size = (qMax(blockSize, sizeof(FreeBlock)) + align - 1) / align * align;
+}
+
+DFixedPool::~DFixedPool()
+{
+    for (auto &chunk : chunks)
+        ::operator delete(chunk.second.memory);
+}
+
+void *DFixedPool::allocate()
+{
+    QMutexLocker locker(&mutex);
+    if (!available)
+        newChunk();
+
+    Chunk *chunk = available;
+    FreeBlock *block = chunk->freeBlocks;
+    chunk->freeBlocks = block->next;
+    if (chunk->used++ == 0)
+        --emptyChunks;
+    if (!chunk->freeBlocks)
+        unlinkAvailable(chunk);
+    return block;
+}
+
+void DFixedPool::deallocate(void *block)
+{
+    if (!block)
+        return;
+
+    QMutexLocker locker(&mutex);
+    // the last chunk starting at or before the block
+    auto it = chunks.upper_bound(static_cast<char *>(block));
+    Q_ASSERT(it != chunks.begin());
+    --it;
+    Chunk *chunk = &it->second;
+
+    FreeBlock *freed = static_cast<FreeBlock *>(block);
+    freed->next = chunk->freeBlocks;
+    if (!chunk->freeBlocks)
+        linkAvailable(chunk);
+    chunk->freeBlocks = freed;
+
+    if (--chunk->used > 0)
+        return;
+    if (emptyChunks < kMaxEmptyChunks) {
+        ++emptyChunks;
+        return;
+    }
+    unlinkAvailable(chunk);
+    ::operator delete(chunk->memory);
+    chunks.erase(it);
+}
+
+void DFixedPool::newChunk()
+{
+    char *memory = static_cast<char *>(::operator new(size * static_cast<size_t>(perChunk)));
+    Chunk *chunk = &chunks[memory];
+    chunk->memory = memory;
+    // thread the new blocks back to front so they go out in address order
+    for (int i = perChunk - 1; i >= 0; --i) {
+        FreeBlock *block = reinterpret_cast<FreeBlock *>(memory + size * static_cast<size_t>(i));
+        block->next = chunk->freeBlocks;
+        chunk->freeBlocks = block;
+    }
+    ++emptyChunks;
+    linkAvailable(chunk);
+}
+
+void DFixedPool::linkAvailable(Chunk *chunk)
+{
+    chunk->prevAvailable = nullptr;
+    chunk->nextAvailable = available;
+    if (available)
+        available->prevAvailable = chunk;
+    available = chunk;
+}
+
+void DFixedPool::unlinkAvailable(Chunk *chunk)
+{
+    if (chunk->prevAvailable)
+        chunk->prevAvailable->nextAvailable = chunk->nextAvailable;
+    else
+        available = chunk->nextAvailable;
+    if (chunk->nextAvailable)
+        chunk->nextAvailable->prevAvailable = chunk->prevAvailable;
+    chunk->prevAvailable = nullptr;
+    chunk->nextAvailable = nullptr;
+}
@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DFIXEDPOOL_H
+#define DFIXEDPOOL_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QMutex>
+
+#include <map>
+
+BEGIN_IO_NAMESPACE
+
+// blocks of one size cut from big chunks, for objects made by the thousand such as
+// the infos of a listing. freed blocks are kept for the next allocation, a chunk whose
+// blocks are all free again is given back, except one kept for the next listing
+class DFixedPool
+{
+public:
+    DFixedPool(size_t blockSize, int blocksPerChunk);
+    ~DFixedPool();
+
+    size_t blockSize() const { return size; }
+    void *allocate();
+    void deallocate(void *block);
+
+private:
+    Q_DISABLE_COPY(DFixedPool)
+
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    struct Chunk
+    {
+        char *memory { nullptr };
+        FreeBlock *freeBlocks { nullptr };
+        int used { 0 };
+        // in the list of chunks with free blocks
+        Chunk *prevAvailable { nullptr };
+        Chunk *nextAvailable { nullptr };
+    };
+
+    void newChunk();
+    void linkAvailable(Chunk *chunk);
+    void unlinkAvailable(Chunk *chunk);
+
+    QMutex mutex;
+    std::map<char *, Chunk> chunks;   // by address, a freed block finds its chunk
+    Chunk *available { nullptr };
+    int emptyChunks { 0 };
+    size_t size { 0 };
+    int perChunk { 0 };
+};
+
+END_IO_NAMESPACE
+
+#endif   // DFIXEDPOOL_H
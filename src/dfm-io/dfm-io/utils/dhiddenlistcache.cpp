@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dhiddenlistcache.h"
+
+#include <QStringList>
+
+#include <glib.h>
+
+#include <sys/stat.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+// dirs remembered at most, the cache starts over when full
+constexpr int kMaxEntries = 4096;
+
+QString cleanDirPath(const QString &dirPath)
+{
+    if (dirPath.length() > 1 && dirPath.endsWith('/'))
+        return dirPath.left(dirPath.length() - 1);
+    return dirPath;
+}
+
+QString hiddenFilePath(const QString &dirPath)
+{
+    if (dirPath.endsWith('/'))
+        return dirPath + ".hidden";
+    return dirPath + "/.hidden";
+}
+}   // namespace
+
+DHiddenListCache *DHiddenListCache::instance()
+{
+    static DHiddenListCache cache;
+    return &cache;
+}
+
+QSet<QString> DHiddenListCache::hideList(const QString &path)
+{
+    const QString &dirPath = cleanDirPath(path);
+    const QByteArray &hiddenPath = hiddenFilePath(dirPath).toLocal8Bit();
+
+    Entry entry;
+    struct stat st;
+    if (stat(hiddenPath.constData(), &st) == 0) {
+        entry.exists = true;
+        entry.dev = st.st_dev;
+        entry.ino = st.st_ino;
+        entry.size = st.st_size;
+        entry.modified = st.st_mtim;
+    }
+
+    {
+        QMutexLocker locker(&mutex);
+        auto it = entries.constFind(dirPath);
+        if (it != entries.constEnd() && it->exists == entry.exists && it->dev == entry.dev && it->ino == entry.ino
+            && it->size == entry.size && it->modified.tv_sec == entry.modified.tv_sec
+            && it->modified.tv_nsec == entry.modified.tv_nsec)
+            return it->names;
+    }
+
+    // stat before read: a change in between is seen by the next lookup
+    if (entry.exists) {
+        g_autofree char *contents = nullptr;
+        gsize len = 0;
+        if (g_file_get_contents(hiddenPath.constData(), &contents, &len, nullptr) && contents && len > 0) {
+            QString dataStr(contents);
+            entry.names = QSet<QString>::fromList(dataStr.split('\n', QString::SkipEmptyParts));
+        }
+    }
+
+    QMutexLocker locker(&mutex);
+    if (entries.size() >= kMaxEntries)
+        entries.clear();
+    entries.insert(dirPath, entry);
+    return entry.names;
+}
+
+void DHiddenListCache::invalidate(const QString &dirPath)
+{
+    QMutexLocker locker(&mutex);
+    entries.remove(cleanDirPath(dirPath));
+}
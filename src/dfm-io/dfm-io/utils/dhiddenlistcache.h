@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DHIDDENLISTCACHE_H
+#define DHIDDENLISTCACHE_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QString>
+#include <QSet>
+#include <QHash>
+#include <QMutex>
+
+#include <sys/types.h>
+#include <time.h>
+
+BEGIN_IO_NAMESPACE
+
+// the names listed in the .hidden file of local dirs, shared by the whole process.
+// an entry is used as long as the .hidden file keeps its inode, mtime and size,
+// watchers drop it as soon as the file changes
+class DHiddenListCache
+{
+public:
+    static DHiddenListCache *instance();
+
+    QSet<QString> hideList(const QString &path);
+    void invalidate(const QString &dirPath);
+
+private:
+    DHiddenListCache() = default;
+    Q_DISABLE_COPY(DHiddenListCache)
+
+    struct Entry
+    {
+        QSet<QString> names;
+        bool exists { false };
+        dev_t dev { 0 };
+        ino_t ino { 0 };
+        off_t size { 0 };
+        timespec modified { 0, 0 };
+    };
+
+    QMutex mutex;
+    QHash<QString, Entry> entries;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DHIDDENLISTCACHE_H
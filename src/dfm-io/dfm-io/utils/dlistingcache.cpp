@@ -0,0 +1,287 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dlistingcache.h"
+
+#include <QMutexLocker>
+
+#include <climits>
+
+#include <sys/stat.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+// rough heap size of an enumerated info, a header plus its attributes
+constexpr qint64 kInfoCost = 128;
+constexpr qint64 kAttributeCost = 48;
+// dirs the index may hold beyond twice the items before the evicted ones are swept
+constexpr int kIndexSlack = 64;
+
+bool sameTime(const timespec &left, const timespec &right)
+{
+    return left.tv_sec == right.tv_sec && left.tv_nsec == right.tv_nsec;
+}
+
+bool sameStamp(const DListingCache::Stamp &left, const DListingCache::Stamp &right)
+{
+    return left.valid && right.valid && left.dev == right.dev && left.ino == right.ino
+            && sameTime(left.modified, right.modified) && sameTime(left.changed, right.changed);
+}
+
+QString itemKey(const char *kind, const QString &dirKey, const QByteArray &attributes, bool followLinks)
+{
+    return QString::fromLatin1(kind) + '\n' + dirKey + '\n' + QString::fromLatin1(attributes) + (followLinks ? "\n1" : "\n0");
+}
+
+int costOf(qint64 bytes)
+{
+    return static_cast<int>(qMin<qint64>(bytes, INT_MAX));
+}
+}   // namespace
+
+DListingCache::InfoListing::~InfoListing()
+{
+    for (GFileInfo *info : infos)
+        g_object_unref(info);
+}
+
+void DListingCache::InfoListing::append(const QUrl &url, GFileInfo *info)
+{
+    urls.append(url);
+    infos.append(info);
+}
+
+DListingCache::DListingCache()
+{
+    items.setMaxCost(0);
+}
+
+DListingCache *DListingCache::instance()
+{
+    static DListingCache cache;
+    return &cache;
+}
+
+QString DListingCache::dirKey(const QUrl &url)
+{
+    g_autoptr(GFile) gfile = g_file_new_for_uri(url.toString().toLocal8Bit().constData());
+    return dirKey(gfile);
+}
+
+QString DListingCache::dirKey(GFile *gfile)
+{
+    g_autofree gchar *uri = g_file_get_uri(gfile);
+    QString key = QString::fromLocal8Bit(uri);
+    if (key.length() > 1 && key.endsWith('/') && !key.endsWith(":///"))
+        key.chop(1);
+    return key;
+}
+
+void DListingCache::setMaxCost(qint64 bytes)
+{
+    QMutexLocker locker(&mutex);
+    items.setMaxCost(costOf(qMax<qint64>(bytes, 0)));
+}
+
+qint64 DListingCache::maxCost() const
+{
+    QMutexLocker locker(&mutex);
+    return items.maxCost();
+}
+
+bool DListingCache::isEnabled() const
+{
+    return maxCost() > 0;
+}
+
+DListingCache::Ticket DListingCache::ticket(const QUrl &dirUrl)
+{
+    Ticket ticket;
+    if (!isEnabled())
+        return ticket;
+
+    ticket.dirKey = dirKey(dirUrl);
+    if (dirUrl.isLocalFile()) {
+        ticket.localPath = dirUrl.toLocalFile();
+        ticket.stamp = stampOf(ticket.localPath);
+        ticket.valid = ticket.stamp.valid;
+        return ticket;
+    }
+
+    // nothing tells when an unwatched remote dir changes
+    QMutexLocker locker(&mutex);
+    auto it = watches.constFind(ticket.dirKey);
+    if (it != watches.constEnd()) {
+        ticket.generation = it->generation;
+        ticket.valid = true;
+    }
+    return ticket;
+}
+
+QSharedPointer<const DListingCache::InfoListing> DListingCache::infoListing(const QUrl &dirUrl, const QByteArray &attributes, bool followLinks)
+{
+    if (!isEnabled())
+        return nullptr;
+
+    Item item;
+    if (!lookup(itemKey("info", dirKey(dirUrl), attributes, followLinks), &item))
+        return nullptr;
+    return item.infos;
+}
+
+void DListingCache::insertInfoListing(const Ticket &ticket, const QByteArray &attributes, bool followLinks, InfoListing *listing)
+{
+    QSharedPointer<const InfoListing> infos(listing);
+    if (!ticket.valid)
+        return;
+
+    qint64 cost = static_cast<qint64>(sizeof(InfoListing));
+    if (!infos->infos.isEmpty()) {
+        g_auto(GStrv) names = g_file_info_list_attributes(infos->infos.first(), nullptr);
+        const qint64 attributeCount = names ? static_cast<qint64>(g_strv_length(names)) : 0;
+        cost += infos->infos.size() * (kInfoCost + attributeCount * kAttributeCost);
+    }
+    for (const QUrl &url : infos->urls)
+        cost += static_cast<qint64>(sizeof(QUrl)) + url.path().size() * 2;
+
+    Item *item = new Item;
+    item->infos = infos;
+    insert(itemKey("info", ticket.dirKey, attributes, followLinks), ticket, item, cost);
+}
+
+QSharedPointer<const DListingCache::SortEntries> DListingCache::sortEntries(const QString &dirPath)
+{
+    if (!isEnabled())
+        return nullptr;
+
+    Item item;
+    if (!lookup(itemKey("sort", dirKey(QUrl::fromLocalFile(dirPath)), {}, false), &item))
+        return nullptr;
+    return item.sortEntries;
+}
+
+void DListingCache::insertSortEntries(const Ticket &ticket, const SortEntries &entries)
+{
+    if (!ticket.valid)
+        return;
+
+    qint64 cost = static_cast<qint64>(sizeof(SortEntries));
+    for (const DLocalSorter::Entry &entry : entries)
+        cost += static_cast<qint64>(sizeof(DLocalSorter::Entry)) + entry.name.size() * 3 + entry.key.key().size();
+
+    Item *item = new Item;
+    item->sortEntries.reset(new SortEntries(entries));
+    insert(itemKey("sort", ticket.dirKey, {}, false), ticket, item, cost);
+}
+
+void DListingCache::watch(const QString &dirKey)
+{
+    QMutexLocker locker(&mutex);
+    ++watches[dirKey].count;
+}
+
+void DListingCache::unwatch(const QString &dirKey)
+{
+    {
+        QMutexLocker locker(&mutex);
+        auto it = watches.find(dirKey);
+        if (it == watches.end() || --it->count > 0)
+            return;
+        watches.erase(it);
+    }
+    // nobody reports changes of the dir any more
+    invalidate(dirKey);
+}
+
+void DListingCache::invalidate(const QString &dirKey)
+{
+    QMutexLocker locker(&mutex);
+    auto it = watches.find(dirKey);
+    if (it != watches.end())
+        ++it->generation;
+
+    const QSet<QString> &keys = keysByDir.take(dirKey);
+    for (const QString &key : keys)
+        items.remove(key);
+}
+
+DListingCache::Stamp DListingCache::stampOf(const QString &localPath)
+{
+    Stamp stamp;
+    struct stat st;
+    if (stat(localPath.toLocal8Bit().constData(), &st) != 0)
+        return stamp;
+
+    stamp.valid = true;
+    stamp.dev = st.st_dev;
+    stamp.ino = st.st_ino;
+    stamp.modified = st.st_mtim;
+    stamp.changed = st.st_ctim;
+    return stamp;
+}
+
+bool DListingCache::lookup(const QString &key, Item *item)
+{
+    {
+        QMutexLocker locker(&mutex);
+        const Item *cached = items.object(key);
+        if (!cached)
+            return false;
+        *item = *cached;
+    }
+
+    // remote items live as long as their watcher, its events drop them
+    if (item->localPath.isEmpty())
+        return true;
+
+    // stat outside the lock, the dir may sit on a slow mount
+    if (sameStamp(stampOf(item->localPath), item->stamp))
+        return true;
+
+    QMutexLocker locker(&mutex);
+    const Item *cached = items.object(key);
+    if (cached && sameStamp(cached->stamp, item->stamp))
+        items.remove(key);
+    return false;
+}
+
+void DListingCache::insert(const QString &key, const Ticket &ticket, Item *item, qint64 cost)
+{
+    item->localPath = ticket.localPath;
+    item->stamp = ticket.stamp;
+
+    QMutexLocker locker(&mutex);
+    if (ticket.localPath.isEmpty()) {
+        // the watcher went away or reported a change while the dir was read
+        auto it = watches.constFind(ticket.dirKey);
+        if (it == watches.constEnd() || it->generation != ticket.generation) {
+            delete item;
+            return;
+        }
+    }
+    items.insert(key, item, costOf(cost));
+    // an item costing more than the whole cache is dropped right away
+    if (items.contains(key))
+        keysByDir[ticket.dirKey].insert(key);
+    if (keysByDir.size() > items.count() * 2 + kIndexSlack)
+        pruneIndex();
+}
+
+void DListingCache::pruneIndex()
+{
+    for (auto it = keysByDir.begin(); it != keysByDir.end();) {
+        QSet<QString> &keys = it.value();
+        for (auto key = keys.begin(); key != keys.end();) {
+            if (items.contains(*key))
+                ++key;
+            else
+                key = keys.erase(key);
+        }
+        if (keys.isEmpty())
+            it = keysByDir.erase(it);
+        else
+            ++it;
+    }
+}
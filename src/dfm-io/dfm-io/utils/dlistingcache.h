@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DLISTINGCACHE_H
+#define DLISTINGCACHE_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include "dlocalsorter.h"
+
+#include <QString>
+#include <QByteArray>
+#include <QUrl>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QCache>
+#include <QMutex>
+#include <QSharedPointer>
+
+#include <gio/gio.h>
+
+#include <vector>
+
+#include <sys/types.h>
+#include <time.h>
+
+BEGIN_IO_NAMESPACE
+
+// listings of dirs kept for the next enumerator of the same dir, least recently used
+// ones go first when the memory limit is reached. off until a limit is set.
+// local dirs are checked against the mtime, ctime and inode of the dir on every lookup,
+// other dirs are only kept while a DWatcher watches them and dropped on its events
+class DListingCache
+{
+public:
+    // the children of a dir as gio enumerated them, owns the infos
+    struct InfoListing
+    {
+        ~InfoListing();
+        void append(const QUrl &url, GFileInfo *info);
+
+        QVector<QUrl> urls;
+        QVector<GFileInfo *> infos;
+    };
+    using SortEntries = std::vector<DLocalSorter::Entry>;
+
+    struct Stamp
+    {
+        bool valid { false };
+        dev_t dev { 0 };
+        ino_t ino { 0 };
+        timespec modified { 0, 0 };
+        timespec changed { 0, 0 };
+    };
+
+    // taken before a dir is read, a change while reading shows up on the next lookup
+    struct Ticket
+    {
+        bool valid { false };
+        QString dirKey;
+        QString localPath;
+        Stamp stamp;
+        quint64 generation { 0 };
+    };
+
+    static DListingCache *instance();
+    // the uri of the dir as gio names it, local paths and watchers agree on it
+    static QString dirKey(const QUrl &url);
+    static QString dirKey(GFile *gfile);
+
+    void setMaxCost(qint64 bytes);
+    qint64 maxCost() const;
+    bool isEnabled() const;
+
+    Ticket ticket(const QUrl &dirUrl);
+    QSharedPointer<const InfoListing> infoListing(const QUrl &dirUrl, const QByteArray &attributes, bool followLinks);
+    void insertInfoListing(const Ticket &ticket, const QByteArray &attributes, bool followLinks, InfoListing *listing);
+    QSharedPointer<const SortEntries> sortEntries(const QString &dirPath);
+    void insertSortEntries(const Ticket &ticket, const SortEntries &entries);
+
+    void watch(const QString &dirKey);
+    void unwatch(const QString &dirKey);
+    void invalidate(const QString &dirKey);
+
+private:
+    DListingCache();
+    Q_DISABLE_COPY(DListingCache)
+
+    struct Item
+    {
+        QString localPath;
+        Stamp stamp;
+        QSharedPointer<const InfoListing> infos;
+        QSharedPointer<const SortEntries> sortEntries;
+    };
+
+    struct Watch
+    {
+        int count { 0 };
+        quint64 generation { 0 };
+    };
+
+    static Stamp stampOf(const QString &localPath);
+    bool lookup(const QString &key, Item *item);
+    void insert(const QString &key, const Ticket &ticket, Item *item, qint64 cost);
+    void pruneIndex();
+
+    mutable QMutex mutex;
+    QCache<QString, Item> items;
+    // the item keys of each dir, the cache evicts without telling so some may be gone
+    QHash<QString, QSet<QString>> keysByDir;
+    QHash<QString, Watch> watches;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DLISTINGCACHE_H
@@ -0,0 +1,560 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dlocalenumerator.h"
+#include "dfilesystemcache.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QElapsedTimer>
+
+#include <gio-unix-2.0/gio/gunixmounts.h>
+
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+
+// getdents64 record, glibc only exposes it through readdir
+struct LinuxDirent64
+{
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+// large enough for a few thousand entries per syscall
+constexpr long kBufferSize = 64 * 1024;
+
+// the trash dir of a device is looked for again after this long
+constexpr qint64 kTrashTimeToLive = 5000;
+
+// attributes that can be filled from the dirent, statx and faccessat without gio
+const char *const kNativeAttributes[] = {
+    G_FILE_ATTRIBUTE_STANDARD_NAME,
+    G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME,
+    G_FILE_ATTRIBUTE_STANDARD_EDIT_NAME,
+    G_FILE_ATTRIBUTE_STANDARD_COPY_NAME,
+    G_FILE_ATTRIBUTE_STANDARD_SYMLINK_TARGET,
+    G_FILE_ATTRIBUTE_STANDARD_TYPE,
+    G_FILE_ATTRIBUTE_STANDARD_IS_SYMLINK,
+    G_FILE_ATTRIBUTE_STANDARD_IS_HIDDEN,
+    G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP,
+    G_FILE_ATTRIBUTE_STANDARD_SIZE,
+    G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE,
+    G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE,
+    G_FILE_ATTRIBUTE_ETAG_VALUE,
+    G_FILE_ATTRIBUTE_ID_FILE,
+    G_FILE_ATTRIBUTE_ID_FILESYSTEM,
+    G_FILE_ATTRIBUTE_ACCESS_CAN_READ,
+    G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE,
+    G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE,
+    G_FILE_ATTRIBUTE_ACCESS_CAN_DELETE,
+    G_FILE_ATTRIBUTE_ACCESS_CAN_TRASH,
+    G_FILE_ATTRIBUTE_ACCESS_CAN_RENAME,
+    G_FILE_ATTRIBUTE_TIME_MODIFIED,
+    G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC,
+    G_FILE_ATTRIBUTE_TIME_ACCESS,
+    G_FILE_ATTRIBUTE_TIME_ACCESS_USEC,
+    G_FILE_ATTRIBUTE_TIME_CHANGED,
+    G_FILE_ATTRIBUTE_TIME_CHANGED_USEC,
+    G_FILE_ATTRIBUTE_TIME_CREATED,
+    G_FILE_ATTRIBUTE_TIME_CREATED_USEC,
+    G_FILE_ATTRIBUTE_UNIX_DEVICE,
+    G_FILE_ATTRIBUTE_UNIX_INODE,
+    G_FILE_ATTRIBUTE_UNIX_MODE,
+    G_FILE_ATTRIBUTE_UNIX_NLINK,
+    G_FILE_ATTRIBUTE_UNIX_UID,
+    G_FILE_ATTRIBUTE_UNIX_GID,
+    G_FILE_ATTRIBUTE_UNIX_RDEV,
+    G_FILE_ATTRIBUTE_UNIX_BLOCK_SIZE,
+    G_FILE_ATTRIBUTE_UNIX_BLOCKS,
+    G_FILE_ATTRIBUTE_UNIX_IS_MOUNTPOINT,
+};
+
+// namespaces of which every attribute above is filled
+const char *const kNativeNamespaces[] = {
+    "etag::*",
+    "id::*",
+    "access::*",
+    "time::*",
+    "unix::*",
+};
+
+// never set by the gio local backend, asking for them costs nothing
+const char *const kNeverLocalAttributes[] = {
+    G_FILE_ATTRIBUTE_STANDARD_IS_VIRTUAL,
+    G_FILE_ATTRIBUTE_STANDARD_IS_VOLATILE,
+    G_FILE_ATTRIBUTE_STANDARD_TARGET_URI,
+    G_FILE_ATTRIBUTE_STANDARD_SORT_ORDER,
+    "mountable::*",
+    "dos::*",
+    "preview::*",
+    "gvfs::*",
+    "trash::*",
+    "recent::*",
+};
+
+template<size_t N>
+bool listed(const char *const (&list)[N], const QByteArray &key)
+{
+    for (const char *item : list) {
+        if (key == item)
+            return true;
+    }
+    return false;
+}
+
+struct TrashDir
+{
+    bool exists { false };
+    QElapsedTimer age;
+};
+
+// whether files of the device can be trashed, the way the gio local backend tells it:
+// the home trash, the shared .Trash of the mount or a .Trash-uid that is or can be made
+bool hasTrashDir(const QByteArray &dirPath, dev_t dev)
+{
+    static const dev_t homeDev = [] {
+        struct stat st;
+        return stat(g_get_home_dir(), &st) == 0 ? st.st_dev : dev_t(0);
+    }();
+    if (dev == homeDev)
+        return true;
+
+    static QMutex mutex;
+    static QHash<quint64, TrashDir> trashDirs;
+    {
+        QMutexLocker locker(&mutex);
+        auto it = trashDirs.constFind(dev);
+        if (it != trashDirs.constEnd() && !it->age.hasExpired(kTrashTimeToLive))
+            return it->exists;
+    }
+
+    bool exists = false;
+    g_autoptr(GUnixMountEntry) mount = g_unix_mount_for(dirPath.constData(), nullptr);
+    if (mount && !g_unix_mount_is_system_internal(mount)) {
+        const QByteArray topDir(g_unix_mount_get_mount_path(mount));
+        const uid_t uid = geteuid();
+        struct stat st;
+        if (lstat(QByteArray(topDir + "/.Trash").constData(), &st) == 0 && S_ISDIR(st.st_mode) && (st.st_mode & S_ISVTX)) {
+            exists = true;
+        } else if (lstat(QByteArray(topDir + "/.Trash-" + QByteArray::number(uid)).constData(), &st) == 0) {
+            exists = S_ISDIR(st.st_mode) && st.st_uid == uid;
+        } else {
+            exists = errno == ENOENT && ::access(topDir.constData(), W_OK) == 0;
+        }
+    }
+
+    QMutexLocker locker(&mutex);
+    TrashDir &trashDir = trashDirs[dev];
+    trashDir.exists = exists;
+    trashDir.age.start();
+    return exists;
+}
+
+bool isDotOrDotDot(const char *name)
+{
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+}   // namespace
+
+DLocalEnumerator::DLocalEnumerator(const QString &path)
+    : dirPath(path)
+{
+}
+
+DLocalEnumerator::~DLocalEnumerator()
+{
+    if (dirFd >= 0)
+        ::close(dirFd);
+}
+
+bool DLocalEnumerator::open()
+{
+    dirFd = ::open(dirPath.toLocal8Bit().constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) {
+        err = errno;
+        return false;
+    }
+
+    buffer.reset(new char[kBufferSize]);
+    return true;
+}
+
+bool DLocalEnumerator::next(DLocalEnumerator::Entry *entry, bool followSymlinks)
+{
+    if (dirFd < 0 || !entry)
+        return false;
+
+    while (true) {
+        if (bufferPos >= bufferSize) {
+            if (eof)
+                return false;
+
+            const long ret = syscall(SYS_getdents64, dirFd, buffer.get(), kBufferSize);
+            if (ret < 0) {
+                if (errno == EINTR)
+                    continue;
+                err = errno;
+                return false;
+            }
+            if (ret == 0) {
+                eof = true;
+                return false;
+            }
+            bufferSize = ret;
+            bufferPos = 0;
+        }
+
+        const LinuxDirent64 *dirent = reinterpret_cast<const LinuxDirent64 *>(buffer.get() + bufferPos);
+        bufferPos += dirent->d_reclen;
+
+        // gio never lists them either
+        if (isDotOrDotDot(dirent->d_name))
+            continue;
+
+        entry->name = dirent->d_name;
+        entry->type = dirent->d_type;
+        entry->targetType = dirent->d_type;
+
+        // some filesystems do not fill d_type
+        struct stat st;
+        if (entry->type == DT_UNKNOWN && fstatat(dirFd, entry->name, &st, AT_SYMLINK_NOFOLLOW) == 0) {
+            entry->type = IFTODT(st.st_mode);
+            entry->targetType = entry->type;
+        }
+        // a broken symlink stays a symlink, as gio does
+        if (followSymlinks && entry->type == DT_LNK && fstatat(dirFd, entry->name, &st, 0) == 0)
+            entry->targetType = IFTODT(st.st_mode);
+
+        return true;
+    }
+}
+
+int DLocalEnumerator::fd() const
+{
+    return dirFd;
+}
+
+QString DLocalEnumerator::path() const
+{
+    return dirPath;
+}
+
+QString DLocalEnumerator::childPath(const char *name) const
+{
+    if (dirPath.endsWith('/'))
+        return dirPath + QString::fromLocal8Bit(name);
+    return dirPath + "/" + QString::fromLocal8Bit(name);
+}
+
+int DLocalEnumerator::lastErrno() const
+{
+    return err;
+}
+
+bool DLocalEnumerator::access(const DLocalEnumerator::Entry &entry, int mode) const
+{
+    return accessAt(dirFd, entry.name, mode);
+}
+
+GFileInfo *DLocalEnumerator::createFileInfo(const DLocalEnumerator::Entry &entry, GFileAttributeMatcher *matcher,
+                                            unsigned int mask, bool followSymlinks) const
+{
+    if (!dirAccess && needsParentAccess(matcher))
+        dirAccess.reset(new ParentAccess(parentAccess(dirPath.toLocal8Bit(), matcher)));
+    return createFileInfoAt(dirFd, entry.name, entry.name, entry.type, entry.targetType, matcher, mask, followSymlinks,
+                            dirAccess.get());
+}
+
+bool DLocalEnumerator::accessAt(int dirFd, const char *path, int mode)
+{
+    return faccessat(dirFd, path, mode, 0) == 0;
+}
+
+GFileInfo *DLocalEnumerator::createFileInfoAt(int dirFd, const char *path, const char *name, unsigned char type, unsigned char targetType,
+                                              GFileAttributeMatcher *matcher, unsigned int mask, bool followSymlinks,
+                                              const DLocalEnumerator::ParentAccess *parent)
+{
+    GFileInfo *info = g_file_info_new();
+
+    const bool isSymlink = type == DT_LNK;
+    const size_t nameLen = strlen(name);
+    g_file_info_set_name(info, name);
+    g_file_info_set_file_type(info, fileTypeFromDirent(followSymlinks ? targetType : type));
+    g_file_info_set_is_symlink(info, isSymlink);
+    g_file_info_set_is_hidden(info, name[0] == '.');
+    g_file_info_set_attribute_boolean(info, G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP, nameLen > 0 && name[nameLen - 1] == '~');
+
+    if (g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME)) {
+        g_autofree gchar *displayName = g_filename_display_name(name);
+        // the same mark the gio local backend puts on names it can't convert
+        if (strstr(displayName, "\357\277\275")) {
+            g_autofree gchar *marked = g_strconcat(displayName, g_dgettext("glib20", " (invalid encoding)"), nullptr);
+            g_file_info_set_display_name(info, marked);
+        } else {
+            g_file_info_set_display_name(info, displayName);
+        }
+    }
+    if (g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_STANDARD_EDIT_NAME)) {
+        g_autofree gchar *editName = g_filename_display_name(name);
+        g_file_info_set_edit_name(info, editName);
+    }
+    if (g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_STANDARD_COPY_NAME)) {
+        g_autofree gchar *copyName = g_filename_to_utf8(name, -1, nullptr, nullptr, nullptr);
+        if (copyName)
+            g_file_info_set_attribute_string(info, G_FILE_ATTRIBUTE_STANDARD_COPY_NAME, copyName);
+    }
+    if (isSymlink && g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_STANDARD_SYMLINK_TARGET)) {
+        char target[PATH_MAX];
+        const ssize_t len = readlinkat(dirFd, path, target, sizeof(target) - 1);
+        if (len >= 0) {
+            target[len] = '\0';
+            g_file_info_set_symlink_target(info, target);
+        }
+    }
+
+    qint64 size = -1;
+    bool hasOwner = false;
+    uid_t owner = 0;
+    if (mask != 0) {
+        struct statx stx;
+        const bool follow = followSymlinks && isSymlink;
+        bool hasStat = statx(dirFd, path, (follow ? 0 : AT_SYMLINK_NOFOLLOW) | AT_NO_AUTOMOUNT, mask, &stx) == 0;
+        if (!hasStat && follow)
+            hasStat = statx(dirFd, path, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &stx) == 0;
+
+        if (hasStat) {
+            if (stx.stx_mask & STATX_SIZE) {
+                size = static_cast<qint64>(stx.stx_size);
+                g_file_info_set_attribute_uint64(info, G_FILE_ATTRIBUTE_STANDARD_SIZE, stx.stx_size);
+            }
+            if (stx.stx_mask & STATX_BLOCKS) {
+                g_file_info_set_attribute_uint64(info, G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE, stx.stx_blocks * 512);
+                g_file_info_set_attribute_uint64(info, G_FILE_ATTRIBUTE_UNIX_BLOCKS, stx.stx_blocks);
+            }
+            if (stx.stx_mask & STATX_MTIME) {
+                g_file_info_set_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED, static_cast<guint64>(stx.stx_mtime.tv_sec));
+                g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC, stx.stx_mtime.tv_nsec / 1000);
+#ifdef G_FILE_ATTRIBUTE_TIME_MODIFIED_NSEC
+                g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_TIME_MODIFIED_NSEC, stx.stx_mtime.tv_nsec);
+#endif
+                // same format as the gio local backend
+                g_autofree gchar *etag = g_strdup_printf("%lu:%lu", static_cast<unsigned long>(stx.stx_mtime.tv_sec),
+                                                         static_cast<unsigned long>(stx.stx_mtime.tv_nsec / 1000));
+                g_file_info_set_attribute_string(info, G_FILE_ATTRIBUTE_ETAG_VALUE, etag);
+            }
+            if (stx.stx_mask & STATX_ATIME) {
+                g_file_info_set_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_ACCESS, static_cast<guint64>(stx.stx_atime.tv_sec));
+                g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_TIME_ACCESS_USEC, stx.stx_atime.tv_nsec / 1000);
+#ifdef G_FILE_ATTRIBUTE_TIME_ACCESS_NSEC
+                g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_TIME_ACCESS_NSEC, stx.stx_atime.tv_nsec);
+#endif
+            }
+            if (stx.stx_mask & STATX_CTIME) {
+                g_file_info_set_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_CHANGED, static_cast<guint64>(stx.stx_ctime.tv_sec));
+                g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_TIME_CHANGED_USEC, stx.stx_ctime.tv_nsec / 1000);
+#ifdef G_FILE_ATTRIBUTE_TIME_CHANGED_NSEC
+                g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_TIME_CHANGED_NSEC, stx.stx_ctime.tv_nsec);
+#endif
+            }
+            if (stx.stx_mask & STATX_BTIME) {
+                g_file_info_set_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_CREATED, static_cast<guint64>(stx.stx_btime.tv_sec));
+                g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_TIME_CREATED_USEC, stx.stx_btime.tv_nsec / 1000);
+#ifdef G_FILE_ATTRIBUTE_TIME_CREATED_NSEC
+                g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_TIME_CREATED_NSEC, stx.stx_btime.tv_nsec);
+#endif
+            }
+
+            const dev_t dev = makedev(stx.stx_dev_major, stx.stx_dev_minor);
+            g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_UNIX_DEVICE, static_cast<guint32>(dev));
+            g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_UNIX_RDEV,
+                                             static_cast<guint32>(makedev(stx.stx_rdev_major, stx.stx_rdev_minor)));
+            g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_UNIX_BLOCK_SIZE, stx.stx_blksize);
+            if (parent && parent->device != 0)
+                g_file_info_set_attribute_boolean(info, G_FILE_ATTRIBUTE_UNIX_IS_MOUNTPOINT, dev != parent->device);
+            if (g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_ID_FILESYSTEM))
+                g_file_info_set_attribute_string(info, G_FILE_ATTRIBUTE_ID_FILESYSTEM, DFileSystemCache::localKey(dev).constData());
+            if (stx.stx_mask & STATX_INO) {
+                g_file_info_set_attribute_uint64(info, G_FILE_ATTRIBUTE_UNIX_INODE, stx.stx_ino);
+                // same format as the gio local backend
+                g_autofree gchar *id = g_strdup_printf("l%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT,
+                                                       static_cast<guint64>(dev), static_cast<guint64>(stx.stx_ino));
+                g_file_info_set_attribute_string(info, G_FILE_ATTRIBUTE_ID_FILE, id);
+            }
+            if (stx.stx_mask & STATX_MODE)
+                g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_UNIX_MODE, stx.stx_mode);
+            if (stx.stx_mask & STATX_NLINK)
+                g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_UNIX_NLINK, stx.stx_nlink);
+            if (stx.stx_mask & STATX_UID) {
+                hasOwner = true;
+                owner = stx.stx_uid;
+                g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_UNIX_UID, stx.stx_uid);
+            }
+            if (stx.stx_mask & STATX_GID)
+                g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_UNIX_GID, stx.stx_gid);
+        }
+    }
+
+    if (g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE)) {
+        const QByteArray &contentType = fastContentType(name, followSymlinks ? targetType : type, size);
+        g_file_info_set_attribute_string(info, G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE, contentType.constData());
+    }
+    if (g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_ACCESS_CAN_READ))
+        g_file_info_set_attribute_boolean(info, G_FILE_ATTRIBUTE_ACCESS_CAN_READ, accessAt(dirFd, path, R_OK));
+    if (g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE))
+        g_file_info_set_attribute_boolean(info, G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE, accessAt(dirFd, path, W_OK));
+    if (g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE))
+        g_file_info_set_attribute_boolean(info, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE, accessAt(dirFd, path, X_OK));
+
+    if (parent) {
+        // in a sticky dir only the owners of the file or the dir and root may remove it
+        bool removable = parent->writable;
+        if (removable && parent->sticky) {
+            const uid_t uid = geteuid();
+            removable = uid == 0 || uid == parent->owner || (hasOwner && uid == owner);
+        }
+        if (g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_ACCESS_CAN_DELETE))
+            g_file_info_set_attribute_boolean(info, G_FILE_ATTRIBUTE_ACCESS_CAN_DELETE, removable);
+        if (g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_ACCESS_CAN_RENAME))
+            g_file_info_set_attribute_boolean(info, G_FILE_ATTRIBUTE_ACCESS_CAN_RENAME, removable);
+        if (g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_ACCESS_CAN_TRASH))
+            g_file_info_set_attribute_boolean(info, G_FILE_ATTRIBUTE_ACCESS_CAN_TRASH, removable && parent->hasTrash);
+    }
+
+    return info;
+}
+
+bool DLocalEnumerator::needsParentAccess(GFileAttributeMatcher *matcher)
+{
+    return g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_ACCESS_CAN_DELETE)
+            || g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_ACCESS_CAN_TRASH)
+            || g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_ACCESS_CAN_RENAME)
+            || g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_UNIX_IS_MOUNTPOINT);
+}
+
+DLocalEnumerator::ParentAccess DLocalEnumerator::parentAccess(const QByteArray &dirPath, GFileAttributeMatcher *matcher)
+{
+    ParentAccess access;
+    struct stat st;
+    if (stat(dirPath.constData(), &st) != 0)
+        return access;
+
+    access.device = st.st_dev;
+    access.owner = st.st_uid;
+    access.sticky = st.st_mode & S_ISVTX;
+    access.writable = ::access(dirPath.constData(), W_OK) == 0;
+    if (access.writable && g_file_attribute_matcher_matches(matcher, G_FILE_ATTRIBUTE_ACCESS_CAN_TRASH))
+        access.hasTrash = hasTrashDir(dirPath, st.st_dev);
+    return access;
+}
+
+bool DLocalEnumerator::canQueryNatively(const char *attributes)
+{
+    if (!attributes)
+        return false;
+
+    const QList<QByteArray> &keys = QByteArray(attributes).split(',');
+    for (const QByteArray &key : keys) {
+        if (!listed(kNativeAttributes, key) && !listed(kNativeNamespaces, key) && !listed(kNeverLocalAttributes, key))
+            return false;
+    }
+    return true;
+}
+
+unsigned int DLocalEnumerator::statxMask(GFileAttributeMatcher *matcher)
+{
+    auto matches = [matcher](const char *key) {
+        return g_file_attribute_matcher_matches(matcher, key);
+    };
+
+    unsigned int mask = 0;
+    // empty files have a type of their own
+    if (matches(G_FILE_ATTRIBUTE_STANDARD_SIZE) || matches(G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE))
+        mask |= STATX_SIZE;
+    if (matches(G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE) || matches(G_FILE_ATTRIBUTE_UNIX_BLOCKS))
+        mask |= STATX_BLOCKS;
+    if (matches(G_FILE_ATTRIBUTE_TIME_MODIFIED) || matches(G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC) || matches(G_FILE_ATTRIBUTE_ETAG_VALUE))
+        mask |= STATX_MTIME;
+    if (matches(G_FILE_ATTRIBUTE_TIME_ACCESS) || matches(G_FILE_ATTRIBUTE_TIME_ACCESS_USEC))
+        mask |= STATX_ATIME;
+    if (matches(G_FILE_ATTRIBUTE_TIME_CHANGED) || matches(G_FILE_ATTRIBUTE_TIME_CHANGED_USEC))
+        mask |= STATX_CTIME;
+    if (matches(G_FILE_ATTRIBUTE_TIME_CREATED) || matches(G_FILE_ATTRIBUTE_TIME_CREATED_USEC))
+        mask |= STATX_BTIME;
+    if (matches(G_FILE_ATTRIBUTE_UNIX_INODE) || matches(G_FILE_ATTRIBUTE_ID_FILE))
+        mask |= STATX_INO;
+    if (matches(G_FILE_ATTRIBUTE_UNIX_MODE))
+        mask |= STATX_TYPE | STATX_MODE;
+    if (matches(G_FILE_ATTRIBUTE_UNIX_NLINK))
+        mask |= STATX_NLINK;
+    // the owner decides the removal rights in a sticky dir
+    if (matches(G_FILE_ATTRIBUTE_UNIX_UID) || matches(G_FILE_ATTRIBUTE_ACCESS_CAN_DELETE)
+        || matches(G_FILE_ATTRIBUTE_ACCESS_CAN_TRASH) || matches(G_FILE_ATTRIBUTE_ACCESS_CAN_RENAME))
+        mask |= STATX_UID;
+    if (matches(G_FILE_ATTRIBUTE_UNIX_GID))
+        mask |= STATX_GID;
+    // device, rdev and block size are always filled, any bit will do
+    if (matches(G_FILE_ATTRIBUTE_UNIX_DEVICE) || matches(G_FILE_ATTRIBUTE_UNIX_RDEV) || matches(G_FILE_ATTRIBUTE_UNIX_BLOCK_SIZE)
+        || matches(G_FILE_ATTRIBUTE_ID_FILESYSTEM) || matches(G_FILE_ATTRIBUTE_UNIX_IS_MOUNTPOINT))
+        mask |= STATX_TYPE;
+
+    return mask;
+}
+
+GFileType DLocalEnumerator::fileTypeFromDirent(unsigned char type)
+{
+    switch (type) {
+    case DT_REG:
+        return G_FILE_TYPE_REGULAR;
+    case DT_DIR:
+        return G_FILE_TYPE_DIRECTORY;
+    case DT_LNK:
+        return G_FILE_TYPE_SYMBOLIC_LINK;
+    case DT_UNKNOWN:
+        return G_FILE_TYPE_UNKNOWN;
+    default:
+        return G_FILE_TYPE_SPECIAL;
+    }
+}
+
+QByteArray DLocalEnumerator::fastContentType(const char *name, unsigned char type, qint64 size)
+{
+    switch (type) {
+    case DT_DIR:
+        return "inode/directory";
+    case DT_LNK:
+        return "inode/symlink";
+    case DT_CHR:
+        return "inode/chardevice";
+    case DT_BLK:
+        return "inode/blockdevice";
+    case DT_FIFO:
+        return "inode/fifo";
+    case DT_SOCK:
+        return "inode/socket";
+    case DT_REG:
+        // not even guessed, files of /proc and /sys look empty
+        if (size == 0)
+            return "application/x-zerosize";
+        break;
+    default:
+        break;
+    }
+    g_autofree gchar *guess = g_content_type_guess(name, nullptr, 0, nullptr);
+    return QByteArray(guess);
+}
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DLOCALENUMERATOR_H
+#define DLOCALENUMERATOR_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QString>
+
+#include <gio/gio.h>
+
+#include <memory>
+
+#include <dirent.h>
+#include <sys/types.h>
+
+BEGIN_IO_NAMESPACE
+
+// reads a local directory with getdents64 instead of GFileEnumerator,
+// stat is only done for the entries and attributes that really need it
+class DLocalEnumerator
+{
+public:
+    struct Entry
+    {
+        const char *name { nullptr };   // points into the read buffer, valid until the next call of next()
+        unsigned char type { DT_UNKNOWN };   // own type, symlinks are DT_LNK
+        unsigned char targetType { DT_UNKNOWN };   // type of the symlink target when following symlinks, same as type otherwise
+    };
+
+    // what deleting, renaming and trashing an entry and telling a mount point
+    // depend on, the same for all the entries of one dir
+    struct ParentAccess
+    {
+        bool writable { false };
+        bool sticky { false };
+        bool hasTrash { false };
+        uid_t owner { 0 };
+        dev_t device { 0 };
+    };
+
+    explicit DLocalEnumerator(const QString &path);
+    ~DLocalEnumerator();
+
+    bool open();
+    bool next(Entry *entry, bool followSymlinks);
+    int fd() const;
+    QString path() const;
+    QString childPath(const char *name) const;
+    int lastErrno() const;
+
+    bool access(const Entry &entry, int mode) const;
+    GFileInfo *createFileInfo(const Entry &entry, GFileAttributeMatcher *matcher, unsigned int mask, bool followSymlinks) const;
+
+    static bool accessAt(int dirFd, const char *path, int mode);
+    // parent is only read for can-delete, can-rename, can-trash and unix::is-mountpoint
+    static GFileInfo *createFileInfoAt(int dirFd, const char *path, const char *name, unsigned char type, unsigned char targetType,
+                                       GFileAttributeMatcher *matcher, unsigned int mask, bool followSymlinks,
+                                       const ParentAccess *parent = nullptr);
+    static bool needsParentAccess(GFileAttributeMatcher *matcher);
+    static ParentAccess parentAccess(const QByteArray &dirPath, GFileAttributeMatcher *matcher);
+    static bool canQueryNatively(const char *attributes);
+    static unsigned int statxMask(GFileAttributeMatcher *matcher);
+    static GFileType fileTypeFromDirent(unsigned char type);
+    // the name only guess the gio local backend makes for standard::fast-content-type,
+    // size is -1 when it is not known
+    static QByteArray fastContentType(const char *name, unsigned char type, qint64 size);
+
+private:
+    Q_DISABLE_COPY(DLocalEnumerator)
+
+    QString dirPath;
+    int dirFd { -1 };
+    int err { 0 };
+    std::unique_ptr<char[]> buffer;
+    long bufferSize { 0 };
+    long bufferPos { 0 };
+    bool eof { false };
+    mutable std::unique_ptr<ParentAccess> dirAccess;   // read on first use
+};
+
+END_IO_NAMESPACE
+
+#endif   // DLOCALENUMERATOR_H
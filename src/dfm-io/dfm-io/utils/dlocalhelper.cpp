@@ -3,15 +3,20 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "dlocalhelper.h"
+#include "dhiddenlistcache.h"
 
 #include <dfm-io/dfileinfo.h>
 
 #include <QDebug>
 #include <QCollator>
 #include <QTime>
+#include <QMutex>
+#include <QHash>
 
 #include <gio/gfileinfo.h>
 
+#include <array>
+
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -125,133 +130,267 @@ static QString parentPath(const QString &path)
         return QString::fromLocal8Bit(gpath);
     return "";
 }
+
+// custom and self realized attributes are derived from other gio keys (or from the url only)
+static bool derivedAttributeKeys(DFileInfo::AttributeID id, const char **first, const char **second)
+{
+    *first = nullptr;
+    *second = nullptr;
+    switch (id) {
+    case DFileInfo::AttributeID::kStandardIsHidden:
+    case DFileInfo::AttributeID::kStandardFileName:
+        *first = G_FILE_ATTRIBUTE_STANDARD_NAME;
+        return true;
+    case DFileInfo::AttributeID::kStandardIsFile:
+    case DFileInfo::AttributeID::kStandardIsDir:
+        *first = G_FILE_ATTRIBUTE_STANDARD_TYPE;
+        return true;
+    case DFileInfo::AttributeID::kStandardSuffix:
+    case DFileInfo::AttributeID::kStandardCompleteSuffix:
+    case DFileInfo::AttributeID::kStandardBaseName:
+    case DFileInfo::AttributeID::kStandardCompleteBaseName:
+        *first = G_FILE_ATTRIBUTE_STANDARD_NAME;
+        *second = G_FILE_ATTRIBUTE_STANDARD_TYPE;
+        return true;
+    case DFileInfo::AttributeID::kStandardIsRoot:
+    case DFileInfo::AttributeID::kStandardFilePath:
+    case DFileInfo::AttributeID::kStandardParentPath:
+        return true;
+    // looked up per filesystem, the file only has to tell which one it is on
+    case DFileInfo::AttributeID::kFileSystemSize:
+    case DFileInfo::AttributeID::kFileSystemFree:
+    case DFileInfo::AttributeID::kFileSystemUsed:
+    case DFileInfo::AttributeID::kFileSystemType:
+    case DFileInfo::AttributeID::kFileSystemReadOnly:
+    case DFileInfo::AttributeID::kFileSystemUsePreview:
+    case DFileInfo::AttributeID::kFileSystemRemote:
+        *first = G_FILE_ATTRIBUTE_ID_FILESYSTEM;
+        return true;
+    // sniffed on first use, the listing only guesses from the name
+    case DFileInfo::AttributeID::kStandardContentType:
+    case DFileInfo::AttributeID::kStandardIcon:
+    case DFileInfo::AttributeID::kStandardSymbolicIcon:
+    case DFileInfo::AttributeID::kStandardDescription:
+        *first = G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE;
+        return true;
+    // names of the ids, looked up once per id
+    case DFileInfo::AttributeID::kOwnerUser:
+    case DFileInfo::AttributeID::kOwnerUserReal:
+        *first = G_FILE_ATTRIBUTE_UNIX_UID;
+        return true;
+    case DFileInfo::AttributeID::kOwnerGroup:
+        *first = G_FILE_ATTRIBUTE_UNIX_GID;
+        return true;
+    default:
+        return false;
+    }
+}
+
+// derived from other keys for local files only
+static bool isAskedFromBackend(DFileInfo::AttributeID id)
+{
+    switch (id) {
+    case DFileInfo::AttributeID::kStandardContentType:
+    case DFileInfo::AttributeID::kStandardIcon:
+    case DFileInfo::AttributeID::kStandardSymbolicIcon:
+    case DFileInfo::AttributeID::kStandardDescription:
+    case DFileInfo::AttributeID::kOwnerUser:
+    case DFileInfo::AttributeID::kOwnerUserReal:
+    case DFileInfo::AttributeID::kOwnerGroup:
+        return true;
+    default:
+        return false;
+    }
+}
 }   // LocalFunc
 
-DLocalHelper::AttributeInfoMap &DLocalHelper::attributeInfoMapFunc()
-{
-    static AttributeInfoMap kAttributeInfoMap {
-        { DFileInfo::AttributeID::kStandardType, std::make_tuple<std::string, QVariant>("standard::type", 0) },   // G_FILE_ATTRIBUTE_STANDARD_TYPE
-        { DFileInfo::AttributeID::kStandardIsHidden, std::make_tuple<std::string, QVariant>("standard::is-hidden", false) },   // G_FILE_ATTRIBUTE_STANDARD_IS_HIDDEN
-        { DFileInfo::AttributeID::kStandardIsBackup, std::make_tuple<std::string, QVariant>("standard::is-backup", false) },   // G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP
-        { DFileInfo::AttributeID::kStandardIsSymlink, std::make_tuple<std::string, QVariant>("standard::is-symlink", false) },   // G_FILE_ATTRIBUTE_STANDARD_IS_SYMLINK
-        { DFileInfo::AttributeID::kStandardIsVirtual, std::make_tuple<std::string, QVariant>("standard::is-virtual", false) },   // G_FILE_ATTRIBUTE_STANDARD_IS_VIRTUAL
-        { DFileInfo::AttributeID::kStandardIsVolatile, std::make_tuple<std::string, QVariant>("standard::is-volatile", false) },   // G_FILE_ATTRIBUTE_STANDARD_IS_VOLATILE
-        { DFileInfo::AttributeID::kStandardName, std::make_tuple<std::string, QVariant>("standard::name", "") },   // G_FILE_ATTRIBUTE_STANDARD_NAME
-        { DFileInfo::AttributeID::kStandardDisplayName, std::make_tuple<std::string, QVariant>("standard::display-name", "") },   // G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME
-        { DFileInfo::AttributeID::kStandardEditName, std::make_tuple<std::string, QVariant>("standard::edit-name", "") },   // G_FILE_ATTRIBUTE_STANDARD_EDIT_NAME
-        { DFileInfo::AttributeID::kStandardCopyName, std::make_tuple<std::string, QVariant>("standard::copy-name", "") },   // G_FILE_ATTRIBUTE_STANDARD_COPY_NAME
-        { DFileInfo::AttributeID::kStandardIcon, std::make_tuple<std::string, QVariant>("standard::icon", 0) },   // G_FILE_ATTRIBUTE_STANDARD_ICON
-        { DFileInfo::AttributeID::kStandardSymbolicIcon, std::make_tuple<std::string, QVariant>("standard::symbolic-icon", 0) },   // G_FILE_ATTRIBUTE_STANDARD_SYMBOLIC_ICON
-        { DFileInfo::AttributeID::kStandardContentType, std::make_tuple<std::string, QVariant>("standard::content-type", "") },   // G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE
-        { DFileInfo::AttributeID::kStandardFastContentType, std::make_tuple<std::string, QVariant>("standard::fast-content-type", "") },   // G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE
-        { DFileInfo::AttributeID::kStandardSize, std::make_tuple<std::string, QVariant>("standard::size", 0) },   // G_FILE_ATTRIBUTE_STANDARD_SIZE
-        { DFileInfo::AttributeID::kStandardAllocatedSize, std::make_tuple<std::string, QVariant>("standard::allocated-size", 0) },   // G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE
-        { DFileInfo::AttributeID::kStandardSymlinkTarget, std::make_tuple<std::string, QVariant>("standard::symlink-target", "") },   // G_FILE_ATTRIBUTE_STANDARD_SYMLINK_TARGET
-        { DFileInfo::AttributeID::kStandardTargetUri, std::make_tuple<std::string, QVariant>("standard::target-uri", "") },   // G_FILE_ATTRIBUTE_STANDARD_TARGET_URI
-        { DFileInfo::AttributeID::kStandardSortOrder, std::make_tuple<std::string, QVariant>("standard::sort-order", 0) },   // G_FILE_ATTRIBUTE_STANDARD_SORT_ORDER
-        { DFileInfo::AttributeID::kStandardDescription, std::make_tuple<std::string, QVariant>("standard::description", "") },   // G_FILE_ATTRIBUTE_STANDARD_DESCRIPTION
-
-        { DFileInfo::AttributeID::kEtagValue, std::make_tuple<std::string, QVariant>("etag::value", "") },   // G_FILE_ATTRIBUTE_ETAG_VALUE
-
-        { DFileInfo::AttributeID::kIdFile, std::make_tuple<std::string, QVariant>("id::file", "") },   // G_FILE_ATTRIBUTE_ID_FILE
-        { DFileInfo::AttributeID::kIdFilesystem, std::make_tuple<std::string, QVariant>("id::filesystem", "") },   // G_FILE_ATTRIBUTE_ID_FILESYSTEM
-
-        { DFileInfo::AttributeID::kAccessCanRead, std::make_tuple<std::string, QVariant>("access::can-read", true) },   // G_FILE_ATTRIBUTE_ACCESS_CAN_READ
-        { DFileInfo::AttributeID::kAccessCanWrite, std::make_tuple<std::string, QVariant>("access::can-write", true) },   // G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE
-        { DFileInfo::AttributeID::kAccessCanExecute, std::make_tuple<std::string, QVariant>("access::can-execute", true) },   // G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE
-        { DFileInfo::AttributeID::kAccessCanDelete, std::make_tuple<std::string, QVariant>("access::can-delete", true) },   // G_FILE_ATTRIBUTE_ACCESS_CAN_DELETE
-        { DFileInfo::AttributeID::kAccessCanTrash, std::make_tuple<std::string, QVariant>("access::can-trash", false) },   // G_FILE_ATTRIBUTE_ACCESS_CAN_TRASH
-        { DFileInfo::AttributeID::kAccessCanRename, std::make_tuple<std::string, QVariant>("access::can-rename", true) },   // G_FILE_ATTRIBUTE_ACCESS_CAN_RENAME
-
-        { DFileInfo::AttributeID::kMountableCanMount, std::make_tuple<std::string, QVariant>("mountable::can-mount", false) },   // G_FILE_ATTRIBUTE_MOUNTABLE_CAN_MOUNT
-        { DFileInfo::AttributeID::kMountableCanUnmount, std::make_tuple<std::string, QVariant>("mountable::can-unmount", false) },   // G_FILE_ATTRIBUTE_MOUNTABLE_CAN_UNMOUNT
-        { DFileInfo::AttributeID::kMountableCanEject, std::make_tuple<std::string, QVariant>("mountable::can-eject", false) },   // G_FILE_ATTRIBUTE_MOUNTABLE_CAN_EJECT
-        { DFileInfo::AttributeID::kMountableUnixDevice, std::make_tuple<std::string, QVariant>("mountable::unix-device", 0) },   // G_FILE_ATTRIBUTE_MOUNTABLE_UNIX_DEVICE
-        { DFileInfo::AttributeID::kMountableUnixDeviceFile, std::make_tuple<std::string, QVariant>("mountable::unix-device-file", "") },   // G_FILE_ATTRIBUTE_MOUNTABLE_UNIX_DEVICE_FILE
-        { DFileInfo::AttributeID::kMountableHalUdi, std::make_tuple<std::string, QVariant>("mountable::hal-udi", "") },   // G_FILE_ATTRIBUTE_MOUNTABLE_HAL_UDI
-        { DFileInfo::AttributeID::kMountableCanPoll, std::make_tuple<std::string, QVariant>("mountable::can-poll", false) },   // G_FILE_ATTRIBUTE_MOUNTABLE_CAN_POLL
-        { DFileInfo::AttributeID::kMountableIsMediaCheckAutomatic, std::make_tuple<std::string, QVariant>("mountable::is-media-check-automatic", false) },   // G_FILE_ATTRIBUTE_MOUNTABLE_IS_MEDIA_CHECK_AUTOMATIC
-        { DFileInfo::AttributeID::kMountableCanStart, std::make_tuple<std::string, QVariant>("mountable::can-start", false) },   // G_FILE_ATTRIBUTE_MOUNTABLE_CAN_START
-        { DFileInfo::AttributeID::kMountableCanStartDegraded, std::make_tuple<std::string, QVariant>("mountable::can-start-degraded", false) },   // G_FILE_ATTRIBUTE_MOUNTABLE_CAN_START_DEGRADED
-        { DFileInfo::AttributeID::kMountableCanStop, std::make_tuple<std::string, QVariant>("mountable::can-stop", false) },   // G_FILE_ATTRIBUTE_MOUNTABLE_CAN_STOP
-        { DFileInfo::AttributeID::kMountableStartStopType, std::make_tuple<std::string, QVariant>("mountable::start-stop-type", 0) },   // G_FILE_ATTRIBUTE_MOUNTABLE_START_STOP_TYPE
-
-        { DFileInfo::AttributeID::kTimeModified, std::make_tuple<std::string, QVariant>("time::modified", 0) },   // G_FILE_ATTRIBUTE_TIME_MODIFIED
-        { DFileInfo::AttributeID::kTimeModifiedUsec, std::make_tuple<std::string, QVariant>("time::modified-usec", 0) },   // G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC
-        { DFileInfo::AttributeID::kTimeAccess, std::make_tuple<std::string, QVariant>("time::access", 0) },   // G_FILE_ATTRIBUTE_TIME_ACCESS
-        { DFileInfo::AttributeID::kTimeAccessUsec, std::make_tuple<std::string, QVariant>("time::access-usec", 0) },   // G_FILE_ATTRIBUTE_TIME_ACCESS_USEC
-        { DFileInfo::AttributeID::kTimeChanged, std::make_tuple<std::string, QVariant>("time::changed", 0) },   // G_FILE_ATTRIBUTE_TIME_CHANGED
-        { DFileInfo::AttributeID::kTimeChangedUsec, std::make_tuple<std::string, QVariant>("time::changed-usec", 0) },   // G_FILE_ATTRIBUTE_TIME_CHANGED_USEC
-        { DFileInfo::AttributeID::kTimeCreated, std::make_tuple<std::string, QVariant>("time::created", 0) },   // G_FILE_ATTRIBUTE_TIME_CREATED
-        { DFileInfo::AttributeID::kTimeCreatedUsec, std::make_tuple<std::string, QVariant>("time::created-usec", 0) },   // G_FILE_ATTRIBUTE_TIME_CREATED_USEC
-
-        { DFileInfo::AttributeID::kUnixDevice, std::make_tuple<std::string, QVariant>("unix::device", 0) },   // G_FILE_ATTRIBUTE_UNIX_DEVICE
-        { DFileInfo::AttributeID::kUnixInode, std::make_tuple<std::string, QVariant>("unix::inode", 0) },   // G_FILE_ATTRIBUTE_UNIX_INODE
-        { DFileInfo::AttributeID::kUnixMode, std::make_tuple<std::string, QVariant>("unix::mode", 0) },   // G_FILE_ATTRIBUTE_UNIX_MODE
-        { DFileInfo::AttributeID::kUnixNlink, std::make_tuple<std::string, QVariant>("unix::nlink", 0) },   // G_FILE_ATTRIBUTE_UNIX_NLINK
-        { DFileInfo::AttributeID::kUnixUID, std::make_tuple<std::string, QVariant>("unix::uid", 0) },   // G_FILE_ATTRIBUTE_UNIX_UID
-        { DFileInfo::AttributeID::kUnixGID, std::make_tuple<std::string, QVariant>("unix::gid", 0) },   // G_FILE_ATTRIBUTE_UNIX_GID
-        { DFileInfo::AttributeID::kUnixRdev, std::make_tuple<std::string, QVariant>("unix::rdev", 0) },   // G_FILE_ATTRIBUTE_UNIX_RDEV
-        { DFileInfo::AttributeID::kUnixBlockSize, std::make_tuple<std::string, QVariant>("unix::block-size", 0) },   // G_FILE_ATTRIBUTE_UNIX_BLOCK_SIZE
-        { DFileInfo::AttributeID::kUnixBlocks, std::make_tuple<std::string, QVariant>("unix::blocks", 0) },   // G_FILE_ATTRIBUTE_UNIX_BLOCKS
-        { DFileInfo::AttributeID::kUnixIsMountPoint, std::make_tuple<std::string, QVariant>("unix::is-mountpoint", false) },   // G_FILE_ATTRIBUTE_UNIX_IS_MOUNTPOINT
-
-        { DFileInfo::AttributeID::kDosIsArchive, std::make_tuple<std::string, QVariant>("dos::is-archive", false) },   // G_FILE_ATTRIBUTE_DOS_IS_ARCHIVE
-        { DFileInfo::AttributeID::kDosIsSystem, std::make_tuple<std::string, QVariant>("dos::is-system", false) },   // G_FILE_ATTRIBUTE_DOS_IS_SYSTEM
-
-        { DFileInfo::AttributeID::kOwnerUser, std::make_tuple<std::string, QVariant>("owner::user", "") },   // G_FILE_ATTRIBUTE_OWNER_USER
-        { DFileInfo::AttributeID::kOwnerUserReal, std::make_tuple<std::string, QVariant>("owner::user-real", "") },   // G_FILE_ATTRIBUTE_OWNER_USER_REAL
-        { DFileInfo::AttributeID::kOwnerGroup, std::make_tuple<std::string, QVariant>("owner::group", "") },   // G_FILE_ATTRIBUTE_OWNER_GROUP
-
-        { DFileInfo::AttributeID::kThumbnailPath, std::make_tuple<std::string, QVariant>("thumbnail::path", "") },   // G_FILE_ATTRIBUTE_THUMBNAIL_PATH
-        { DFileInfo::AttributeID::kThumbnailFailed, std::make_tuple<std::string, QVariant>("thumbnail::failed", false) },   // G_FILE_ATTRIBUTE_THUMBNAILING_FAILED
-        { DFileInfo::AttributeID::kThumbnailIsValid, std::make_tuple<std::string, QVariant>("thumbnail::is-valid", false) },   // G_FILE_ATTRIBUTE_THUMBNAIL_IS_VALID
-
-        { DFileInfo::AttributeID::kPreviewIcon, std::make_tuple<std::string, QVariant>("preview::icon", 0) },   // G_FILE_ATTRIBUTE_PREVIEW_ICON
-
-        { DFileInfo::AttributeID::kFileSystemSize, std::make_tuple<std::string, QVariant>("filesystem::size", 0) },   // G_FILE_ATTRIBUTE_FILESYSTEM_SIZE
-        { DFileInfo::AttributeID::kFileSystemFree, std::make_tuple<std::string, QVariant>("filesystem::free", 0) },   // G_FILE_ATTRIBUTE_FILESYSTEM_FREE
-        { DFileInfo::AttributeID::kFileSystemUsed, std::make_tuple<std::string, QVariant>("filesystem::used", 0) },   // G_FILE_ATTRIBUTE_FILESYSTEM_USED
-        { DFileInfo::AttributeID::kFileSystemType, std::make_tuple<std::string, QVariant>("filesystem::type", "") },   // G_FILE_ATTRIBUTE_FILESYSTEM_TYPE
-        { DFileInfo::AttributeID::kFileSystemReadOnly, std::make_tuple<std::string, QVariant>("filesystem::readonly", false) },   // G_FILE_ATTRIBUTE_FILESYSTEM_READONLY
-        { DFileInfo::AttributeID::kFileSystemUsePreview, std::make_tuple<std::string, QVariant>("filesystem::use-preview", 0) },   // G_FILE_ATTRIBUTE_FILESYSTEM_USE_PREVIEW
-        { DFileInfo::AttributeID::kFileSystemRemote, std::make_tuple<std::string, QVariant>("filesystem::remote", false) },   // G_FILE_ATTRIBUTE_FILESYSTEM_REMOTE
-
-        { DFileInfo::AttributeID::kGvfsBackend, std::make_tuple<std::string, QVariant>("gvfs::backend", "") },   // G_FILE_ATTRIBUTE_GVFS_BACKEND
-
-        { DFileInfo::AttributeID::kSelinuxContext, std::make_tuple<std::string, QVariant>("selinux::context", "") },   // G_FILE_ATTRIBUTE_SELINUX_CONTEXT
-
-        { DFileInfo::AttributeID::kTrashItemCount, std::make_tuple<std::string, QVariant>("trash::item-count", 0) },   // G_FILE_ATTRIBUTE_TRASH_ITEM_COUNT
-        { DFileInfo::AttributeID::kTrashDeletionDate, std::make_tuple<std::string, QVariant>("trash::deletion-date", "") },   // G_FILE_ATTRIBUTE_TRASH_DELETION_DATE
-        { DFileInfo::AttributeID::kTrashOrigPath, std::make_tuple<std::string, QVariant>("trash::orig-path", "") },   // G_FILE_ATTRIBUTE_TRASH_ORIG_PATH
-
-        { DFileInfo::AttributeID::kRecentModified, std::make_tuple<std::string, QVariant>("recent::modified", 0) },   // G_FILE_ATTRIBUTE_RECENT_MODIFIED
-
-        { DFileInfo::AttributeID::kCustomStart, std::make_tuple<std::string, QVariant>("custom-start", 0) },
-
-        { DFileInfo::AttributeID::kStandardIsFile, std::make_tuple<std::string, QVariant>("standard::is-file", false) },
-        { DFileInfo::AttributeID::kStandardIsDir, std::make_tuple<std::string, QVariant>("standard::is-dir", false) },
-        { DFileInfo::AttributeID::kStandardIsRoot, std::make_tuple<std::string, QVariant>("standard::is-root", false) },
-        { DFileInfo::AttributeID::kStandardSuffix, std::make_tuple<std::string, QVariant>("standard::suffix", "") },
-        { DFileInfo::AttributeID::kStandardCompleteSuffix, std::make_tuple<std::string, QVariant>("standard::complete-suffix", "") },
-        { DFileInfo::AttributeID::kStandardFilePath, std::make_tuple<std::string, QVariant>("standard::file-path", "") },
-        { DFileInfo::AttributeID::kStandardParentPath, std::make_tuple<std::string, QVariant>("standard::parent-path", "") },
-        { DFileInfo::AttributeID::kStandardBaseName, std::make_tuple<std::string, QVariant>("standard::base-name", "") },
-        { DFileInfo::AttributeID::kStandardFileName, std::make_tuple<std::string, QVariant>("standard::file-name", "") },
-        { DFileInfo::AttributeID::kStandardCompleteBaseName, std::make_tuple<std::string, QVariant>("standard::complete-base-name", "") },
-    };
-    return kAttributeInfoMap;
+namespace AttributeTable {
+using AttributeInfo = DLocalHelper::AttributeInfo;
+constexpr int kNoIndex = -1;
+constexpr int kIdCount = static_cast<int>(DFileInfo::AttributeID::kAttributeIDMax) + 1;
+
+constexpr AttributeInfo kInfos[] {
+    { DFileInfo::AttributeID::kStandardType, "standard::type", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_STANDARD_TYPE
+    { DFileInfo::AttributeID::kStandardIsHidden, "standard::is-hidden", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_STANDARD_IS_HIDDEN
+    { DFileInfo::AttributeID::kStandardIsBackup, "standard::is-backup", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_STANDARD_IS_BACKUP
+    { DFileInfo::AttributeID::kStandardIsSymlink, "standard::is-symlink", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_STANDARD_IS_SYMLINK
+    { DFileInfo::AttributeID::kStandardIsVirtual, "standard::is-virtual", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_STANDARD_IS_VIRTUAL
+    { DFileInfo::AttributeID::kStandardIsVolatile, "standard::is-volatile", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_STANDARD_IS_VOLATILE
+    { DFileInfo::AttributeID::kStandardName, "standard::name", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_STANDARD_NAME
+    { DFileInfo::AttributeID::kStandardDisplayName, "standard::display-name", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME
+    { DFileInfo::AttributeID::kStandardEditName, "standard::edit-name", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_STANDARD_EDIT_NAME
+    { DFileInfo::AttributeID::kStandardCopyName, "standard::copy-name", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_STANDARD_COPY_NAME
+    { DFileInfo::AttributeID::kStandardIcon, "standard::icon", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_STANDARD_ICON
+    { DFileInfo::AttributeID::kStandardSymbolicIcon, "standard::symbolic-icon", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_STANDARD_SYMBOLIC_ICON
+    { DFileInfo::AttributeID::kStandardContentType, "standard::content-type", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_STANDARD_CONTENT_TYPE
+    { DFileInfo::AttributeID::kStandardFastContentType, "standard::fast-content-type", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE
+    { DFileInfo::AttributeID::kStandardSize, "standard::size", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_STANDARD_SIZE
+    { DFileInfo::AttributeID::kStandardAllocatedSize, "standard::allocated-size", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_STANDARD_ALLOCATED_SIZE
+    { DFileInfo::AttributeID::kStandardSymlinkTarget, "standard::symlink-target", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_STANDARD_SYMLINK_TARGET
+    { DFileInfo::AttributeID::kStandardTargetUri, "standard::target-uri", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_STANDARD_TARGET_URI
+    { DFileInfo::AttributeID::kStandardSortOrder, "standard::sort-order", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_STANDARD_SORT_ORDER
+    { DFileInfo::AttributeID::kStandardDescription, "standard::description", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_STANDARD_DESCRIPTION
+
+    { DFileInfo::AttributeID::kEtagValue, "etag::value", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_ETAG_VALUE
+
+    { DFileInfo::AttributeID::kIdFile, "id::file", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_ID_FILE
+    { DFileInfo::AttributeID::kIdFilesystem, "id::filesystem", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_ID_FILESYSTEM
+
+    { DFileInfo::AttributeID::kAccessCanRead, "access::can-read", AttributeInfo::Type::kBool, 1 },   // G_FILE_ATTRIBUTE_ACCESS_CAN_READ
+    { DFileInfo::AttributeID::kAccessCanWrite, "access::can-write", AttributeInfo::Type::kBool, 1 },   // G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE
+    { DFileInfo::AttributeID::kAccessCanExecute, "access::can-execute", AttributeInfo::Type::kBool, 1 },   // G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE
+    { DFileInfo::AttributeID::kAccessCanDelete, "access::can-delete", AttributeInfo::Type::kBool, 1 },   // G_FILE_ATTRIBUTE_ACCESS_CAN_DELETE
+    { DFileInfo::AttributeID::kAccessCanTrash, "access::can-trash", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_ACCESS_CAN_TRASH
+    { DFileInfo::AttributeID::kAccessCanRename, "access::can-rename", AttributeInfo::Type::kBool, 1 },   // G_FILE_ATTRIBUTE_ACCESS_CAN_RENAME
+
+    { DFileInfo::AttributeID::kMountableCanMount, "mountable::can-mount", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_MOUNTABLE_CAN_MOUNT
+    { DFileInfo::AttributeID::kMountableCanUnmount, "mountable::can-unmount", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_MOUNTABLE_CAN_UNMOUNT
+    { DFileInfo::AttributeID::kMountableCanEject, "mountable::can-eject", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_MOUNTABLE_CAN_EJECT
+    { DFileInfo::AttributeID::kMountableUnixDevice, "mountable::unix-device", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_MOUNTABLE_UNIX_DEVICE
+    { DFileInfo::AttributeID::kMountableUnixDeviceFile, "mountable::unix-device-file", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_MOUNTABLE_UNIX_DEVICE_FILE
+    { DFileInfo::AttributeID::kMountableHalUdi, "mountable::hal-udi", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_MOUNTABLE_HAL_UDI
+    { DFileInfo::AttributeID::kMountableCanPoll, "mountable::can-poll", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_MOUNTABLE_CAN_POLL
+    { DFileInfo::AttributeID::kMountableIsMediaCheckAutomatic, "mountable::is-media-check-automatic", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_MOUNTABLE_IS_MEDIA_CHECK_AUTOMATIC
+    { DFileInfo::AttributeID::kMountableCanStart, "mountable::can-start", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_MOUNTABLE_CAN_START
+    { DFileInfo::AttributeID::kMountableCanStartDegraded, "mountable::can-start-degraded", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_MOUNTABLE_CAN_START_DEGRADED
+    { DFileInfo::AttributeID::kMountableCanStop, "mountable::can-stop", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_MOUNTABLE_CAN_STOP
+    { DFileInfo::AttributeID::kMountableStartStopType, "mountable::start-stop-type", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_MOUNTABLE_START_STOP_TYPE
+
+    { DFileInfo::AttributeID::kTimeModified, "time::modified", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_TIME_MODIFIED
+    { DFileInfo::AttributeID::kTimeModifiedUsec, "time::modified-usec", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC
+    { DFileInfo::AttributeID::kTimeAccess, "time::access", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_TIME_ACCESS
+    { DFileInfo::AttributeID::kTimeAccessUsec, "time::access-usec", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_TIME_ACCESS_USEC
+    { DFileInfo::AttributeID::kTimeChanged, "time::changed", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_TIME_CHANGED
+    { DFileInfo::AttributeID::kTimeChangedUsec, "time::changed-usec", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_TIME_CHANGED_USEC
+    { DFileInfo::AttributeID::kTimeCreated, "time::created", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_TIME_CREATED
+    { DFileInfo::AttributeID::kTimeCreatedUsec, "time::created-usec", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_TIME_CREATED_USEC
+
+    { DFileInfo::AttributeID::kUnixDevice, "unix::device", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_UNIX_DEVICE
+    { DFileInfo::AttributeID::kUnixInode, "unix::inode", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_UNIX_INODE
+    { DFileInfo::AttributeID::kUnixMode, "unix::mode", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_UNIX_MODE
+    { DFileInfo::AttributeID::kUnixNlink, "unix::nlink", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_UNIX_NLINK
+    { DFileInfo::AttributeID::kUnixUID, "unix::uid", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_UNIX_UID
+    { DFileInfo::AttributeID::kUnixGID, "unix::gid", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_UNIX_GID
+    { DFileInfo::AttributeID::kUnixRdev, "unix::rdev", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_UNIX_RDEV
+    { DFileInfo::AttributeID::kUnixBlockSize, "unix::block-size", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_UNIX_BLOCK_SIZE
+    { DFileInfo::AttributeID::kUnixBlocks, "unix::blocks", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_UNIX_BLOCKS
+    { DFileInfo::AttributeID::kUnixIsMountPoint, "unix::is-mountpoint", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_UNIX_IS_MOUNTPOINT
+
+    { DFileInfo::AttributeID::kDosIsArchive, "dos::is-archive", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_DOS_IS_ARCHIVE
+    { DFileInfo::AttributeID::kDosIsSystem, "dos::is-system", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_DOS_IS_SYSTEM
+
+    { DFileInfo::AttributeID::kOwnerUser, "owner::user", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_OWNER_USER
+    { DFileInfo::AttributeID::kOwnerUserReal, "owner::user-real", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_OWNER_USER_REAL
+    { DFileInfo::AttributeID::kOwnerGroup, "owner::group", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_OWNER_GROUP
+
+    { DFileInfo::AttributeID::kThumbnailPath, "thumbnail::path", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_THUMBNAIL_PATH
+    { DFileInfo::AttributeID::kThumbnailFailed, "thumbnail::failed", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_THUMBNAILING_FAILED
+    { DFileInfo::AttributeID::kThumbnailIsValid, "thumbnail::is-valid", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_THUMBNAIL_IS_VALID
+
+    { DFileInfo::AttributeID::kPreviewIcon, "preview::icon", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_PREVIEW_ICON
+
+    { DFileInfo::AttributeID::kFileSystemSize, "filesystem::size", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_FILESYSTEM_SIZE
+    { DFileInfo::AttributeID::kFileSystemFree, "filesystem::free", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_FILESYSTEM_FREE
+    { DFileInfo::AttributeID::kFileSystemUsed, "filesystem::used", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_FILESYSTEM_USED
+    { DFileInfo::AttributeID::kFileSystemType, "filesystem::type", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_FILESYSTEM_TYPE
+    { DFileInfo::AttributeID::kFileSystemReadOnly, "filesystem::readonly", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_FILESYSTEM_READONLY
+    { DFileInfo::AttributeID::kFileSystemUsePreview, "filesystem::use-preview", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_FILESYSTEM_USE_PREVIEW
+    { DFileInfo::AttributeID::kFileSystemRemote, "filesystem::remote", AttributeInfo::Type::kBool, 0 },   // G_FILE_ATTRIBUTE_FILESYSTEM_REMOTE
+
+    { DFileInfo::AttributeID::kGvfsBackend, "gvfs::backend", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_GVFS_BACKEND
+
+    { DFileInfo::AttributeID::kSelinuxContext, "selinux::context", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_SELINUX_CONTEXT
+
+    { DFileInfo::AttributeID::kTrashItemCount, "trash::item-count", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_TRASH_ITEM_COUNT
+    { DFileInfo::AttributeID::kTrashDeletionDate, "trash::deletion-date", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_TRASH_DELETION_DATE
+    { DFileInfo::AttributeID::kTrashOrigPath, "trash::orig-path", AttributeInfo::Type::kString, 0 },   // G_FILE_ATTRIBUTE_TRASH_ORIG_PATH
+
+    { DFileInfo::AttributeID::kRecentModified, "recent::modified", AttributeInfo::Type::kInt, 0 },   // G_FILE_ATTRIBUTE_RECENT_MODIFIED
+
+    { DFileInfo::AttributeID::kCustomStart, "custom-start", AttributeInfo::Type::kInt, 0 },
+
+    { DFileInfo::AttributeID::kStandardIsFile, "standard::is-file", AttributeInfo::Type::kBool, 0 },
+    { DFileInfo::AttributeID::kStandardIsDir, "standard::is-dir", AttributeInfo::Type::kBool, 0 },
+    { DFileInfo::AttributeID::kStandardIsRoot, "standard::is-root", AttributeInfo::Type::kBool, 0 },
+    { DFileInfo::AttributeID::kStandardSuffix, "standard::suffix", AttributeInfo::Type::kString, 0 },
+    { DFileInfo::AttributeID::kStandardCompleteSuffix, "standard::complete-suffix", AttributeInfo::Type::kString, 0 },
+    { DFileInfo::AttributeID::kStandardFilePath, "standard::file-path", AttributeInfo::Type::kString, 0 },
+    { DFileInfo::AttributeID::kStandardParentPath, "standard::parent-path", AttributeInfo::Type::kString, 0 },
+    { DFileInfo::AttributeID::kStandardBaseName, "standard::base-name", AttributeInfo::Type::kString, 0 },
+    { DFileInfo::AttributeID::kStandardFileName, "standard::file-name", AttributeInfo::Type::kString, 0 },
+    { DFileInfo::AttributeID::kStandardCompleteBaseName, "standard::complete-base-name", AttributeInfo::Type::kString, 0 },
+};
+constexpr int kInfoCount = static_cast<int>(sizeof(kInfos) / sizeof(kInfos[0]));
+
+// id to row, built by the compiler so a lookup is one load
+constexpr std::array<qint16, kIdCount> buildIndex()
+{
+    std::array<qint16, kIdCount> index {};
+    for (int i = 0; i < kIdCount; ++i)
+        index[i] = kNoIndex;
+    for (int i = 0; i < kInfoCount; ++i)
+        index[static_cast<int>(kInfos[i].id)] = static_cast<qint16>(i);
+    return index;
+}
+constexpr std::array<qint16, kIdCount> kIndex = buildIndex();
+
+constexpr int rowOf(DFileInfo::AttributeID id)
+{
+    const int value = static_cast<int>(id);
+    return value >= 0 && value < kIdCount ? kIndex[value] : kNoIndex;
+}
+
+static_assert(rowOf(DFileInfo::AttributeID::kStandardType) == 0, "attribute table starts with standard::type");
+static_assert(rowOf(DFileInfo::AttributeID::kAccessPermissions) == kNoIndex, "permissions are derived, they have no gio key");
+}   // AttributeTable
+
+const DLocalHelper::AttributeInfo *DLocalHelper::attributeInfo(DFileInfo::AttributeID id)
+{
+    const int row = AttributeTable::rowOf(id);
+    return row == AttributeTable::kNoIndex ? nullptr : &AttributeTable::kInfos[row];
+}
+
+DLocalHelper::AttributeInfoList DLocalHelper::attributeInfos()
+{
+    return { AttributeTable::kInfos, AttributeTable::kInfos + AttributeTable::kInfoCount };
+}
+
+QVariant DLocalHelper::attributeDefault(DFileInfo::AttributeID id)
+{
+    // built once, handing out a copy only bumps a reference
+    static const std::array<QVariant, AttributeTable::kInfoCount> kDefaults = [] {
+        std::array<QVariant, AttributeTable::kInfoCount> defaults;
+        for (int i = 0; i < AttributeTable::kInfoCount; ++i) {
+            const AttributeInfo &info = AttributeTable::kInfos[i];
+            switch (info.type) {
+            case AttributeInfo::Type::kInt:
+                defaults[i] = info.defaultValue;
+                break;
+            case AttributeInfo::Type::kBool:
+                defaults[i] = info.defaultValue != 0;
+                break;
+            case AttributeInfo::Type::kString:
+                defaults[i] = QString("");
+                break;
+            }
+        }
+        return defaults;
+    }();
+
+    const int row = AttributeTable::rowOf(id);
+    return row == AttributeTable::kNoIndex ? QVariant() : kDefaults[row];
 }
 
 QSharedPointer<DFileInfo> DLocalHelper::createFileInfoByUri(const QUrl &uri, const char *attributes /*= "*"*/,
                                                             const DFMIO::DFileInfo::FileQueryInfoFlags flag /*= DFMIO::DFileInfo::FileQueryInfoFlags::TypeNone*/)
 {
-    return QSharedPointer<DFileInfo>(new DFileInfo(uri, attributes, flag));
+    // the info and the reference count in one block
+    return QSharedPointer<DFileInfo>::create(uri, attributes, flag);
 }
 
 QSharedPointer<DFileInfo> DLocalHelper::createFileInfoByUri(const QUrl &uri, GFileInfo *gfileInfo, const char *attributes, const DFileInfo::FileQueryInfoFlags flag)
 {
-    return QSharedPointer<DFileInfo>(new DFileInfo(uri, gfileInfo, attributes, flag));
+    return QSharedPointer<DFileInfo>::create(uri, static_cast<void *>(gfileInfo), attributes, flag);
 }
 
 QVariant DLocalHelper::attributeFromGFileInfo(GFileInfo *gfileinfo, DFileInfo::AttributeID id, DFMIOErrorCode &errorcode)
@@ -265,8 +404,8 @@ QVariant DLocalHelper::attributeFromGFileInfo(GFileInfo *gfileinfo, DFileInfo::A
     }
 
     // check has attribute
-    const std::string &key = DLocalHelper::attributeStringById(id);
-    bool hasAttr = g_file_info_has_attribute(gfileinfo, key.c_str());
+    const char *key = DLocalHelper::attributeStringById(id);
+    bool hasAttr = g_file_info_has_attribute(gfileinfo, key);
     if (!hasAttr) {
         // if has not attribute, return QVariant(), and caller use default value
         errorcode = DFM_IO_ERROR_INFO_NO_ATTRIBUTE;
@@ -290,12 +429,12 @@ QVariant DLocalHelper::attributeFromGFileInfo(GFileInfo *gfileinfo, DFileInfo::A
     case DFileInfo::AttributeID::kUnixBlockSize:
     case DFileInfo::AttributeID::kFileSystemUsePreview:
     case DFileInfo::AttributeID::kTrashItemCount: {
-        uint32_t ret = g_file_info_get_attribute_uint32(gfileinfo, key.c_str());
+        uint32_t ret = g_file_info_get_attribute_uint32(gfileinfo, key);
         return QVariant(ret);
     }
     // int32_t
     case DFileInfo::AttributeID::kStandardSortOrder: {
-        int32_t ret = g_file_info_get_attribute_int32(gfileinfo, key.c_str());
+        int32_t ret = g_file_info_get_attribute_int32(gfileinfo, key);
         return QVariant(ret);
     }
     // uint64_t
@@ -309,11 +448,11 @@ QVariant DLocalHelper::attributeFromGFileInfo(GFileInfo *gfileinfo, DFileInfo::A
     case DFileInfo::AttributeID::kFileSystemSize:
     case DFileInfo::AttributeID::kFileSystemFree:
     case DFileInfo::AttributeID::kFileSystemUsed: {
-        uint64_t ret = g_file_info_get_attribute_uint64(gfileinfo, key.c_str());
+        uint64_t ret = g_file_info_get_attribute_uint64(gfileinfo, key);
         return qulonglong(ret);
     }
     case DFileInfo::AttributeID::kRecentModified: {
-        int64_t ret = g_file_info_get_attribute_int64(gfileinfo, key.c_str());
+        int64_t ret = g_file_info_get_attribute_int64(gfileinfo, key);
         return qlonglong(ret);
     }
     // bool
@@ -341,7 +480,7 @@ QVariant DLocalHelper::attributeFromGFileInfo(GFileInfo *gfileinfo, DFileInfo::A
     case DFileInfo::AttributeID::kDosIsSystem:
     case DFileInfo::AttributeID::kFileSystemReadOnly:
     case DFileInfo::AttributeID::kFileSystemRemote: {
-        bool ret = g_file_info_get_attribute_boolean(gfileinfo, key.c_str());
+        bool ret = g_file_info_get_attribute_boolean(gfileinfo, key);
         return QVariant(ret);
     }
     // byte string
@@ -349,7 +488,7 @@ QVariant DLocalHelper::attributeFromGFileInfo(GFileInfo *gfileinfo, DFileInfo::A
     case DFileInfo::AttributeID::kStandardSymlinkTarget:
     case DFileInfo::AttributeID::kTrashOrigPath:
     case DFileInfo::AttributeID::kThumbnailPath: {
-        const char *ret = g_file_info_get_attribute_byte_string(gfileinfo, key.c_str());
+        const char *ret = g_file_info_get_attribute_byte_string(gfileinfo, key);
         return QVariant(ret);
     }
     // string
@@ -372,14 +511,14 @@ QVariant DLocalHelper::attributeFromGFileInfo(GFileInfo *gfileinfo, DFileInfo::A
     case DFileInfo::AttributeID::kGvfsBackend:
     case DFileInfo::AttributeID::kSelinuxContext:
     case DFileInfo::AttributeID::kTrashDeletionDate: {
-        const char *ret = g_file_info_get_attribute_string(gfileinfo, key.c_str());
+        const char *ret = g_file_info_get_attribute_string(gfileinfo, key);
         return QVariant(ret);
     }
     // object
     case DFileInfo::AttributeID::kStandardIcon:
     case DFileInfo::AttributeID::kPreviewIcon:
     case DFileInfo::AttributeID::kStandardSymbolicIcon: {
-        GObject *icon = g_file_info_get_attribute_object(gfileinfo, key.c_str());
+        GObject *icon = g_file_info_get_attribute_object(gfileinfo, key);
         if (!icon)
             return QVariant();
 
@@ -455,8 +594,8 @@ bool DLocalHelper::setAttributeByGFile(GFile *gfile, DFileInfo::AttributeID id,
     }
 
     // check has attribute
-    const std::string &key = DLocalHelper::attributeStringById(id);
-    if (key.empty()) {
+    const char *key = DLocalHelper::attributeStringById(id);
+    if (!*key) {
         return false;
     }
 
@@ -478,7 +617,7 @@ bool DLocalHelper::setAttributeByGFile(GFile *gfile, DFileInfo::AttributeID id,
     case DFileInfo::AttributeID::kUnixBlockSize:
     case DFileInfo::AttributeID::kFileSystemUsePreview:
     case DFileInfo::AttributeID::kTrashItemCount: {
-        g_file_set_attribute_uint32(gfile, key.c_str(), value.toUInt(), G_FILE_QUERY_INFO_NONE, nullptr, gerror);
+        g_file_set_attribute_uint32(gfile, key, value.toUInt(), G_FILE_QUERY_INFO_NONE, nullptr, gerror);
         if (gerror) {
             g_autofree gchar *url = g_file_get_uri(gfile);
             //qWarning() << "file set attribute failed, url: " << url << " msg: " << (*gerror)->message;
@@ -489,7 +628,7 @@ bool DLocalHelper::setAttributeByGFile(GFile *gfile, DFileInfo::AttributeID id,
     }
     // int32_t
     case DFileInfo::AttributeID::kStandardSortOrder: {
-        g_file_set_attribute_int32(gfile, key.c_str(), value.toInt(), G_FILE_QUERY_INFO_NONE, nullptr, gerror);
+        g_file_set_attribute_int32(gfile, key, value.toInt(), G_FILE_QUERY_INFO_NONE, nullptr, gerror);
         if (gerror) {
             g_autofree gchar *url = g_file_get_uri(gfile);
             //qWarning() << "file set attribute failed, url: " << url << " msg: " << (*gerror)->message;
@@ -509,11 +648,11 @@ bool DLocalHelper::setAttributeByGFile(GFile *gfile, DFileInfo::AttributeID id,
     case DFileInfo::AttributeID::kFileSystemSize:
     case DFileInfo::AttributeID::kFileSystemFree:
     case DFileInfo::AttributeID::kFileSystemUsed: {
-        bool succ = g_file_set_attribute_uint64(gfile, key.c_str(), value.toULongLong(), G_FILE_QUERY_INFO_NONE, nullptr, gerror);
+        bool succ = g_file_set_attribute_uint64(gfile, key, value.toULongLong(), G_FILE_QUERY_INFO_NONE, nullptr, gerror);
         return succ;
     }
     case DFileInfo::AttributeID::kRecentModified: {
-        bool succ = g_file_set_attribute_int64(gfile, key.c_str(), value.toLongLong(), G_FILE_QUERY_INFO_NONE, nullptr, gerror);
+        bool succ = g_file_set_attribute_int64(gfile, key, value.toLongLong(), G_FILE_QUERY_INFO_NONE, nullptr, gerror);
         return succ;
     }
     // bool
@@ -543,7 +682,7 @@ bool DLocalHelper::setAttributeByGFile(GFile *gfile, DFileInfo::AttributeID id,
     case DFileInfo::AttributeID::kFileSystemRemote: {
         gboolean b = value.toBool();
         gpointer gpValue = &b;
-        g_file_set_attribute(gfile, key.c_str(), G_FILE_ATTRIBUTE_TYPE_BOOLEAN, gpValue, G_FILE_QUERY_INFO_NONE, nullptr, gerror);
+        g_file_set_attribute(gfile, key, G_FILE_ATTRIBUTE_TYPE_BOOLEAN, gpValue, G_FILE_QUERY_INFO_NONE, nullptr, gerror);
         if (gerror) {
             g_autofree gchar *url = g_file_get_uri(gfile);
             //qWarning() << "file set attribute failed, url: " << url << " msg: " << (*gerror)->message;
@@ -555,7 +694,7 @@ bool DLocalHelper::setAttributeByGFile(GFile *gfile, DFileInfo::AttributeID id,
     case DFileInfo::AttributeID::kStandardName:
     case DFileInfo::AttributeID::kStandardSymlinkTarget:
     case DFileInfo::AttributeID::kThumbnailPath: {
-        g_file_set_attribute_byte_string(gfile, key.c_str(), value.toString().toLocal8Bit().data(), G_FILE_QUERY_INFO_NONE, nullptr, gerror);
+        g_file_set_attribute_byte_string(gfile, key, value.toString().toLocal8Bit().data(), G_FILE_QUERY_INFO_NONE, nullptr, gerror);
         if (gerror) {
             g_autofree gchar *url = g_file_get_uri(gfile);
             //qWarning() << "file set attribute failed, url: " << url << " msg: " << (*gerror)->message;
@@ -584,7 +723,7 @@ bool DLocalHelper::setAttributeByGFile(GFile *gfile, DFileInfo::AttributeID id,
     case DFileInfo::AttributeID::kSelinuxContext:
     case DFileInfo::AttributeID::kTrashDeletionDate:
     case DFileInfo::AttributeID::kTrashOrigPath: {
-        g_file_set_attribute_string(gfile, key.c_str(), value.toString().toLocal8Bit().data(), G_FILE_QUERY_INFO_NONE, nullptr, gerror);
+        g_file_set_attribute_string(gfile, key, value.toString().toLocal8Bit().data(), G_FILE_QUERY_INFO_NONE, nullptr, gerror);
         if (gerror) {
             g_autofree gchar *url = g_file_get_uri(gfile);
             //qWarning() << "file set attribute failed, url: " << url << " msg: " << (*gerror)->message;
@@ -615,17 +754,78 @@ bool DLocalHelper::setAttributeByGFileInfo(GFileInfo *gfileinfo, DFileInfo::Attr
     return false;
 }
 
-std::string DLocalHelper::attributeStringById(DFileInfo::AttributeID id)
+const char *DLocalHelper::attributeStringById(DFileInfo::AttributeID id)
 {
-    if (DLocalHelper::attributeInfoMapFunc().count(id) > 0) {
-        const std::string &value = std::get<0>(DLocalHelper::attributeInfoMapFunc().at(id));
-        return value;
+    const AttributeInfo *info = attributeInfo(id);
+    return info ? info->key : "";
+}
+
+QByteArray DLocalHelper::attributesQueryString(const QList<DFileInfo::AttributeID> &ids, bool native)
+{
+    QByteArrayList keys;
+    auto append = [&keys](const QByteArray &key) {
+        if (!key.isEmpty() && !keys.contains(key))
+            keys.append(key);
+    };
+
+    for (const DFileInfo::AttributeID id : ids) {
+        if (id == DFileInfo::AttributeID::kCustomStart)
+            continue;
+
+        const char *first = nullptr;
+        const char *second = nullptr;
+        if (LocalFunc::derivedAttributeKeys(id, &first, &second)) {
+            if (first)
+                append(first);
+            if (second)
+                append(second);
+            if (!native && LocalFunc::isAskedFromBackend(id))
+                append(QByteArray(attributeStringById(id)));
+        } else {
+            append(QByteArray(attributeStringById(id)));
+        }
     }
-    return "";
+
+    return keys.join(',');
+}
+
+GFileAttributeMatcher *DLocalHelper::attributeMatcher(const char *attributes)
+{
+    // one matcher per distinct attribute string, shared by all infos and never freed
+    static QMutex mutex;
+    static QHash<QByteArray, GFileAttributeMatcher *> matchers;
+
+    QMutexLocker locker(&mutex);
+    const QByteArray key(attributes);
+    auto it = matchers.constFind(key);
+    if (it != matchers.constEnd())
+        return it.value();
+
+    GFileAttributeMatcher *matcher = g_file_attribute_matcher_new(attributes);
+    matchers.insert(key, matcher);
+    return matcher;
+}
+
+bool DLocalHelper::attributeMatched(GFileAttributeMatcher *matcher, DFileInfo::AttributeID id)
+{
+    if (!matcher)
+        return true;
+
+    const char *first = nullptr;
+    const char *second = nullptr;
+    if (LocalFunc::derivedAttributeKeys(id, &first, &second))
+        return (!first || g_file_attribute_matcher_matches(matcher, first))
+                && (!second || g_file_attribute_matcher_matches(matcher, second));
+
+    const char *key = attributeStringById(id);
+    return !*key || g_file_attribute_matcher_matches(matcher, key);
 }
 
 QSet<QString> DLocalHelper::hideListFromUrl(const QUrl &url)
 {
+    if (url.isLocalFile() && url.fileName() == ".hidden")
+        return DHiddenListCache::instance()->hideList(url.adjusted(QUrl::RemoveFilename).path());
+
     g_autofree char *contents = nullptr;
     g_autoptr(GError) error = nullptr;
     gsize len = 0;
@@ -651,8 +851,8 @@ bool DLocalHelper::fileIsHidden(const DFileInfo *dfileinfo, const QSet<QString>
         return true;
     } else {
         if (hideList.isEmpty() && needRead) {
-            const QString &hiddenPath = dfileinfo->attribute(DFileInfo::AttributeID::kStandardParentPath, nullptr).toString() + "/.hidden";
-            const QSet<QString> &hideList = DLocalHelper::hideListFromUrl(QUrl::fromLocalFile(hiddenPath));
+            const QString &parentPath = dfileinfo->attribute(DFileInfo::AttributeID::kStandardParentPath, nullptr).toString();
+            const QSet<QString> &hideList = DHiddenListCache::instance()->hideList(parentPath);
 
             if (hideList.contains(fileName))
                 return true;
@@ -806,68 +1006,18 @@ bool DLocalHelper::compareByString(const QString &str1, const QString &str2)
     return compareByStringEx(str1, str2);
 }
 
-int DLocalHelper::compareByName(const FTSENT **left, const FTSENT **right)
-{
-    QString str1 = QString((*left)->fts_name), str2 = QString((*right)->fts_name);
-    auto tt = compareByString(str1, str2);
-    return tt ? -1 : 1;
-}
-
-int DLocalHelper::compareBySize(const FTSENT **left, const FTSENT **right)
-{
-    if ((*left)->fts_statp->st_size == (*right)->fts_statp->st_size)
-        return compareByName(left, right);
-    return (*left)->fts_statp->st_size > (*right)->fts_statp->st_size;
-}
-
-int DLocalHelper::compareByLastModifed(const FTSENT **left, const FTSENT **right)
-{
-    if ((*left)->fts_statp->st_mtim.tv_sec == (*right)->fts_statp->st_mtim.tv_sec) {
-        if ((*left)->fts_statp->st_mtim.tv_nsec > (*right)->fts_statp->st_mtim.tv_nsec)
-            return compareByName(left, right);
-        return (*left)->fts_statp->st_mtim.tv_nsec > (*right)->fts_statp->st_mtim.tv_nsec;
-    }
-    return (*left)->fts_statp->st_mtim.tv_sec > (*right)->fts_statp->st_mtim.tv_sec;
-}
-
-int DLocalHelper::compareByLastRead(const FTSENT **left, const FTSENT **right)
-{
-    if ((*left)->fts_statp->st_atim.tv_sec == (*right)->fts_statp->st_atim.tv_sec) {
-        if ((*left)->fts_statp->st_atim.tv_nsec > (*right)->fts_statp->st_atim.tv_nsec)
-            return compareByName(left, right);
-        return (*left)->fts_statp->st_atim.tv_nsec > (*right)->fts_statp->st_atim.tv_nsec;
-    }
-    return (*left)->fts_statp->st_atim.tv_sec > (*right)->fts_statp->st_atim.tv_sec;
-}
-
-QSharedPointer<DEnumerator::SortFileInfo> DLocalHelper::createSortFileInfo(const FTSENT *ent, const QSharedPointer<DFileInfo> &info,
-                                                                           const QSet<QString> hidList)
+QSharedPointer<DEnumerator::SortFileInfo> DLocalHelper::createSortFileInfo(const QString &path, const DLocalSorter::Entry &entry,
+                                                                           const QSet<QString> &hidList)
 {
     auto sortPointer = QSharedPointer<DEnumerator::SortFileInfo>(new DEnumerator::SortFileInfo);
-    auto name = QString(ent->fts_name);
-    auto path = QString(ent->fts_path);
-    if (info) {
-        sortPointer->isDir = info->attribute(DFileInfo::AttributeID::kStandardIsDir).toBool();
-        sortPointer->isFile = !sortPointer->isDir;
-        sortPointer->isSymLink = info->attribute(DFileInfo::AttributeID::kStandardIsSymlink).toBool();
-        auto fileName = info->attribute(DFileInfo::AttributeID::kStandardFileName).toString();
-        sortPointer->isHide = name.startsWith(".")
-                ? true
-                : hidList.contains(name);
-        sortPointer->isReadable = info->attribute(DFileInfo::AttributeID::kAccessCanRead).toBool();
-        sortPointer->isWriteable = info->attribute(DFileInfo::AttributeID::kAccessCanWrite).toBool();
-        sortPointer->isExecutable = info->attribute(DFileInfo::AttributeID::kAccessCanExecute).toBool();
-        sortPointer->url = QUrl::fromLocalFile(path);
-        return sortPointer;
-    }
-
-    sortPointer->isDir = S_ISDIR(ent->fts_statp->st_mode);
+    const QString &name = entry.key.name();
+    sortPointer->isDir = entry.isDir;
     sortPointer->isFile = !sortPointer->isDir;
-    sortPointer->isSymLink = S_ISLNK(ent->fts_statp->st_mode);
+    sortPointer->isSymLink = entry.isSymlink;
     sortPointer->isHide = name.startsWith(".") ? true : hidList.contains(name);
-    sortPointer->isReadable = ent->fts_statp->st_mode & S_IREAD;
-    sortPointer->isWriteable = ent->fts_statp->st_mode & S_IWRITE;
-    sortPointer->isExecutable = ent->fts_statp->st_mode & S_IEXEC;
-    sortPointer->url = QUrl::fromLocalFile(ent->fts_path);
+    sortPointer->isReadable = entry.isReadable;
+    sortPointer->isWriteable = entry.isWritable;
+    sortPointer->isExecutable = entry.isExecutable;
+    sortPointer->url = QUrl::fromLocalFile(path);
     return sortPointer;
 }
@@ -9,11 +9,35 @@
 #include <dfm-io/dfileinfo.h>
 #include <dfm-io/denumerator.h>
 
+#include "dlocalsorter.h"
+
 #include <gio/gio.h>
 
 #include <QSharedPointer>
 
-#include <fts.h>
+// what listings query when no attributes are given. filesystem::* is left out, it costs a
+// statfs per file and is answered per device by DFileSystemCache instead. owner::* too,
+// the names are resolved from unix::uid and unix::gid by DOwnerNames. of standard::* the
+// content type, icons and description of local files are left out, they read the file
+// headers and are sniffed on first use, fast-content-type only looks at the name. so are
+// FILE_DEFERRED_ATTRIBUTES, the rest is what a local dir listing fills without gio
+#define FILE_DEFAULT_ATTRIBUTES "standard::type,standard::is-hidden,standard::is-backup,standard::is-symlink,\
+standard::is-virtual,standard::is-volatile,standard::name,standard::display-name,standard::edit-name,\
+standard::copy-name,standard::fast-content-type,standard::size,standard::allocated-size,\
+standard::symlink-target,standard::target-uri,standard::sort-order,\
+etag::*,id::*,access::*,mountable::*,time::*,unix::*,dos::*,\
+preview::*,gvfs::*,trash::*,recent::*"
+
+// what the default local projection leaves out besides the content type. the thumbnail
+// lookups, the selinux label and the metadata store cost more than the stat of a file,
+// a DFileInfo asks gio for all of them at once the first time one is read
+#define FILE_DEFERRED_ATTRIBUTES "thumbnail::*,selinux::*,metadata::*"
+
+// the same for other schemes. the backends fill the content type from what they list
+// anyway, asking for it later would be one more round trip per file. the owner ids of
+// a remote file mean nothing to the local user database, the backend names them
+#define FILE_REMOTE_DEFAULT_ATTRIBUTES "standard::*,etag::*,id::*,access::*,mountable::*,time::*,unix::*,dos::*,\
+owner::*,thumbnail::*,preview::*,gvfs::*,selinux::*,trash::*,recent::*,metadata::*"
 
 BEGIN_IO_NAMESPACE
 
@@ -38,9 +62,33 @@ std::function<Ret(Ts...)> bind_field(Ret (*m)(Ts...))
 class DLocalHelper
 {
 public:
-    using AttributeInfoMap = std::unordered_map<DFileInfo::AttributeID, std::tuple<std::string, QVariant>>;
+    // what is known about an attribute without asking gio, one constant row per id
+    struct AttributeInfo
+    {
+        enum class Type : quint8 {
+            kInt,
+            kBool,
+            kString,
+        };
+
+        DFileInfo::AttributeID id;
+        const char *key;   // the gio key, static storage
+        Type type;   // the type of the default value
+        int defaultValue;   // 0 or 1 for kBool, unused for kString
+    };
+
+    struct AttributeInfoList
+    {
+        const AttributeInfo *first;
+        const AttributeInfo *last;
+        const AttributeInfo *begin() const { return first; }
+        const AttributeInfo *end() const { return last; }
+    };
 
-    static AttributeInfoMap &attributeInfoMapFunc();
+    // nullptr for ids without a row, such as kAccessPermissions
+    static const AttributeInfo *attributeInfo(DFileInfo::AttributeID id);
+    static AttributeInfoList attributeInfos();
+    static QVariant attributeDefault(DFileInfo::AttributeID id);
     static QSharedPointer<DFileInfo> createFileInfoByUri(const QUrl &uri, const char *attributes = "*",
                                                          const DFMIO::DFileInfo::FileQueryInfoFlags flag = DFMIO::DFileInfo::FileQueryInfoFlags::kTypeNone);
     static QSharedPointer<DFileInfo> createFileInfoByUri(const QUrl &uri, GFileInfo *gfileInfo, const char *attributes = "*",
@@ -51,7 +99,13 @@ public:
     static QVariant customAttributeFromPathAndInfo(const QString &path, GFileInfo *fileInfo, DFileInfo::AttributeID id);
     static bool setAttributeByGFile(GFile *gfile, DFileInfo::AttributeID id, const QVariant &value, GError **error);
     static bool setAttributeByGFileInfo(GFileInfo *gfileinfo, DFileInfo::AttributeID id, const QVariant &value);
-    static std::string attributeStringById(DFileInfo::AttributeID id);
+    // empty for ids without a gio key, never null
+    static const char *attributeStringById(DFileInfo::AttributeID id);
+    // native is false for files of other schemes, their owner names and content types are
+    // asked from the backend, they can't be resolved or guessed here
+    static QByteArray attributesQueryString(const QList<DFileInfo::AttributeID> &ids, bool native = true);
+    static GFileAttributeMatcher *attributeMatcher(const char *attributes);
+    static bool attributeMatched(GFileAttributeMatcher *matcher, DFileInfo::AttributeID id);
     static QSet<QString> hideListFromUrl(const QUrl &url);
     static bool fileIsHidden(const DFileInfo *dfileinfo, const QSet<QString> &hideList, const bool needRead = true);
 
@@ -63,13 +117,9 @@ public:
     static bool compareByStringEx(const QString &str1, const QString &str2);
     static QString numberStr(const QString &str, int pos);
     static bool compareByString(const QString &str1, const QString &str2);
-    static int compareByName(const FTSENT **left, const FTSENT **right);
-    static int compareBySize(const FTSENT **left, const FTSENT **right);
-    static int compareByLastModifed(const FTSENT **left, const FTSENT **right);
-    static int compareByLastRead(const FTSENT **left, const FTSENT **right);
-    static QSharedPointer<DEnumerator::SortFileInfo> createSortFileInfo(const FTSENT *ent,
-                                                                        const QSharedPointer<DFileInfo> &info,
-                                                                        const QSet<QString> hidList);
+    static QSharedPointer<DEnumerator::SortFileInfo> createSortFileInfo(const QString &path,
+                                                                        const DLocalSorter::Entry &entry,
+                                                                        const QSet<QString> &hidList);
 };
 
 END_IO_NAMESPACE
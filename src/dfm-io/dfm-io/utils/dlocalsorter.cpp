@@ -0,0 +1,325 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dlocalsorter.h"
+#include "dlocalenumerator.h"
+
+#include <QVector>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+// fewer entries are not worth the threads
+constexpr size_t kParallelThreshold = 4096;
+
+struct Slice
+{
+    size_t begin { 0 };
+    size_t middle { 0 };
+    size_t end { 0 };
+};
+
+size_t sliceCount(size_t count)
+{
+    const size_t threads = static_cast<size_t>(qMax(1, QThreadPool::globalInstance()->maxThreadCount()));
+    if (count < kParallelThreshold)
+        return 1;
+    return threads;
+}
+
+// runs func on [begin, end) slices of count items in the global thread pool
+template<typename Func>
+void forEachSlice(size_t count, Func func)
+{
+    const size_t slices = sliceCount(count);
+    if (slices == 1) {
+        func(0, count);
+        return;
+    }
+
+    QVector<Slice> work;
+    for (size_t i = 0; i < slices; ++i)
+        work.append({ count * i / slices, 0, count * (i + 1) / slices });
+    QtConcurrent::blockingMap(work, [&func](Slice &slice) {
+        func(slice.begin, slice.end);
+    });
+}
+
+// sorts equal slices, then merges neighbours pairwise until one run is left
+template<typename Iterator, typename Compare>
+void parallelSort(Iterator first, Iterator last, Compare less, const std::atomic_bool &canceled)
+{
+    const size_t count = static_cast<size_t>(last - first);
+    const size_t slices = sliceCount(count);
+    if (slices == 1) {
+        std::sort(first, last, less);
+        return;
+    }
+
+    std::vector<size_t> bounds;
+    for (size_t i = 0; i <= slices; ++i)
+        bounds.push_back(count * i / slices);
+
+    forEachSlice(count, [first, less](size_t from, size_t to) {
+        std::sort(first + static_cast<long>(from), first + static_cast<long>(to), less);
+    });
+
+    for (size_t width = 1; width < slices; width *= 2) {
+        if (canceled)
+            return;
+
+        QVector<Slice> merges;
+        for (size_t i = 0; i + width < slices; i += 2 * width)
+            merges.append({ bounds[i], bounds[i + width], bounds[qMin(i + 2 * width, slices)] });
+        QtConcurrent::blockingMap(merges, [first, less](Slice &slice) {
+            std::inplace_merge(first + static_cast<long>(slice.begin), first + static_cast<long>(slice.middle),
+                               first + static_cast<long>(slice.end), less);
+        });
+    }
+}
+
+int nameCompare(const DLocalSorter::Entry &left, const DLocalSorter::Entry &right)
+{
+    const int ret = DSortKey::compare(left.key, right.key);
+    if (ret != 0)
+        return ret;
+    // names that decode alike still need a fixed order, a partial sort has
+    // to agree with the full one
+    return qstrcmp(left.name, right.name);
+}
+
+int timeCompare(const timespec &left, const timespec &right)
+{
+    if (left.tv_sec != right.tv_sec)
+        return left.tv_sec < right.tv_sec ? -1 : 1;
+    if (left.tv_nsec != right.tv_nsec)
+        return left.tv_nsec < right.tv_nsec ? -1 : 1;
+    return 0;
+}
+
+// calls func with the less-than of role, descending swaps the arguments
+template<typename Func>
+void withComparator(DEnumerator::SortRoleCompareFlag role, bool descending, Func func)
+{
+    auto apply = [descending, &func](auto compare) {
+        if (descending)
+            func([compare](const DLocalSorter::Entry &left, const DLocalSorter::Entry &right) { return compare(right, left) < 0; });
+        else
+            func([compare](const DLocalSorter::Entry &left, const DLocalSorter::Entry &right) { return compare(left, right) < 0; });
+    };
+
+    switch (role) {
+    case DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileName:
+        apply(nameCompare);
+        break;
+    case DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileSize:
+        apply([](const DLocalSorter::Entry &left, const DLocalSorter::Entry &right) {
+            if (left.size != right.size)
+                return left.size < right.size ? -1 : 1;
+            return nameCompare(left, right);
+        });
+        break;
+    case DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileLastModified:
+        apply([](const DLocalSorter::Entry &left, const DLocalSorter::Entry &right) {
+            const int ret = timeCompare(left.modified, right.modified);
+            return ret != 0 ? ret : nameCompare(left, right);
+        });
+        break;
+    case DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileLastRead:
+        apply([](const DLocalSorter::Entry &left, const DLocalSorter::Entry &right) {
+            const int ret = timeCompare(left.accessed, right.accessed);
+            return ret != 0 ? ret : nameCompare(left, right);
+        });
+        break;
+    default:
+        break;
+    }
+}
+}   // namespace
+
+DLocalSorter::DLocalSorter(const QString &path)
+    : dirPath(path)
+{
+}
+
+DLocalSorter::~DLocalSorter()
+{
+    if (dirFd >= 0)
+        close(dirFd);
+}
+
+bool DLocalSorter::read(const std::atomic_bool &canceled)
+{
+    DLocalEnumerator enumerator(dirPath);
+    if (!enumerator.open()) {
+        err = enumerator.lastErrno();
+        return false;
+    }
+
+    DLocalEnumerator::Entry dirent;
+    while (!canceled && enumerator.next(&dirent, false)) {
+        Entry item;
+        item.name = QByteArray(dirent.name);
+        item.isDir = dirent.type == DT_DIR;
+        item.isSymlink = dirent.type == DT_LNK;
+        items.push_back(std::move(item));
+    }
+
+    if (enumerator.lastErrno() != 0) {
+        err = enumerator.lastErrno();
+        return false;
+    }
+
+    // the stat calls are what takes the time for big dirs
+    dirFd = dup(enumerator.fd());
+    forEachSlice(items.size(), [this, &canceled](size_t begin, size_t end) {
+        if (!canceled)
+            statEntries(begin, end, true);
+    });
+    return !canceled;
+}
+
+bool DLocalSorter::restat(const std::vector<Entry> &entries, const std::atomic_bool &canceled)
+{
+    dirFd = open(dirPath.toLocal8Bit().constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) {
+        err = errno;
+        return false;
+    }
+
+    items = entries;
+    forEachSlice(items.size(), [this, &canceled](size_t begin, size_t end) {
+        if (!canceled)
+            statEntries(begin, end, false);
+    });
+    return !canceled;
+}
+
+void DLocalSorter::setSorting(DEnumerator::SortRoleCompareFlag role, Qt::SortOrder order, bool mixDirAndFile)
+{
+    sortRole = role;
+    descending = order == Qt::DescendingOrder;
+    mixed = mixDirAndFile;
+}
+
+size_t DLocalSorter::sortFirst(size_t count, const std::atomic_bool &canceled)
+{
+    if (!grouped) {
+        grouped = true;
+        // dirs first, then every group is sorted on its own
+        if (!mixed) {
+            auto dirsEnd = std::stable_partition(items.begin(), items.end(), [](const Entry &entry) { return entry.isDir; });
+            dirCount = static_cast<size_t>(dirsEnd - items.begin());
+        }
+        if (sortRole == DEnumerator::SortRoleCompareFlag::kSortRoleCompareDefault) {
+            // directory order
+            if (descending) {
+                std::reverse(items.begin(), items.begin() + static_cast<long>(dirCount));
+                std::reverse(items.begin() + static_cast<long>(dirCount), items.end());
+            }
+            groupSorted[0] = dirCount;
+            groupSorted[1] = items.size() - dirCount;
+        }
+    }
+
+    const size_t groupBegin[2] = { 0, dirCount };
+    const size_t groupEnd[2] = { dirCount, items.size() };
+    size_t wanted = count;
+    for (int group = 0; group < 2 && wanted > 0 && !canceled; ++group) {
+        const size_t size = groupEnd[group] - groupBegin[group];
+        const size_t target = qMin(wanted, size);
+        wanted -= target;
+        if (target <= groupSorted[group])
+            continue;
+
+        auto first = items.begin() + static_cast<long>(groupBegin[group] + groupSorted[group]);
+        auto middle = items.begin() + static_cast<long>(groupBegin[group] + target);
+        auto last = items.begin() + static_cast<long>(groupEnd[group]);
+        withComparator(sortRole, descending, [&](auto less) {
+            // only the smallest target entries are put in order, the rest stays behind them unsorted
+            if (middle != last)
+                std::nth_element(first, middle, last, less);
+            parallelSort(first, middle, less, canceled);
+        });
+        if (!canceled)
+            groupSorted[group] = target;
+    }
+
+    return sortedCount();
+}
+
+void DLocalSorter::sortRest(const std::atomic_bool &canceled)
+{
+    sortFirst(items.size(), canceled);
+}
+
+size_t DLocalSorter::sortedCount() const
+{
+    if (groupSorted[0] < dirCount)
+        return groupSorted[0];
+    return dirCount + groupSorted[1];
+}
+
+std::vector<DLocalSorter::Entry> &DLocalSorter::entries()
+{
+    return items;
+}
+
+QString DLocalSorter::path() const
+{
+    return dirPath;
+}
+
+QString DLocalSorter::childPath(const DLocalSorter::Entry &entry) const
+{
+    if (dirPath.endsWith('/'))
+        return dirPath + entry.key.name();
+    return dirPath + "/" + entry.key.name();
+}
+
+int DLocalSorter::lastErrno() const
+{
+    return err;
+}
+
+void DLocalSorter::statEntries(size_t begin, size_t end, bool buildKeys)
+{
+    for (size_t i = begin; i < end; ++i) {
+        Entry &item = items[i];
+        const char *name = item.name.constData();
+
+        struct stat st;
+        if (fstatat(dirFd, name, &st, AT_SYMLINK_NOFOLLOW) == 0) {
+            item.isDir = S_ISDIR(st.st_mode);
+            item.isSymlink = S_ISLNK(st.st_mode);
+            item.size = st.st_size;
+            item.modified = st.st_mtim;
+            item.accessed = st.st_atim;
+            item.isReadable = st.st_mode & S_IREAD;
+            item.isWritable = st.st_mode & S_IWRITE;
+            item.isExecutable = st.st_mode & S_IEXEC;
+        }
+
+        // symlinks are sorted by their own stat, but listed as their target
+        if (item.isSymlink) {
+            struct stat target;
+            item.isDir = fstatat(dirFd, name, &target, 0) == 0 && S_ISDIR(target.st_mode);
+            item.isReadable = DLocalEnumerator::accessAt(dirFd, name, R_OK);
+            item.isWritable = DLocalEnumerator::accessAt(dirFd, name, W_OK);
+            item.isExecutable = DLocalEnumerator::accessAt(dirFd, name, X_OK);
+        }
+
+        if (buildKeys)
+            item.key = DSortKey(QString::fromLocal8Bit(item.name));
+    }
+}
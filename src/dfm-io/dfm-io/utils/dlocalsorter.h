@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DLOCALSORTER_H
+#define DLOCALSORTER_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/denumerator.h>
+
+#include "dsortkey.h"
+
+#include <QString>
+#include <QByteArray>
+
+#include <atomic>
+#include <vector>
+
+#include <time.h>
+
+BEGIN_IO_NAMESPACE
+
+// reads the children of a local directory into a flat array with the stat data
+// sorting needs, then sorts it with several threads, the first page can be
+// sorted on its own before the rest
+class DLocalSorter
+{
+public:
+    struct Entry
+    {
+        QByteArray name;
+        DSortKey key;
+        qint64 size { 0 };
+        timespec modified { 0, 0 };
+        timespec accessed { 0, 0 };
+        bool isDir { false };
+        bool isSymlink { false };
+        bool isReadable { false };
+        bool isWritable { false };
+        bool isExecutable { false };
+    };
+
+    explicit DLocalSorter(const QString &path);
+    ~DLocalSorter();
+
+    bool read(const std::atomic_bool &canceled);
+    // takes the names and keys an earlier read() of the same dir returned,
+    // only the stat data is read again
+    bool restat(const std::vector<Entry> &entries, const std::atomic_bool &canceled);
+    void setSorting(DEnumerator::SortRoleCompareFlag role, Qt::SortOrder order, bool mixDirAndFile);
+    // puts at least the first count entries in their final place, returns how many are
+    size_t sortFirst(size_t count, const std::atomic_bool &canceled);
+    // sorts what sortFirst() left behind
+    void sortRest(const std::atomic_bool &canceled);
+    size_t sortedCount() const;
+
+    std::vector<Entry> &entries();
+    QString path() const;
+    QString childPath(const Entry &entry) const;
+    int lastErrno() const;
+
+private:
+    Q_DISABLE_COPY(DLocalSorter)
+
+    void statEntries(size_t begin, size_t end, bool buildKeys);
+
+    QString dirPath;
+    int dirFd { -1 };
+    int err { 0 };
+    std::vector<Entry> items;
+
+    DEnumerator::SortRoleCompareFlag sortRole { DEnumerator::SortRoleCompareFlag::kSortRoleCompareDefault };
+    bool descending { false };
+    bool mixed { false };
+    bool grouped { false };
+    size_t dirCount { 0 };
+    size_t groupSorted[2] { 0, 0 };   // entries in final order at the front of dirs and files
+};
+
+END_IO_NAMESPACE
+
+#endif   // DLOCALSORTER_H
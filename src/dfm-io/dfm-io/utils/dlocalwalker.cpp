@@ -0,0 +1,238 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dlocalwalker.h"
+#include "dlocalenumerator.h"
+
+#include <QString>
+
+#include <sys/stat.h>
+#include <dirent.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+// entries handed to the consumer at once
+constexpr size_t kBatchSize = 256;
+// producers wait when the consumer falls this far behind
+constexpr size_t kMaxPendingBatches = 64;
+}   // namespace
+
+QByteArray DLocalWalker::Entry::path() const
+{
+    if (parentPath.endsWith('/'))
+        return parentPath + name;
+    return parentPath + '/' + name;
+}
+
+DLocalWalker::DLocalWalker(const QByteArray &root, int threadCount, bool followSymlinks)
+    : rootPath(root), followLinks(followSymlinks)
+{
+    const int count = qMax(1, threadCount);
+    for (int i = 0; i < count; ++i)
+        workers.emplace_back(new Worker);
+}
+
+DLocalWalker::~DLocalWalker()
+{
+    cancel();
+    for (std::thread &thread : threads) {
+        if (thread.joinable())
+            thread.join();
+    }
+}
+
+void DLocalWalker::start()
+{
+    if (!threads.empty())
+        return;
+
+    pending = 1;
+    queued = 1;
+    workers.front()->dirs.push_back(rootPath);
+    for (int i = 0; i < static_cast<int>(workers.size()); ++i)
+        threads.emplace_back(&DLocalWalker::run, this, i);
+}
+
+void DLocalWalker::cancel()
+{
+    canceled = true;
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+    }
+    idleCondition.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(outputMutex);
+    }
+    outputCondition.notify_all();
+}
+
+bool DLocalWalker::next(DLocalWalker::Entry *entry)
+{
+    while (currentPos >= current.size()) {
+        std::unique_lock<std::mutex> lock(outputMutex);
+        outputCondition.wait(lock, [this] {
+            return !output.empty() || finished() || canceled;
+        });
+        if (output.empty() || canceled)
+            return false;
+
+        current = std::move(output.front());
+        output.pop_front();
+        currentPos = 0;
+        lock.unlock();
+        // there is room again for the producers waiting on backpressure
+        outputCondition.notify_all();
+    }
+
+    *entry = std::move(current[currentPos++]);
+    return true;
+}
+
+int DLocalWalker::lastErrno() const
+{
+    return firstErrno;
+}
+
+void DLocalWalker::run(int index)
+{
+    while (!canceled) {
+        QByteArray dir;
+        if (!takeDir(index, &dir)) {
+            // someone else is still reading and may push more dirs, pushes and the
+            // last finished dir notify under idleMutex so none is missed
+            std::unique_lock<std::mutex> lock(idleMutex);
+            idleCondition.wait(lock, [this] {
+                return queued > 0 || finished() || canceled;
+            });
+            if (finished())
+                break;
+            continue;
+        }
+
+        walkDir(index, dir);
+
+        if (--pending == 0) {
+            {
+                std::lock_guard<std::mutex> lock(idleMutex);
+            }
+            idleCondition.notify_all();
+            {
+                std::lock_guard<std::mutex> lock(outputMutex);
+            }
+            outputCondition.notify_all();
+        }
+    }
+}
+
+bool DLocalWalker::takeDir(int index, QByteArray *dir)
+{
+    // own queue from the back, depth first keeps the queues short
+    {
+        Worker *worker = workers[static_cast<size_t>(index)].get();
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        if (!worker->dirs.empty()) {
+            *dir = std::move(worker->dirs.back());
+            worker->dirs.pop_back();
+            --queued;
+            return true;
+        }
+    }
+
+    // steal the oldest, usually biggest, subtree from the others
+    const size_t count = workers.size();
+    for (size_t i = 1; i < count; ++i) {
+        Worker *victim = workers[(static_cast<size_t>(index) + i) % count].get();
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->dirs.empty()) {
+            *dir = std::move(victim->dirs.front());
+            victim->dirs.pop_front();
+            --queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DLocalWalker::pushDir(int index, const QByteArray &dir)
+{
+    ++pending;
+    {
+        Worker *worker = workers[static_cast<size_t>(index)].get();
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->dirs.push_back(dir);
+        ++queued;
+    }
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+    }
+    idleCondition.notify_one();
+}
+
+void DLocalWalker::walkDir(int index, const QByteArray &dir)
+{
+    DLocalEnumerator enumerator(QString::fromLocal8Bit(dir));
+    if (!enumerator.open()) {
+        int expected = 0;
+        firstErrno.compare_exchange_strong(expected, enumerator.lastErrno());
+        return;
+    }
+
+    struct stat st;
+    if (fstat(enumerator.fd(), &st) == 0) {
+        std::lock_guard<std::mutex> lock(visitedMutex);
+        // reached again through a symlink
+        if (!visited.insert({ st.st_dev, st.st_ino }).second)
+            return;
+    }
+
+    std::vector<Entry> batch;
+    batch.reserve(kBatchSize);
+    DLocalEnumerator::Entry dirent;
+    while (!canceled && enumerator.next(&dirent, followLinks)) {
+        Entry entry;
+        entry.parentPath = dir;
+        entry.name = QByteArray(dirent.name);
+        entry.type = dirent.type;
+        entry.targetType = dirent.targetType;
+
+        const unsigned char type = followLinks ? dirent.targetType : dirent.type;
+        if (type == DT_DIR)
+            pushDir(index, entry.path());
+
+        batch.push_back(std::move(entry));
+        if (batch.size() >= kBatchSize) {
+            pushBatch(std::move(batch));
+            batch = std::vector<Entry>();
+            batch.reserve(kBatchSize);
+        }
+    }
+
+    if (enumerator.lastErrno() != 0) {
+        int expected = 0;
+        firstErrno.compare_exchange_strong(expected, enumerator.lastErrno());
+    }
+
+    if (!batch.empty())
+        pushBatch(std::move(batch));
+}
+
+void DLocalWalker::pushBatch(std::vector<DLocalWalker::Entry> &&batch)
+{
+    std::unique_lock<std::mutex> lock(outputMutex);
+    outputCondition.wait(lock, [this] {
+        return output.size() < kMaxPendingBatches || canceled;
+    });
+    if (canceled)
+        return;
+
+    output.push_back(std::move(batch));
+    lock.unlock();
+    outputCondition.notify_all();
+}
+
+bool DLocalWalker::finished() const
+{
+    return pending == 0;
+}
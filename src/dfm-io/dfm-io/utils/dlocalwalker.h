@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DLOCALWALKER_H
+#define DLOCALWALKER_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QByteArray>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <sys/types.h>
+
+BEGIN_IO_NAMESPACE
+
+// walks a local directory tree with several threads, every worker keeps a queue
+// of pending dirs and steals from the others when its own runs dry
+class DLocalWalker
+{
+public:
+    struct Entry
+    {
+        QByteArray parentPath;   // shared by all entries of one dir
+        QByteArray name;
+        unsigned char type { 0 };   // own type, symlinks are DT_LNK
+        unsigned char targetType { 0 };   // type of the symlink target when following symlinks
+
+        QByteArray path() const;
+    };
+
+    explicit DLocalWalker(const QByteArray &root, int threadCount, bool followSymlinks);
+    ~DLocalWalker();
+
+    void start();
+    void cancel();
+    // blocks until an entry is ready, false once the whole tree is walked
+    bool next(Entry *entry);
+    int lastErrno() const;
+
+private:
+    Q_DISABLE_COPY(DLocalWalker)
+
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<QByteArray> dirs;
+    };
+
+    void run(int index);
+    bool takeDir(int index, QByteArray *dir);
+    void pushDir(int index, const QByteArray &dir);
+    void walkDir(int index, const QByteArray &dir);
+    void pushBatch(std::vector<Entry> &&batch);
+    bool finished() const;
+
+    QByteArray rootPath;
+    bool followLinks { false };
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::atomic_int pending { 0 };   // dirs queued or being read
+    std::atomic_int queued { 0 };   // dirs queued, idle workers wake up for them
+    std::atomic_bool canceled { false };
+    std::atomic_int firstErrno { 0 };
+
+    std::mutex idleMutex;
+    std::condition_variable idleCondition;
+
+    std::mutex visitedMutex;
+    std::set<std::pair<dev_t, ino_t>> visited;   // symlink loops are detected by (st_dev, st_ino)
+
+    mutable std::mutex outputMutex;
+    std::condition_variable outputCondition;
+    std::deque<std::vector<Entry>> output;
+
+    std::vector<Entry> current;
+    size_t currentPos { 0 };
+};
+
+END_IO_NAMESPACE
+
+#endif   // DLOCALWALKER_H
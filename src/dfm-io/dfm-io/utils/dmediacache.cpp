@@ -0,0 +1,411 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dmediacache.h"
+
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+// bumped whenever the record layout changes, a file of another version is dropped
+constexpr char kMagic[8] = { 'D', 'F', 'M', 'M', 'E', 'D', 'I', '1' };
+// dev, ino, mtime, size, type and the three string lengths
+constexpr int kFixedBytes = 8 * 4 + 4 + 2 * 3;
+// a value longer than this is not worth keeping
+constexpr int kMaxValueBytes = 0xffff;
+
+template<typename T>
+void put(QByteArray *out, T value)
+{
+    out->append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+T take(const char *&in)
+{
+    T value;
+    memcpy(&value, in, sizeof(T));
+    in += sizeof(T);
+    return value;
+}
+
+bool writeAll(int fd, const QByteArray &data)
+{
+    const char *begin = data.constData();
+    qint64 left = data.size();
+    while (left > 0) {
+        const ssize_t written = ::write(fd, begin, static_cast<size_t>(left));
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        begin += written;
+        left -= written;
+    }
+    return true;
+}
+
+// whether fd is still the file at path, or another process renamed a compacted one over it
+bool isSameFile(int fd, const QByteArray &path)
+{
+    struct stat opened;
+    struct stat current;
+    if (fstat(fd, &opened) != 0 || stat(path.constData(), &current) != 0)
+        return false;
+    return opened.st_dev == current.st_dev && opened.st_ino == current.st_ino;
+}
+
+// exclusive lock on a file next to the cache, the cache file itself is
+// replaced on compaction and a lock on it would go with the old inode
+class FileLock
+{
+public:
+    explicit FileLock(const QByteArray &lockPath)
+        : fd(::open(lockPath.constData(), O_RDWR | O_CREAT | O_CLOEXEC, 0600))
+    {
+        if (fd < 0)
+            return;
+        int ret = 0;
+        do {
+            ret = flock(fd, LOCK_EX);
+        } while (ret != 0 && errno == EINTR);
+        if (ret != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    ~FileLock()
+    {
+        // closing drops the lock
+        if (fd >= 0)
+            ::close(fd);
+    }
+    bool isLocked() const { return fd >= 0; }
+
+private:
+    Q_DISABLE_COPY(FileLock)
+    int fd { -1 };
+};
+}   // namespace
+
+DMediaCache *DMediaCache::instance()
+{
+    static DMediaCache cache(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+                             + QStringLiteral("/dfm-io/media.cache"));
+    return &cache;
+}
+
+bool DMediaCache::keyOf(const QString &filePath, Key *key)
+{
+    struct statx stx;
+    const unsigned mask = STATX_INO | STATX_MTIME | STATX_SIZE;
+    if (statx(AT_FDCWD, filePath.toLocal8Bit().constData(), AT_NO_AUTOMOUNT, mask, &stx) != 0)
+        return false;
+    if ((stx.stx_mask & mask) != mask)
+        return false;
+
+    key->dev = makedev(stx.stx_dev_major, stx.stx_dev_minor);
+    key->ino = stx.stx_ino;
+    key->modifiedNs = static_cast<qint64>(stx.stx_mtime.tv_sec) * 1000000000 + stx.stx_mtime.tv_nsec;
+    key->size = static_cast<qint64>(stx.stx_size);
+    return true;
+}
+
+DMediaCache::DMediaCache(const QString &filePath, qint64 maxBytes)
+    : path(filePath), maxBytes(qMax<qint64>(maxBytes, 4096))
+{
+}
+
+DMediaCache::~DMediaCache()
+{
+    loading.waitForFinished();
+    if (fd >= 0)
+        ::close(fd);
+}
+
+bool DMediaCache::find(const Key &key, DFileInfo::MediaType type, Values *values)
+{
+    // the file is read in the background, until then only what was inserted is found
+    startLoading();
+    QMutexLocker locker(&mutex);
+    auto it = entries.constFind(Slot { key.dev, key.ino, static_cast<int>(type) });
+    if (it == entries.constEnd() || it->modifiedNs != key.modifiedNs || it->size != key.size)
+        return false;
+    *values = it->values;
+    return true;
+}
+
+void DMediaCache::insert(const Key &key, DFileInfo::MediaType type, const Values &values)
+{
+    const Slot slot { key.dev, key.ino, static_cast<int>(type) };
+    startLoading();
+    QMutexLocker locker(&mutex);
+    Entry &entry = entries[slot];
+    entry.modifiedNs = key.modifiedNs;
+    entry.size = key.size;
+    entry.values = values;
+    entry.serial = ++serial;
+
+    if (!openForAppend())
+        return;
+    // one write per record, other processes appending to the file do not tear it
+    const QByteArray &data = record(slot, entry);
+    if (writeAll(fd, data))
+        bytes += data.size();
+    // compacting before the file is in would drop what it holds
+    if (loaded && bytes > maxBytes)
+        compact();
+}
+
+QString DMediaCache::filePath() const
+{
+    return path;
+}
+
+qint64 DMediaCache::fileSize() const
+{
+    QMutexLocker locker(&mutex);
+    return bytes;
+}
+
+QByteArray DMediaCache::record(const Slot &slot, const Entry &entry)
+{
+    const QByteArray &duration = entry.values.duration.toUtf8().left(kMaxValueBytes);
+    const QByteArray &width = entry.values.width.toUtf8().left(kMaxValueBytes);
+    const QByteArray &height = entry.values.height.toUtf8().left(kMaxValueBytes);
+
+    QByteArray out;
+    const quint32 length = static_cast<quint32>(kFixedBytes + duration.size() + width.size() + height.size());
+    out.reserve(static_cast<int>(sizeof(quint32) + length));
+    put<quint32>(&out, length);
+    put<quint64>(&out, slot.dev);
+    put<quint64>(&out, slot.ino);
+    put<qint64>(&out, entry.modifiedNs);
+    put<qint64>(&out, entry.size);
+    put<qint32>(&out, slot.type);
+    put<quint16>(&out, static_cast<quint16>(duration.size()));
+    put<quint16>(&out, static_cast<quint16>(width.size()));
+    put<quint16>(&out, static_cast<quint16>(height.size()));
+    out.append(duration).append(width).append(height);
+    return out;
+}
+
+void DMediaCache::load()
+{
+    // runs in the pool, the mutex is only taken to merge what was read
+    QHash<Slot, Entry> read;
+    const qint64 readBytes = readFile(&read);
+
+    QMutexLocker locker(&mutex);
+    // inserts made meanwhile are newer than anything in the file
+    const quint64 readCount = static_cast<quint64>(read.size());
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+        it->serial += readCount;
+    serial += readCount;
+    for (auto it = read.constBegin(); it != read.constEnd(); ++it) {
+        if (!entries.contains(it.key()))
+            entries.insert(it.key(), it.value());
+    }
+    if (fd < 0)
+        bytes = readBytes;
+    loaded = true;
+}
+
+qint64 DMediaCache::readFile(QHash<Slot, Entry> *read) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return 0;
+    const QByteArray &data = file.readAll();
+    if (data.size() < static_cast<int>(sizeof(kMagic)) || memcmp(data.constData(), kMagic, sizeof(kMagic)) != 0) {
+        // another version or garbage, start over
+        FileLock lock(lockPath());
+        if (lock.isLocked() && isSameFile(file.handle(), path.toLocal8Bit()))
+            QFile::remove(path);
+        return 0;
+    }
+
+    // a torn or damaged record ends the file, what follows it is appended anew
+    quint64 readSerial = 0;
+    const char *in = data.constData() + sizeof(kMagic);
+    const char *end = data.constData() + data.size();
+    while (end - in >= static_cast<qint64>(sizeof(quint32))) {
+        const char *recordBegin = in;
+        const quint32 length = take<quint32>(in);
+        if (length < static_cast<quint32>(kFixedBytes) || static_cast<quint64>(end - in) < length) {
+            in = recordBegin;
+            break;
+        }
+        const char *recordEnd = in + length;
+
+        Slot slot;
+        Entry entry;
+        slot.dev = take<quint64>(in);
+        slot.ino = take<quint64>(in);
+        entry.modifiedNs = take<qint64>(in);
+        entry.size = take<qint64>(in);
+        slot.type = take<qint32>(in);
+        const quint16 durationBytes = take<quint16>(in);
+        const quint16 widthBytes = take<quint16>(in);
+        const quint16 heightBytes = take<quint16>(in);
+        if (kFixedBytes + durationBytes + widthBytes + heightBytes != static_cast<int>(length)) {
+            in = recordBegin;
+            break;
+        }
+        entry.values.duration = QString::fromUtf8(in, durationBytes);
+        in += durationBytes;
+        entry.values.width = QString::fromUtf8(in, widthBytes);
+        in += widthBytes;
+        entry.values.height = QString::fromUtf8(in, heightBytes);
+        in = recordEnd;
+
+        // later records of a slot replace earlier ones
+        entry.serial = ++readSerial;
+        read->insert(slot, entry);
+    }
+    const qint64 validBytes = in - data.constData();
+    if (in == end)
+        return validBytes;
+
+    // only the tail read here is cut, another process may have appended
+    // behind it or replaced the file meanwhile
+    FileLock lock(lockPath());
+    struct stat st;
+    const bool unchanged = lock.isLocked() && isSameFile(file.handle(), path.toLocal8Bit())
+            && fstat(file.handle(), &st) == 0 && st.st_size == data.size();
+    if (!unchanged || ::truncate(path.toLocal8Bit().constData(), validBytes) != 0)
+        return data.size();
+    return validBytes;
+}
+
+void DMediaCache::startLoading()
+{
+    QMutexLocker locker(&mutex);
+    if (loadStarted)
+        return;
+    loadStarted = true;
+    loading = QtConcurrent::run([this]() { load(); });
+}
+
+void DMediaCache::waitForLoaded()
+{
+    startLoading();
+    QFuture<void> future;
+    {
+        QMutexLocker locker(&mutex);
+        future = loading;
+    }
+    future.waitForFinished();
+}
+
+void DMediaCache::compact()
+{
+    // newest first until half the limit is used, leaves room for appending a while
+    std::vector<QHash<Slot, Entry>::const_iterator> order;
+    order.reserve(static_cast<size_t>(entries.size()));
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it)
+        order.push_back(it);
+    std::sort(order.begin(), order.end(), [](const QHash<Slot, Entry>::const_iterator &left, const QHash<Slot, Entry>::const_iterator &right) {
+        return left->serial > right->serial;
+    });
+
+    QByteArray data(kMagic, sizeof(kMagic));
+    QHash<Slot, Entry> kept;
+    for (const auto &it : order) {
+        const QByteArray &one = record(it.key(), it.value());
+        if (data.size() + one.size() > maxBytes / 2)
+            break;
+        data.append(one);
+        kept.insert(it.key(), it.value());
+    }
+
+    // written aside and renamed, a reader never sees half a file.
+    // the lock keeps two processes from compacting at once
+    const QByteArray &target = path.toLocal8Bit();
+    FileLock lock(lockPath());
+    if (!lock.isLocked())
+        return;
+    if (fd >= 0 && !isSameFile(fd, target)) {
+        // compacted by another process already, the next insert appends to its file
+        ::close(fd);
+        fd = -1;
+        struct stat st;
+        if (stat(target.constData(), &st) == 0 && st.st_size <= maxBytes) {
+            bytes = st.st_size;
+            return;
+        }
+    }
+
+    QByteArray temp = target + ".XXXXXX";
+    const int tempFd = mkostemp(temp.data(), O_CLOEXEC);
+    if (tempFd < 0)
+        return;
+    const bool written = writeAll(tempFd, data);
+    ::close(tempFd);
+    if (!written || ::rename(temp.constData(), target.constData()) != 0) {
+        ::unlink(temp.constData());
+        return;
+    }
+
+    entries.swap(kept);
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+    bytes = data.size();
+}
+
+bool DMediaCache::openForAppend()
+{
+    const QByteArray &target = path.toLocal8Bit();
+    if (fd >= 0) {
+        if (isSameFile(fd, target))
+            return true;
+        // appending to a file another process renamed away loses the records
+        ::close(fd);
+        fd = -1;
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    fd = ::open(target.constData(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+        return true;
+    bytes = st.st_size;
+    if (bytes > 0)
+        return true;
+
+    // one process writes the header of a new file
+    FileLock lock(lockPath());
+    if (fstat(fd, &st) == 0 && st.st_size == 0 && writeAll(fd, QByteArray(kMagic, sizeof(kMagic))))
+        bytes = sizeof(kMagic);
+    else
+        bytes = st.st_size;
+    return true;
+}
+
+QByteArray DMediaCache::lockPath() const
+{
+    return path.toLocal8Bit() + ".lock";
+}
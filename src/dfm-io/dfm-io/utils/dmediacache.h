@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DMEDIACACHE_H
+#define DMEDIACACHE_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/dfileinfo.h>
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QFuture>
+
+BEGIN_IO_NAMESPACE
+
+// media attributes already read by libmediainfo, kept across sessions in an append
+// only file under $XDG_CACHE_HOME/dfm-io. an entry holds while the file keeps its
+// device, inode, mtime and size. the file is rewritten with the live entries once it
+// grows past its limit, the oldest ones go first when those alone do not fit.
+// several processes share the file, compaction and repairs take a lock next to it
+class DMediaCache
+{
+public:
+    struct Key
+    {
+        quint64 dev { 0 };
+        quint64 ino { 0 };
+        qint64 modifiedNs { 0 };
+        qint64 size { 0 };
+    };
+
+    struct Values
+    {
+        QString duration;
+        QString width;
+        QString height;
+    };
+
+    static DMediaCache *instance();
+    // follows links, as libmediainfo opens the target
+    static bool keyOf(const QString &filePath, Key *key);
+
+    // maxBytes bounds the file, it is compacted to half of it
+    explicit DMediaCache(const QString &filePath, qint64 maxBytes = kDefaultMaxBytes);
+    ~DMediaCache();
+
+    bool find(const Key &key, DFileInfo::MediaType type, Values *values);
+    void insert(const Key &key, DFileInfo::MediaType type, const Values &values);
+
+    // the first find() or insert() starts reading the file in the background
+    void startLoading();
+    void waitForLoaded();
+
+    QString filePath() const;
+    qint64 fileSize() const;
+
+private:
+    Q_DISABLE_COPY(DMediaCache)
+
+    static constexpr qint64 kDefaultMaxBytes = 4 * 1024 * 1024;
+
+    // a file is cached once per media type, newer stamps replace older ones
+    struct Slot
+    {
+        quint64 dev;
+        quint64 ino;
+        int type;
+        bool operator==(const Slot &other) const { return dev == other.dev && ino == other.ino && type == other.type; }
+    };
+    friend uint qHash(const Slot &slot, uint seed = 0)
+    {
+        return qHash(slot.ino, seed) ^ qHash(slot.dev, seed) ^ uint(slot.type);
+    }
+
+    struct Entry
+    {
+        qint64 modifiedNs;
+        qint64 size;
+        Values values;
+        quint64 serial;   // insertion order, compaction keeps the newest
+    };
+
+    static QByteArray record(const Slot &slot, const Entry &entry);
+    void load();
+    qint64 readFile(QHash<Slot, Entry> *read) const;
+    void compact();
+    bool openForAppend();
+    QByteArray lockPath() const;
+
+    QString path;
+    qint64 maxBytes;
+    mutable QMutex mutex;
+    bool loadStarted { false };
+    bool loaded { false };
+    QFuture<void> loading;
+    int fd { -1 };
+    qint64 bytes { 0 };
+    quint64 serial { 0 };
+    QHash<Slot, Entry> entries;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DMEDIACACHE_H
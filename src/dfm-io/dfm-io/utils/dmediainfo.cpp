@@ -6,108 +6,197 @@
 
 #include <MediaInfo/MediaInfo.h>
 
-#include <QTimer>
-#include <QQueue>
-#include <QMutex>
-#include <QPointer>
-#include <QDebug>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QFile>
+#include <QRecursiveMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
 
-#include <thread>
+USING_IO_NAMESPACE
+
+namespace {
+// parsing reads the file, a few at a time keep a folder of videos from flooding the disk
+constexpr int kMaxMediaThreads = 4;
+// releasing a parser frees its memory, it queues like a read of default priority
+constexpr int kReleasePriority = 0;
+// the file is fed to the parser in chunks, a stop is noticed between two of them
+constexpr int kChunkSize = 64 * 1024;
+// bit 3 of what Open_Buffer_Continue returns, the parser needs no more data
+constexpr size_t kParseFinalized = 0x08;
+
+// one read of one file, shared by the DMediaInfo and the task running it
+struct MediaRead
+{
+    QString fileName;
+    QSharedPointer<MediaInfoLib::MediaInfo> mediaInfo;
+    DMediaInfo::FinishedCallback callback;
+    // held while the callback runs, a stop waits for it. recursive since the
+    // callback may drop the info and with it the DMediaInfo
+    QRecursiveMutex mutex;
+    bool stopped { false };
+
+    bool isStopped()
+    {
+        QMutexLocker locker(&mutex);
+        return stopped;
+    }
+};
+
+class MediaReadTask : public QRunnable
+{
+public:
+    explicit MediaReadTask(const QSharedPointer<MediaRead> &read)
+        : read(read) { }
+
+    void run() override
+    {
+        if (read->isStopped())
+            return;
+
+        MediaInfoLib::MediaInfo *mediaInfo = read->mediaInfo.data();
+        mediaInfo->Option(__T("Width"), __T("Text"));
+        mediaInfo->Option(__T("Height"), __T("Text"));
+        mediaInfo->Option(__T("Duration"), __T("Text"));
+        if (!parse(mediaInfo))
+            return;
+
+        QMutexLocker locker(&read->mutex);
+        if (!read->stopped && read->callback)
+            read->callback();
+    }
+
+private:
+    // false when stopped on the way, the parse is abandoned like Close did on a threaded Open
+    bool parse(MediaInfoLib::MediaInfo *mediaInfo)
+    {
+        QFile file(read->fileName);
+        if (!file.open(QIODevice::ReadOnly))
+            return !read->isStopped();
+
+        // the name still lets the parser guess by extension
+        mediaInfo->Option(__T("File_FileName"), read->fileName.toStdWString());
+        const MediaInfo_int64u size = static_cast<MediaInfo_int64u>(file.size());
+        mediaInfo->Open_Buffer_Init(size, 0);
+
+        QByteArray buffer(kChunkSize, Qt::Uninitialized);
+        while (!read->isStopped()) {
+            const qint64 length = file.read(buffer.data(), buffer.size());
+            if (length <= 0)
+                break;
+            const size_t status = mediaInfo->Open_Buffer_Continue(reinterpret_cast<const ZenLib::int8u *>(buffer.constData()),
+                                                                  static_cast<size_t>(length));
+            if (status & kParseFinalized)
+                break;
+            // the parser skips what it does not need, e.g. to the index at the end
+            const MediaInfo_int64u offset = mediaInfo->Open_Buffer_Continue_GoTo_Get();
+            if (offset != static_cast<MediaInfo_int64u>(-1)) {
+                if (!file.seek(static_cast<qint64>(offset)))
+                    break;
+                mediaInfo->Open_Buffer_Init(size, offset);
+            }
+        }
+
+        if (read->isStopped())
+            return false;
+        mediaInfo->Open_Buffer_Finalize();
+        return true;
+    }
+
+    QSharedPointer<MediaRead> read;
+};
 
-static constexpr size_t kMediaInfoStateFinished { 10000 };   // read finished and no error
+// drops the last reference to a parser off the caller's thread
+class MediaReleaseTask : public QRunnable
+{
+public:
+    explicit MediaReleaseTask(const QSharedPointer<MediaInfoLib::MediaInfo> &mediaInfo)
+        : mediaInfo(mediaInfo) { }
 
-Q_GLOBAL_STATIC(QQueue<QSharedPointer<MediaInfoLib::MediaInfo>>, queueDestoryMediaInfo)
+    void run() override { mediaInfo.reset(); }
+
+private:
+    QSharedPointer<MediaInfoLib::MediaInfo> mediaInfo;
+};
+
+// the workers of all media reads, pending reads are dropped and running ones
+// waited for when the library unloads
+class MediaInfoPool
+{
+public:
+    static QThreadPool *instance()
+    {
+        static MediaInfoPool pool;
+        return &pool.threadPool;
+    }
+
+private:
+    MediaInfoPool() { threadPool.setMaxThreadCount(kMaxMediaThreads); }
+    ~MediaInfoPool()
+    {
+        threadPool.clear();
+        threadPool.waitForDone();
+    }
+
+    QThreadPool threadPool;
+};
+}   // namespace
 
 BEGIN_IO_NAMESPACE
-class DMediaInfoPrivate : public QObject
+class DMediaInfoPrivate
 {
 public:
-    DMediaInfoPrivate(DMediaInfo *qq, const QString &fileName)
-        : q(qq)
+    explicit DMediaInfoPrivate(const QString &fileName)
+        : fileName(fileName)
     {
-        this->fileName = fileName;
-        isStopState.store(false);
-        mediaInfo.reset(new MediaInfoLib::MediaInfo());
     }
 
     ~DMediaInfoPrivate()
     {
-        if (mediaInfo) {
-            // 由于当远程文件夹下存在大量图片文件时，析构mediainfo对象耗时会很长，造成文管卡
-            // 所以将对象添加到队列中，开启线程去释放对象
-            static QMutex lock;
-            {
-                QMutexLocker locker(&lock);
-                queueDestoryMediaInfo->enqueue(mediaInfo);
-            }
+        stop();
+        // 由于当远程文件夹下存在大量图片文件时，析构mediainfo对象耗时会很长，造成文管卡
+        // 所以由工作线程去释放对象，正在读取的由读取任务持有
+        QSharedPointer<MediaInfoLib::MediaInfo> mediaInfo = read ? read->mediaInfo : nullptr;
+        read.reset();
+        if (mediaInfo)
+            MediaInfoPool::instance()->start(new MediaReleaseTask(mediaInfo), kReleasePriority);
+    }
 
-            static bool isRunning = false;
-            if (!isRunning) {
-                isRunning = true;
-                std::thread thread(
-                        []() {
-                            while (!queueDestoryMediaInfo->isEmpty()) {
-                                QMutexLocker locker(&lock);
-                                queueDestoryMediaInfo->dequeue();
-                            }
-                            isRunning = false;
-                        });
-                thread.detach();
-            }
-        }
+    void start(DMediaInfo::FinishedCallback callback, int ioPriority)
+    {
+        stop();
+        read.reset(new MediaRead);
+        read->fileName = fileName;
+        read->mediaInfo.reset(new MediaInfoLib::MediaInfo());
+        read->callback = callback;
+        // io priorities are glib's, lower is more urgent
+        MediaInfoPool::instance()->start(new MediaReadTask(read), -ioPriority);
     }
 
-    /**
-     * @brief bug-35165, 将构造时读取media信息的方式改为独立的方法
-     * 以免造成构造对象时直接卡住
-     */
-    void start()
+    // a queued read is skipped, a running one is abandoned at its next chunk
+    void stop()
     {
-        if (isStopState.load())
+        if (!read)
             return;
-
-        mediaInfo->Option(__T("Thread"));
-        mediaInfo->Option(__T("Width"), __T("Text"));
-        mediaInfo->Option(__T("Height"), __T("Text"));
-        mediaInfo->Option(__T("Duration"), __T("Text"));
-        mediaInfo->Open(fileName.toStdWString());
-
-        QPointer<DMediaInfoPrivate> me = this;
-        std::thread thread([me]() {
-            while (1) {
-                if (!me)
-                    break;
-                if (me->isStopState.load())
-                    break;
-                if (me->mediaInfo->State_Get() == kMediaInfoStateFinished) {
-                    me->callback();
-                    break;
-                }
-                std::chrono::milliseconds dura(200);
-                std::this_thread::sleep_for(dura);
-            }
-        });
-        thread.detach();
+        QMutexLocker locker(&read->mutex);
+        read->stopped = true;
     }
 
     QString value(const QString &key, MediaInfoLib::stream_t type)
     {
-        QString info = QString::fromStdWString(mediaInfo->Get(type, 0, key.toStdWString()));
-        return info;
+        if (!read)
+            return QString();
+        return QString::fromStdWString(read->mediaInfo->Get(type, 0, key.toStdWString()));
     }
 
 public:
     QString fileName;
-    QSharedPointer<MediaInfoLib::MediaInfo> mediaInfo { nullptr };
-    DMediaInfo *q { nullptr };
-    DMediaInfo::FinishedCallback callback = nullptr;
-    std::atomic_bool isStopState;
+    QSharedPointer<MediaRead> read;
 };
 END_IO_NAMESPACE
 
-USING_IO_NAMESPACE
 DMediaInfo::DMediaInfo(const QString &fileName)
-    : d(new DMediaInfoPrivate(this, fileName))
+    : d(new DMediaInfoPrivate(fileName))
 {
 }
 
@@ -120,16 +209,12 @@ QString DMediaInfo::value(const QString &key, DFileInfo::MediaType meidiaType /*
     return d->value(key, static_cast<MediaInfoLib::stream_t>(meidiaType));
 }
 
-void DMediaInfo::startReadInfo(FinishedCallback callback)
+void DMediaInfo::startReadInfo(FinishedCallback callback, int ioPriority)
 {
-    d->isStopState.store(false);
-    d->callback = callback;
-    d->start();
+    d->start(callback, ioPriority);
 }
 
 void DMediaInfo::stopReadInfo()
 {
-    d->isStopState.store(true);
-    if (d->mediaInfo)
-        d->mediaInfo->Close();
+    d->stop();
 }
@@ -27,7 +27,10 @@ public:
 
     QString value(const QString &key, DFileInfo::MediaType meidiaType = DFileInfo::MediaType::kGeneral);
 
-    void startReadInfo(FinishedCallback callback);
+    // queued on the shared media workers, callback is called on a worker once the
+    // file is parsed. ioPriority is a glib io priority, lower ones are read first
+    void startReadInfo(FinishedCallback callback, int ioPriority = 0);
+    // after it returns the callback is not running and will not be called
     void stopReadInfo();
 
 private:
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dnamematcher.h"
+
+#include <fnmatch.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+bool hasWildcard(const QStringRef &pattern)
+{
+    for (const QChar &c : pattern) {
+        if (c == '*' || c == '?' || c == '[' || c == '\\')
+            return true;
+    }
+    return false;
+}
+}   // namespace
+
+DNameMatcher::DNameMatcher(const QStringList &patterns, bool caseSensitive)
+    : caseSensitive(caseSensitive)
+{
+    for (const QString &filter : patterns) {
+        const QString &pattern = caseSensitive ? filter.trimmed() : filter.trimmed().toLower();
+        if (pattern.isEmpty())
+            continue;
+
+        if (pattern == "*") {
+            matchAll = true;
+        } else if (!hasWildcard(QStringRef(&pattern))) {
+            names.insert(pattern);
+        } else if (pattern.startsWith("*.") && !hasWildcard(pattern.midRef(1))) {
+            const QString &suffix = pattern.mid(1);
+            suffixes.insert(suffix);
+            minSuffixLength = minSuffixLength == 0 ? suffix.length() : qMin(minSuffixLength, suffix.length());
+        } else {
+            globs.append(pattern.toLocal8Bit());
+        }
+    }
+}
+
+bool DNameMatcher::isEmpty() const
+{
+    return !matchAll && names.isEmpty() && suffixes.isEmpty() && globs.isEmpty();
+}
+
+bool DNameMatcher::matches(const QString &name) const
+{
+    if (matchAll || isEmpty())
+        return true;
+
+    const QString &key = caseSensitive ? name : name.toLower();
+    if (names.contains(key))
+        return true;
+
+    // every dot may start a suffix, ".tar.gz" as well as ".gz"
+    if (!suffixes.isEmpty()) {
+        for (int dot = key.lastIndexOf('.'); dot >= 0; dot = dot > 0 ? key.lastIndexOf('.', dot - 1) : -1) {
+            if (key.length() - dot < minSuffixLength)
+                continue;
+            if (suffixes.contains(key.mid(dot)))
+                return true;
+        }
+    }
+
+    if (!globs.isEmpty()) {
+        const QByteArray &bytes = key.toLocal8Bit();
+        for (const QByteArray &glob : globs) {
+            if (fnmatch(glob.constData(), bytes.constData(), 0) == 0)
+                return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DNAMEMATCHER_H
+#define DNAMEMATCHER_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QSet>
+
+BEGIN_IO_NAMESPACE
+
+// wildcard name filters as QDir takes them ("*.jpg", "IMG_????.*", "[abc]*"), compiled once.
+// plain names and "*.ext" patterns are hash lookups, only the other patterns go through fnmatch
+class DNameMatcher
+{
+public:
+    DNameMatcher() = default;
+    DNameMatcher(const QStringList &patterns, bool caseSensitive);
+
+    // no patterns matches every name
+    bool isEmpty() const;
+    bool matches(const QString &name) const;
+
+private:
+    bool caseSensitive { true };
+    bool matchAll { false };
+    QSet<QString> names;
+    QSet<QString> suffixes;   // with the leading dot
+    int minSuffixLength { 0 };
+    QVector<QByteArray> globs;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DNAMEMATCHER_H
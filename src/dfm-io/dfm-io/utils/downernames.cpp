@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "downernames.h"
+
+#include <QMutexLocker>
+
+#include <vector>
+
+#include <pwd.h>
+#include <grp.h>
+#include <unistd.h>
+#include <errno.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+// accounts change rarely, a renamed one shows up after this
+constexpr qint64 kTimeToLive = 60 * 1000;   // ms
+// ids remembered at most, the cache starts over when full
+constexpr int kMaxIds = 4096;
+
+size_t bufferSize(int name)
+{
+    const long size = sysconf(name);
+    return size > 0 ? static_cast<size_t>(size) : 1024;
+}
+
+// the first gecos field, as gio gives owner::user-real
+QString realNameOf(const char *gecos)
+{
+    if (!gecos)
+        return QString();
+    return QString::fromLocal8Bit(gecos).section(',', 0, 0);
+}
+}   // namespace
+
+DOwnerNames *DOwnerNames::instance()
+{
+    static DOwnerNames names;
+    return &names;
+}
+
+QString DOwnerNames::userName(uid_t uid)
+{
+    return user(uid).name;
+}
+
+QString DOwnerNames::userRealName(uid_t uid)
+{
+    return user(uid).realName;
+}
+
+QString DOwnerNames::groupName(gid_t gid)
+{
+    return group(gid).name;
+}
+
+DOwnerNames::Names DOwnerNames::user(uid_t uid)
+{
+    Names names;
+    {
+        QMutexLocker locker(&mutex);
+        if (fresh(users, uid, &names))
+            return names;
+    }
+
+    QMutexLocker lookupLocker(&lookupMutex);
+    {
+        // looked up while this caller waited
+        QMutexLocker locker(&mutex);
+        if (fresh(users, uid, &names))
+            return names;
+    }
+    // a failing nss is asked again next time, a missing entry is not,
+    // both give the fallback names
+    if (!lookupUser(uid, &names))
+        return names;
+
+    QMutexLocker locker(&mutex);
+    if (users.size() >= kMaxIds)
+        users.clear();
+    users.insert(uid, names);
+    return names;
+}
+
+DOwnerNames::Names DOwnerNames::group(gid_t gid)
+{
+    Names names;
+    {
+        QMutexLocker locker(&mutex);
+        if (fresh(groups, gid, &names))
+            return names;
+    }
+
+    QMutexLocker lookupLocker(&lookupMutex);
+    {
+        QMutexLocker locker(&mutex);
+        if (fresh(groups, gid, &names))
+            return names;
+    }
+    // a failing nss is asked again next time, a missing entry is not,
+    // both give the fallback names
+    if (!lookupGroup(gid, &names))
+        return names;
+
+    QMutexLocker locker(&mutex);
+    if (groups.size() >= kMaxIds)
+        groups.clear();
+    groups.insert(gid, names);
+    return names;
+}
+
+bool DOwnerNames::lookupUser(uid_t uid, Names *names)
+{
+    names->age.start();
+
+    std::vector<char> buffer(bufferSize(_SC_GETPW_R_SIZE_MAX));
+    struct passwd pwd;
+    struct passwd *result = nullptr;
+    int ret = 0;
+    while ((ret = getpwuid_r(uid, &pwd, buffer.data(), buffer.size(), &result)) == ERANGE)
+        buffer.resize(buffer.size() * 2);
+    if (ret == 0 && result) {
+        if (pwd.pw_name)
+            names->name = QString::fromLocal8Bit(pwd.pw_name);
+        names->realName = realNameOf(pwd.pw_gecos);
+    }
+
+    // the fallbacks of the gio local backend
+    if (names->realName.isEmpty())
+        names->realName = names->name.isEmpty() ? QString("user #%1").arg(uid) : names->name;
+    if (names->name.isEmpty())
+        names->name = QString::number(uid);
+    return ret == 0;
+}
+
+bool DOwnerNames::lookupGroup(gid_t gid, Names *names)
+{
+    names->age.start();
+
+    std::vector<char> buffer(bufferSize(_SC_GETGR_R_SIZE_MAX));
+    struct group grp;
+    struct group *result = nullptr;
+    int ret = 0;
+    while ((ret = getgrgid_r(gid, &grp, buffer.data(), buffer.size(), &result)) == ERANGE)
+        buffer.resize(buffer.size() * 2);
+    if (ret == 0 && result && grp.gr_name)
+        names->name = QString::fromLocal8Bit(grp.gr_name);
+    if (names->name.isEmpty())
+        names->name = QString::number(gid);
+    return ret == 0;
+}
+
+bool DOwnerNames::fresh(const QHash<quint32, Names> &names, quint32 id, Names *found)
+{
+    auto it = names.constFind(id);
+    if (it == names.constEnd() || it->age.hasExpired(kTimeToLive))
+        return false;
+    *found = it.value();
+    return true;
+}
@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DOWNERNAMES_H
+#define DOWNERNAMES_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <QElapsedTimer>
+
+#include <sys/types.h>
+
+BEGIN_IO_NAMESPACE
+
+// user and group names of the ids files carry, for owner::*. a lookup may go through
+// nss to ldap or sssd, so each id is looked up once and the answer, found or not, is
+// kept for a while. lookups are made one at a time, callers asking for an id being
+// looked up wait for that answer
+class DOwnerNames
+{
+public:
+    static DOwnerNames *instance();
+
+    // the number when the id has no entry
+    QString userName(uid_t uid);
+    // the full name from the gecos field, as gio gives owner::user-real,
+    // the login when that is empty
+    QString userRealName(uid_t uid);
+    QString groupName(gid_t gid);
+
+private:
+    DOwnerNames() = default;
+    Q_DISABLE_COPY(DOwnerNames)
+
+    struct Names
+    {
+        QString name;
+        QString realName;
+        QElapsedTimer age;
+    };
+
+    Names user(uid_t uid);
+    Names group(gid_t gid);
+    static bool lookupUser(uid_t uid, Names *names);
+    static bool lookupGroup(gid_t gid, Names *names);
+    static bool fresh(const QHash<quint32, Names> &names, quint32 id, Names *found);
+
+    QMutex mutex;
+    QMutex lookupMutex;   // held across nss calls, never while mutex is
+    QHash<quint32, Names> users;
+    QHash<quint32, Names> groups;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DOWNERNAMES_H
@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dqueryflight.h"
+
+#include <QMutexLocker>
+
+USING_IO_NAMESPACE
+
+DQueryFlight *DQueryFlight::instance()
+{
+    static DQueryFlight flight;
+    return &flight;
+}
+
+void DQueryFlight::queryInfo(GFile *file, const char *attributes, GFileQueryInfoFlags flags, int ioPriority,
+                             GCancellable *cancellable, Callback callback, gpointer userData)
+{
+    g_autofree gchar *uri = g_file_get_uri(file);
+    QByteArray key(uri);
+    key += '\n';
+    key += attributes;
+    key += '\n';
+    key += QByteArray::number(static_cast<int>(flags));
+    key += '\n';
+    key += QByteArray::number(reinterpret_cast<quintptr>(g_main_context_get_thread_default()));
+
+    const Waiter waiter { callback, userData, cancellable ? G_CANCELLABLE(g_object_ref(cancellable)) : nullptr, ioPriority, 0 };
+
+    Flight *flight = nullptr;
+    int index = 0;
+    bool start = false;
+    {
+        QMutexLocker locker(&mutex);
+        // a cancelled query only finishes, a less urgent one would hold this caller back
+        flight = flights.value(key);
+        if (!flight || g_cancellable_is_cancelled(flight->cancellable) || ioPriority < flight->ioPriority) {
+            flight = new Flight;
+            flight->key = key;
+            flight->file = G_FILE(g_object_ref(file));
+            flight->attributes = attributes;
+            flight->flags = flags;
+            flight->ioPriority = ioPriority;
+            flight->cancellable = g_cancellable_new();
+            flights.insert(key, flight);
+            start = true;
+        }
+        index = flight->waiters.size();
+        flight->waiters.append(waiter);
+    }
+
+    // outside the lock, an already cancelled cancellable runs the handler right away.
+    // the flight finishes on this thread's context, it is still there afterwards
+    if (cancellable) {
+        const gulong handler = g_cancellable_connect(cancellable, G_CALLBACK(waiterCancelled), flight, nullptr);
+        QMutexLocker locker(&mutex);
+        flight->waiters[index].handler = handler;
+    }
+
+    if (start)
+        g_file_query_info_async(flight->file, flight->attributes.constData(), flags, ioPriority, flight->cancellable, finished, flight);
+}
+
+void DQueryFlight::waiterCancelled(GCancellable *cancellable, gpointer userData)
+{
+    Q_UNUSED(cancellable)
+    // the flight is only deleted once its handlers are disconnected
+    Flight *flight = static_cast<Flight *>(userData);
+
+    // the query goes on as long as one caller still wants it
+    GCancellable *flightCancellable = nullptr;
+    {
+        QMutexLocker locker(&instance()->mutex);
+        if (flight->waiters.isEmpty())
+            return;
+        for (const Waiter &waiter : flight->waiters) {
+            if (!g_cancellable_is_cancelled(waiter.cancellable))
+                return;
+        }
+        flightCancellable = G_CANCELLABLE(g_object_ref(flight->cancellable));
+    }
+
+    g_cancellable_cancel(flightCancellable);
+    g_object_unref(flightCancellable);
+}
+
+void DQueryFlight::finished(GObject *sourceObject, GAsyncResult *res, gpointer userData)
+{
+    Flight *flight = static_cast<Flight *>(userData);
+    g_autoptr(GError) gerror = nullptr;
+    GFileInfo *info = g_file_query_info_finish(G_FILE(sourceObject), res, &gerror);
+
+    // nobody joins from here on, a later caller asks anew
+    QVector<Waiter> waiters;
+    {
+        DQueryFlight *self = instance();
+        QMutexLocker locker(&self->mutex);
+        if (self->flights.value(flight->key) == flight)
+            self->flights.remove(flight->key);
+        waiters.swap(flight->waiters);
+    }
+
+    // waits for a handler running on another thread, it takes the mutex
+    for (const Waiter &waiter : waiters)
+        g_cancellable_disconnect(waiter.cancellable, waiter.handler);
+
+    const bool cancelled = gerror && g_error_matches(gerror, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+    for (int i = 0; i < waiters.size(); ++i) {
+        const Waiter &waiter = waiters.at(i);
+        g_autoptr(GError) cancelError = nullptr;
+        if (g_cancellable_set_error_if_cancelled(waiter.cancellable, &cancelError)) {
+            waiter.callback(nullptr, cancelError, waiter.userData);
+        } else if (cancelled) {
+            // joined while the others cancelled, this caller still wants it
+            instance()->queryInfo(flight->file, flight->attributes.constData(), flight->flags, waiter.ioPriority,
+                                  waiter.cancellable, waiter.callback, waiter.userData);
+        } else if (info) {
+            // the last one takes the result, the others a copy they may change freely
+            waiter.callback(i == waiters.size() - 1 ? info : g_file_info_dup(info), nullptr, waiter.userData);
+            if (i == waiters.size() - 1)
+                info = nullptr;
+        } else {
+            waiter.callback(nullptr, gerror, waiter.userData);
+        }
+        if (waiter.cancellable)
+            g_object_unref(waiter.cancellable);
+    }
+
+    if (info)
+        g_object_unref(info);
+    g_object_unref(flight->cancellable);
+    g_object_unref(flight->file);
+    delete flight;
+}
@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DQUERYFLIGHT_H
+#define DQUERYFLIGHT_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+
+#include <gio/gio.h>
+
+BEGIN_IO_NAMESPACE
+
+// async info queries of the same file, attributes and flags asked while one is pending
+// wait for that one instead of asking gio again, on a gvfs mount each query is a round
+// trip. only callers of the same thread default main context are joined, so callbacks
+// still run where they would have. the query has a cancellable of its own, it is only
+// cancelled once every caller cancelled theirs; a caller that cancelled gets
+// G_IO_ERROR_CANCELLED, the others the result. a caller asking with a more urgent
+// priority than the pending query starts a new one, later callers join that
+class DQueryFlight
+{
+public:
+    // info is a reference of the callback's own, null on error. error is only borrowed
+    using Callback = void (*)(GFileInfo *info, GError *error, gpointer userData);
+
+    static DQueryFlight *instance();
+
+    void queryInfo(GFile *file, const char *attributes, GFileQueryInfoFlags flags, int ioPriority,
+                   GCancellable *cancellable, Callback callback, gpointer userData);
+
+private:
+    DQueryFlight() = default;
+    Q_DISABLE_COPY(DQueryFlight)
+
+    struct Waiter
+    {
+        Callback callback;
+        gpointer userData;
+        GCancellable *cancellable;
+        int ioPriority;
+        gulong handler;
+    };
+
+    struct Flight
+    {
+        QByteArray key;
+        GFile *file;
+        QByteArray attributes;
+        GFileQueryInfoFlags flags;
+        int ioPriority;
+        GCancellable *cancellable;
+        QVector<Waiter> waiters;
+    };
+
+    static void finished(GObject *sourceObject, GAsyncResult *res, gpointer userData);
+    static void waiterCancelled(GCancellable *cancellable, gpointer userData);
+
+    QMutex mutex;
+    QHash<QByteArray, Flight *> flights;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DQUERYFLIGHT_H
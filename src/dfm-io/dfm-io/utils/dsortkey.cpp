@@ -0,0 +1,209 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dsortkey.h"
+#include "dlocalhelper.h"
+
+#include <QCollator>
+
+#include <algorithm>
+#include <vector>
+
+#include <string.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+// token classes, in the order compareByString puts them
+constexpr char kTokenEnd = 0x00;
+constexpr char kTokenNumber = 0x01;
+constexpr char kTokenLetter = 0x02;
+constexpr char kTokenHan = 0x03;
+constexpr char kTokenSymbol = 0x04;
+
+// high bit of a han rank: another han character has the same collation weight
+constexpr quint16 kHanRankShared = 0x8000;
+
+// collation rank of every han character of the bmp, built on first use
+const std::vector<quint16> &hanRanks()
+{
+    static const std::vector<quint16> ranks = [] {
+        std::vector<quint16> table(0x10000, 0);
+
+        QCollator collator;
+        collator.setNumericMode(true);
+        collator.setCaseSensitivity(Qt::CaseInsensitive);
+
+        std::vector<std::pair<QCollatorSortKey, quint16>> hans;
+        for (uint code = 0; code < 0x10000; ++code) {
+            const QChar ch(static_cast<ushort>(code));
+            if (ch.script() == QChar::Script_Han)
+                hans.emplace_back(collator.sortKey(QString(ch)), static_cast<quint16>(code));
+        }
+
+        std::sort(hans.begin(), hans.end(), [](const auto &left, const auto &right) {
+            return left.first.compare(right.first) < 0;
+        });
+
+        quint16 rank = 0;
+        for (size_t i = 0; i < hans.size(); ++i) {
+            const bool sameAsPrev = i > 0 && hans[i - 1].first.compare(hans[i].first) == 0;
+            if (!sameAsPrev)
+                ++rank;
+            table[hans[i].second] = rank;
+            if (sameAsPrev) {
+                table[hans[i].second] |= kHanRankShared;
+                table[hans[i - 1].second] |= kHanRankShared;
+            }
+        }
+        return table;
+    }();
+    return ranks;
+}
+
+void appendUInt16(QByteArray *key, quint16 value)
+{
+    key->append(static_cast<char>(value >> 8));
+    key->append(static_cast<char>(value & 0xff));
+}
+
+void appendUInt32(QByteArray *key, quint32 value)
+{
+    appendUInt16(key, static_cast<quint16>(value >> 16));
+    appendUInt16(key, static_cast<quint16>(value & 0xffff));
+}
+}   // namespace
+
+DSortKey::DSortKey(const QString &name)
+    : fileName(name)
+{
+    build();
+}
+
+QString DSortKey::name() const
+{
+    return fileName;
+}
+
+QByteArray DSortKey::key() const
+{
+    return sortKey;
+}
+
+bool DSortKey::isExact() const
+{
+    return exact;
+}
+
+bool DSortKey::lessThan(const DSortKey &left, const DSortKey &right)
+{
+    return compare(left, right) < 0;
+}
+
+int DSortKey::compare(const DSortKey &left, const DSortKey &right)
+{
+    const int length = qMin(left.sortKey.size(), right.sortKey.size());
+    const int ret = memcmp(left.sortKey.constData(), right.sortKey.constData(), static_cast<size_t>(length));
+    if (ret != 0)
+        return ret;
+    if (left.sortKey.size() != right.sortKey.size())
+        return left.sortKey.size() - right.sortKey.size();
+
+    // equal keys differ in case or behind an early stop, like compareByString
+    // case is ignored first
+    const int ignoringCase = left.fileName.compare(right.fileName, Qt::CaseInsensitive);
+    if (ignoringCase != 0)
+        return ignoringCase;
+    return left.fileName.compare(right.fileName);
+}
+
+// mirrors the rules of DLocalHelper::compareByStringEx, see there
+void DSortKey::build()
+{
+    const int total = fileName.length();
+    const int dot = fileName.lastIndexOf(".");
+    // no dot: name and suffix are both the whole string
+    const int nameLength = dot < 0 ? total : dot;
+    const int suffixPos = dot + 1;
+
+    sortKey.reserve(nameLength * 2 + (total - suffixPos) * 2 + 1);
+
+    int i = 0;
+    while (i < nameLength) {
+        const QChar ch = fileName.at(i);
+
+        if (DLocalHelper::isNumber(ch)) {
+            int end = i;
+            int zeros = 0;
+            quint64 value = 0;
+            bool overflow = false;
+            while (end < nameLength && DLocalHelper::isNumber(fileName.at(end))) {
+                const quint64 digit = static_cast<quint64>(fileName.at(end).unicode() - '0');
+                if (value == 0 && digit == 0)
+                    ++zeros;
+                if (!overflow) {
+                    value = value * 10 + digit;
+                    overflow = value > 0xffffffffu;
+                }
+                ++end;
+            }
+
+            // QString::toUInt gives 0 on overflow
+            if (overflow)
+                value = 0;
+            sortKey.append(kTokenNumber);
+            appendUInt32(&sortKey, static_cast<quint32>(value));
+            // equal values with different zeros depend on what follows them
+            if (overflow || value == 0 || zeros > 0xfe) {
+                exact = false;
+                return;
+            }
+            // more leading zeros sort first
+            sortKey.append(static_cast<char>(0xff - zeros));
+            i = end;
+            continue;
+        }
+
+        if (DLocalHelper::isNumOrChar(ch)) {
+            sortKey.append(kTokenLetter);
+            sortKey.append(static_cast<char>(ch.toLower().unicode()));
+            ++i;
+            continue;
+        }
+
+        if (ch.script() == QChar::Script_Han) {
+            const quint16 rank = hanRanks()[ch.unicode()];
+            sortKey.append(kTokenHan);
+            appendUInt16(&sortKey, rank & ~kHanRankShared);
+            if (rank & kHanRankShared) {
+                exact = false;
+                return;
+            }
+            ++i;
+            continue;
+        }
+
+        // symbols compare by code, but are skipped when equal ignoring case.
+        // lowercased they still sort among the symbols, one lowercased into
+        // ascii would meet the letters, that is no order a key can express
+        const QChar lower = ch.toLower();
+        if (lower != ch || ch.toUpper() != ch) {
+            exact = false;
+            if (lower.unicode() < 0x80)
+                return;
+            sortKey.append(kTokenSymbol);
+            appendUInt16(&sortKey, lower.unicode());
+            ++i;
+            continue;
+        }
+
+        sortKey.append(kTokenSymbol);
+        appendUInt16(&sortKey, ch.unicode());
+        ++i;
+    }
+
+    sortKey.append(kTokenEnd);
+    for (int j = suffixPos; j < total; ++j)
+        appendUInt16(&sortKey, fileName.at(j).unicode());
+}
@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DSORTKEY_H
+#define DSORTKEY_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QString>
+#include <QByteArray>
+
+BEGIN_IO_NAMESPACE
+
+// a file name turned once into a binary key, comparing two keys with memcmp gives
+// the same result as DLocalHelper::compareByString on the names.
+// tokens: digit runs as numbers, ascii letters lowercased, han characters as
+// collation ranks, symbols last, then the suffix as tie-break.
+// cased non ascii letters are symbols lowercased, compareByString skips them when
+// equal ignoring case but compares different ones by their own code, which no key
+// can follow; the key orders them by the lowercased code, digit runs after them
+// still compare as numbers. where a letter lowercases into ascii, a digit run is
+// zero valued or han characters the collator sees as equal, the key stops early.
+// such a key sorts before every longer key it is a prefix of. keys that compare
+// equal are ordered by the names ignoring case, then as they are, so the order is
+// total; it only may differ from compareByString where isExact() is false.
+class DSortKey
+{
+public:
+    DSortKey() = default;
+    explicit DSortKey(const QString &name);
+
+    QString name() const;
+    QByteArray key() const;
+    bool isExact() const;
+
+    static bool lessThan(const DSortKey &left, const DSortKey &right);
+    // the order of lessThan, 0 only for equal names
+    static int compare(const DSortKey &left, const DSortKey &right);
+
+private:
+    void build();
+
+    QString fileName;
+    QByteArray sortKey;
+    bool exact { true };
+};
+
+END_IO_NAMESPACE
+
+#endif   // DSORTKEY_H
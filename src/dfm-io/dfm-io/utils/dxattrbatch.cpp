@@ -0,0 +1,312 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dxattrbatch.h"
+
+#include <gio/gio.h>
+
+#include <vector>
+
+#include <sys/xattr.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+const QByteArray kUserKey("xattr::");
+const QByteArray kSysKey("xattr-sys::");
+const QByteArray kUserNamespace("user.");
+
+// most values fit, larger ones are asked for their size first
+constexpr size_t kValueBuffer = 4096;
+
+bool isPrintable(char c)
+{
+    return c >= 32 && c <= 126 && c != '\\';
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// -1 and errno set on failure, ENODATA when the file has no such attribute
+ssize_t getValue(const char *path, const char *name, QByteArray *value)
+{
+    char buffer[kValueBuffer];
+    ssize_t size = getxattr(path, name, buffer, sizeof(buffer));
+    if (size >= 0) {
+        *value = QByteArray(buffer, static_cast<int>(size));
+        return size;
+    }
+
+    while (errno == ERANGE) {
+        size = getxattr(path, name, nullptr, 0);
+        if (size < 0)
+            return size;
+        std::vector<char> large(static_cast<size_t>(size));
+        size = getxattr(path, name, large.data(), large.size());
+        if (size >= 0) {
+            *value = QByteArray(large.data(), static_cast<int>(size));
+            return size;
+        }
+    }
+    return -1;
+}
+
+// the names of the user attributes of path, false and errno set on failure
+bool userNames(const char *path, QList<QByteArray> *names)
+{
+    ssize_t size = listxattr(path, nullptr, 0);
+    std::vector<char> buffer;
+    while (size > 0) {
+        buffer.resize(static_cast<size_t>(size));
+        size = listxattr(path, buffer.data(), buffer.size());
+        if (size >= 0 || errno != ERANGE)
+            break;
+        size = listxattr(path, nullptr, 0);
+    }
+    if (size < 0)
+        return false;
+
+    for (ssize_t begin = 0; begin < size;) {
+        const QByteArray name(buffer.data() + begin);
+        if (name.startsWith(kUserNamespace))
+            names->append(name);
+        begin += name.size() + 1;
+    }
+    return true;
+}
+}   // namespace
+
+DXattrBatch::DXattrBatch(const QList<QUrl> &urls)
+    : urls(urls)
+{
+}
+
+QList<DFileInfo::ExtendedAttributes> DXattrBatch::read(const QList<QByteArray> &keys)
+{
+    QVector<DFileInfo::ExtendedAttributes> results(urls.size());
+    QList<QByteArray> names;
+    for (const QByteArray &key : keys)
+        names.append(nameOf(key));
+
+    const QHash<QString, QVector<int>> &dirs = groupByDir();
+    for (auto it = dirs.constBegin(); it != dirs.constEnd(); ++it) {
+        // O_PATH is enough to resolve names against and works on dirs that can't be read
+        const int fd = open(it.key().toLocal8Bit().constData(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            for (int index : it.value())
+                readGio(urls.at(index), keys, &results[index]);
+            continue;
+        }
+        const QByteArray &prefix = dirPrefix(fd, it.key());
+        for (int index : it.value())
+            readLocal(prefix + urls.at(index).fileName(QUrl::FullyDecoded).toLocal8Bit(), names, &results[index]);
+        close(fd);
+    }
+    for (int index : gioIndexes)
+        readGio(urls.at(index), keys, &results[index]);
+
+    return results.toList();
+}
+
+QList<DFMIOError> DXattrBatch::write(const Values &values)
+{
+    QVector<DFMIOError> errors(urls.size());
+
+    const QHash<QString, QVector<int>> &dirs = groupByDir();
+    for (auto it = dirs.constBegin(); it != dirs.constEnd(); ++it) {
+        const int fd = open(it.key().toLocal8Bit().constData(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            for (int index : it.value())
+                errors[index] = writeGio(urls.at(index), values);
+            continue;
+        }
+        const QByteArray &prefix = dirPrefix(fd, it.key());
+        for (int index : it.value())
+            errors[index] = writeLocal(prefix + urls.at(index).fileName(QUrl::FullyDecoded).toLocal8Bit(), values);
+        close(fd);
+    }
+    for (int index : gioIndexes)
+        errors[index] = writeGio(urls.at(index), values);
+
+    return errors.toList();
+}
+
+QByteArray DXattrBatch::nameOf(const QByteArray &key)
+{
+    if (key.startsWith(kUserKey))
+        return kUserNamespace + unescape(key.mid(kUserKey.size()));
+    if (key.startsWith(kSysKey))
+        return unescape(key.mid(kSysKey.size()));
+    return key;
+}
+
+QByteArray DXattrBatch::keyOf(const QByteArray &name)
+{
+    if (name.startsWith(kUserNamespace))
+        return kUserKey + escape(name.mid(kUserNamespace.size()));
+    return kSysKey + escape(name);
+}
+
+QByteArray DXattrBatch::escape(const QByteArray &value)
+{
+    static const char kHex[] = "0123456789abcdef";
+    QByteArray escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (isPrintable(c)) {
+            escaped.append(c);
+            continue;
+        }
+        const uchar byte = static_cast<uchar>(c);
+        escaped.append("\\x");
+        escaped.append(kHex[byte >> 4]);
+        escaped.append(kHex[byte & 0xf]);
+    }
+    return escaped;
+}
+
+QByteArray DXattrBatch::unescape(const QByteArray &value)
+{
+    QByteArray raw;
+    raw.reserve(value.size());
+    for (int i = 0; i < value.size(); ++i) {
+        if (value.at(i) == '\\' && i + 3 < value.size() && value.at(i + 1) == 'x') {
+            const int high = hexValue(value.at(i + 2));
+            const int low = hexValue(value.at(i + 3));
+            if (high >= 0 && low >= 0) {
+                raw.append(static_cast<char>(high << 4 | low));
+                i += 3;
+                continue;
+            }
+        }
+        raw.append(value.at(i));
+    }
+    return raw;
+}
+
+QHash<QString, QVector<int>> DXattrBatch::groupByDir()
+{
+    QHash<QString, QVector<int>> dirs;
+    gioIndexes.clear();
+    for (int i = 0; i < urls.size(); ++i) {
+        const QUrl &url = urls.at(i);
+        if (url.isLocalFile()) {
+            const QString &path = url.toLocalFile();
+            const int slash = path.lastIndexOf('/');
+            if (slash >= 0 && slash < path.length() - 1) {
+                dirs[slash == 0 ? QString("/") : path.left(slash)].append(i);
+                continue;
+            }
+        }
+        gioIndexes.append(i);
+    }
+    return dirs;
+}
+
+QByteArray DXattrBatch::dirPrefix(int fd, const QString &dirPath)
+{
+    // there are no *xattrat calls, the fd is named through procfs so only the last
+    // component is looked up per file. without procfs the dir path is walked each time
+    const QByteArray &procPath = "/proc/self/fd/" + QByteArray::number(fd);
+    if (::access(procPath.constData(), F_OK) == 0)
+        return procPath + '/';
+    QByteArray prefix = dirPath.toLocal8Bit();
+    if (!prefix.endsWith('/'))
+        prefix += '/';
+    return prefix;
+}
+
+DFMIOError DXattrBatch::errorFromErrno(int errnum)
+{
+    return DFMIOError(DFMIOErrorCode(g_io_error_from_errno(errnum)));
+}
+
+void DXattrBatch::readLocal(const QByteArray &path, const QList<QByteArray> &names, DFileInfo::ExtendedAttributes *result)
+{
+    QList<QByteArray> all;
+    if (names.isEmpty() && !userNames(path.constData(), &all)) {
+        result->error = errorFromErrno(errno);
+        return;
+    }
+
+    for (const QByteArray &name : names.isEmpty() ? all : names) {
+        QByteArray value;
+        if (getValue(path.constData(), name.constData(), &value) >= 0) {
+            result->values.insert(keyOf(name), value);
+        } else if (errno != ENODATA) {
+            result->error = errorFromErrno(errno);
+            return;
+        }
+    }
+}
+
+void DXattrBatch::readGio(const QUrl &url, const QList<QByteArray> &keys, DFileInfo::ExtendedAttributes *result)
+{
+    const QByteArray &attributes = keys.isEmpty() ? QByteArray("xattr::*") : keys.join(',');
+    g_autoptr(GFile) gfile = g_file_new_for_uri(url.toString().toLocal8Bit().constData());
+    g_autoptr(GError) gerror = nullptr;
+    g_autoptr(GFileInfo) info = g_file_query_info(gfile, attributes.constData(), G_FILE_QUERY_INFO_NONE, nullptr, &gerror);
+    if (!info) {
+        result->error = DFMIOError(DFMIOErrorCode(gerror ? gerror->code : DFM_IO_ERROR_FAILED));
+        if (gerror && result->error.code() == DFM_IO_ERROR_FAILED)
+            result->error.setMessage(gerror->message);
+        return;
+    }
+
+    g_auto(GStrv) names = g_file_info_list_attributes(info, nullptr);
+    for (int i = 0; names && names[i]; ++i) {
+        const QByteArray key(names[i]);
+        if (!key.startsWith(kUserKey) && !key.startsWith(kSysKey))
+            continue;
+        result->values.insert(key, unescape(g_file_info_get_attribute_string(info, names[i])));
+    }
+}
+
+DFMIOError DXattrBatch::writeLocal(const QByteArray &path, const Values &values)
+{
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        const QByteArray &name = nameOf(it.key());
+        if (it.value().isNull()) {
+            if (removexattr(path.constData(), name.constData()) != 0 && errno != ENODATA)
+                return errorFromErrno(errno);
+            continue;
+        }
+        if (setxattr(path.constData(), name.constData(), it.value().constData(), static_cast<size_t>(it.value().size()), 0) != 0)
+            return errorFromErrno(errno);
+    }
+    return DFMIOError();
+}
+
+DFMIOError DXattrBatch::writeGio(const QUrl &url, const Values &values)
+{
+    // all keys of the file in one call
+    g_autoptr(GFileInfo) info = g_file_info_new();
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        if (it.value().isNull())
+            g_file_info_set_attribute(info, it.key().constData(), G_FILE_ATTRIBUTE_TYPE_INVALID, nullptr);
+        else
+            g_file_info_set_attribute_string(info, it.key().constData(), escape(it.value()).constData());
+    }
+
+    g_autoptr(GFile) gfile = g_file_new_for_uri(url.toString().toLocal8Bit().constData());
+    g_autoptr(GError) gerror = nullptr;
+    if (g_file_set_attributes_from_info(gfile, info, G_FILE_QUERY_INFO_NONE, nullptr, &gerror))
+        return DFMIOError();
+
+    DFMIOError error(DFMIOErrorCode(gerror ? gerror->code : DFM_IO_ERROR_FAILED));
+    if (gerror && error.code() == DFM_IO_ERROR_FAILED)
+        error.setMessage(gerror->message);
+    return error;
+}
@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DXATTRBATCH_H
+#define DXATTRBATCH_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/dfileinfo.h>
+
+#include <QList>
+#include <QUrl>
+#include <QMap>
+#include <QHash>
+#include <QVector>
+#include <QByteArray>
+
+BEGIN_IO_NAMESPACE
+
+// reads or writes extended attributes of many files. local files are grouped by their dir
+// and reached through the dir fd with plain getxattr, setxattr and listxattr. others get
+// one gio query or one g_file_set_attributes_from_info each, whatever number of keys
+class DXattrBatch
+{
+public:
+    using Values = QMap<QByteArray, QByteArray>;
+
+    explicit DXattrBatch(const QList<QUrl> &urls);
+
+    // empty keys read every user attribute
+    QList<DFileInfo::ExtendedAttributes> read(const QList<QByteArray> &keys);
+    // a null value removes the key
+    QList<DFMIOError> write(const Values &values);
+
+    // the xattr name behind a gio key: xattr::name is user.name, xattr-sys::name is name
+    static QByteArray nameOf(const QByteArray &key);
+    static QByteArray keyOf(const QByteArray &name);
+    // gio hands xattr values over as strings with bytes outside printable ascii as \xNN
+    static QByteArray escape(const QByteArray &value);
+    static QByteArray unescape(const QByteArray &value);
+
+private:
+    // local urls by their dir, the rest go to gioIndexes
+    QHash<QString, QVector<int>> groupByDir();
+    // what the files of the dir open as fd are reached by, the dir itself in /proc/self/fd
+    static QByteArray dirPrefix(int fd, const QString &dirPath);
+    static DFMIOError errorFromErrno(int errnum);
+    static void readLocal(const QByteArray &path, const QList<QByteArray> &names, DFileInfo::ExtendedAttributes *result);
+    static void readGio(const QUrl &url, const QList<QByteArray> &keys, DFileInfo::ExtendedAttributes *result);
+    static DFMIOError writeLocal(const QByteArray &path, const Values &values);
+    static DFMIOError writeGio(const QUrl &url, const Values &values);
+
+    QList<QUrl> urls;
+    QVector<int> gioIndexes;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DXATTRBATCH_H
@@ -0,0 +1,310 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/denumerator.h>
+#include <dfm-io/dfileinfo.h>
+#include <dfm-io/dsortedlisting.h>
+
+#include <stdio.h>
+#include <malloc.h>
+
+#include <QUrl>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QCoreApplication>
+
+USING_IO_NAMESPACE
+
+static void err_msg(const char *msg)
+{
+    fprintf(stderr, "dfm-benchmark: %s\n", msg);
+}
+
+static void print_result(const char *name, qint64 ms, quint64 count)
+{
+    fprintf(stdout, "%-24s %8lld ms  %10llu entries\n", name, static_cast<long long>(ms), static_cast<unsigned long long>(count));
+}
+
+// enumerate url and read what a list view needs for every entry
+static quint64 list_once(const QUrl &url, const QList<DFileInfo::AttributeID> &attributes)
+{
+    DEnumerator enumerator(url);
+    enumerator.setQueryAttributes(attributes);
+
+    quint64 count = 0;
+    quint64 total = 0;
+    while (enumerator.hasNext()) {
+        const QSharedPointer<DFileInfo> &info = enumerator.fileInfo();
+        if (!info)
+            continue;
+        info->attribute(DFileInfo::AttributeID::kStandardName);
+        info->attribute(DFileInfo::AttributeID::kStandardIsDir);
+        total += info->attribute(DFileInfo::AttributeID::kStandardSize).toULongLong();
+        total += info->attribute(DFileInfo::AttributeID::kTimeModified).toULongLong();
+        ++count;
+    }
+    Q_UNUSED(total)
+    return count;
+}
+
+// the same through the typed accessors
+static quint64 list_typed_once(const QUrl &url, const QList<DFileInfo::AttributeID> &attributes)
+{
+    DEnumerator enumerator(url);
+    enumerator.setQueryAttributes(attributes);
+
+    quint64 count = 0;
+    quint64 total = 0;
+    while (enumerator.hasNext()) {
+        const QSharedPointer<DFileInfo> &info = enumerator.fileInfo();
+        if (!info)
+            continue;
+        info->get<DFileInfo::AttributeID::kStandardName>();
+        info->get<DFileInfo::AttributeID::kStandardIsDir>();
+        total += info->get<DFileInfo::AttributeID::kStandardSize>();
+        total += info->get<DFileInfo::AttributeID::kTimeModified>();
+        ++count;
+    }
+    Q_UNUSED(total)
+    return count;
+}
+
+static void bench_list(const QUrl &url)
+{
+    const QList<DFileInfo::AttributeID> projection {
+        DFileInfo::AttributeID::kStandardName,
+        DFileInfo::AttributeID::kStandardIsDir,
+        DFileInfo::AttributeID::kStandardSize,
+        DFileInfo::AttributeID::kTimeModified
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+    quint64 count = list_once(url, {});
+    print_result("list (default attrs)", timer.elapsed(), count);
+
+    timer.restart();
+    count = list_once(url, projection);
+    print_result("list (projection)", timer.elapsed(), count);
+
+    timer.restart();
+    count = list_typed_once(url, projection);
+    print_result("list (typed get)", timer.elapsed(), count);
+}
+
+// walk the whole tree below url, serially and with more threads
+static void bench_walk(const QUrl &url)
+{
+    const int maxThreads = qMax(2, QThread::idealThreadCount());
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        QElapsedTimer timer;
+        timer.start();
+
+        DEnumerator enumerator(url, {}, DEnumerator::DirFilter::kNoFilter, DEnumerator::IteratorFlag::kSubdirectories);
+        enumerator.setMaxThreadCount(threads);
+        quint64 count = 0;
+        while (enumerator.hasNext())
+            ++count;
+
+        const QByteArray &name = QString("walk (%1 threads)").arg(threads).toLocal8Bit();
+        print_result(name.constData(), timer.elapsed(), count);
+    }
+}
+
+// sort the children of url by every role
+static void bench_sort(const QUrl &url)
+{
+    const QList<QPair<const char *, DEnumerator::SortRoleCompareFlag>> roles {
+        { "sort (name)", DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileName },
+        { "sort (size)", DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileSize },
+        { "sort (modified)", DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileLastModified }
+    };
+
+    for (const auto &role : roles) {
+        QElapsedTimer timer;
+        timer.start();
+
+        DEnumerator enumerator(url);
+        enumerator.setSortRole(role.second);
+        const auto &list = enumerator.sortFileInfoList();
+        print_result(role.first, timer.elapsed(), static_cast<quint64>(list.size()));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    DEnumerator enumerator(url);
+    enumerator.setSortRole(DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileName);
+    const auto &page = enumerator.sortFileInfoList(200);
+    print_result("sort (first 200)", timer.elapsed(), static_cast<quint64>(page.size()));
+    const auto &rest = enumerator.remainingSortFileInfoList();
+    print_result("sort (remaining)", timer.elapsed(), static_cast<quint64>(rest.size()));
+}
+
+// query the children of url one by one and as one batch
+static void bench_query(const QUrl &url)
+{
+    QList<QUrl> urls;
+    DEnumerator enumerator(url);
+    enumerator.setQueryAttributes({ DFileInfo::AttributeID::kStandardName });
+    while (enumerator.hasNext())
+        urls.append(enumerator.next());
+
+    const QList<DFileInfo::AttributeID> projection {
+        DFileInfo::AttributeID::kStandardSize,
+        DFileInfo::AttributeID::kTimeModified
+    };
+    const QByteArray &attributes = "standard::name,standard::type,standard::size,time::modified";
+
+    QElapsedTimer timer;
+    timer.start();
+    quint64 count = 0;
+    for (const QUrl &child : urls) {
+        DFileInfo info(child, attributes.constData());
+        if (info.initQuerier())
+            ++count;
+    }
+    print_result("query (one by one)", timer.elapsed(), count);
+
+    timer.restart();
+    count = 0;
+    for (const auto &info : DFileInfo::queryBatch(urls, projection))
+        count += info ? 1 : 0;
+    print_result("query (batch)", timer.elapsed(), count);
+}
+
+// read the six time attributes of every child, gio is not asked for them
+// so they all come from statx on the file
+static void bench_times(const QUrl &url)
+{
+    const QList<DFileInfo::AttributeID> times {
+        DFileInfo::AttributeID::kTimeCreated,
+        DFileInfo::AttributeID::kTimeCreatedUsec,
+        DFileInfo::AttributeID::kTimeModified,
+        DFileInfo::AttributeID::kTimeModifiedUsec,
+        DFileInfo::AttributeID::kTimeAccess,
+        DFileInfo::AttributeID::kTimeAccessUsec
+    };
+
+    DEnumerator enumerator(url);
+    enumerator.setQueryAttributes({ DFileInfo::AttributeID::kStandardName });
+
+    QElapsedTimer timer;
+    timer.start();
+    quint64 count = 0;
+    quint64 total = 0;
+    while (enumerator.hasNext()) {
+        const QSharedPointer<DFileInfo> &info = enumerator.fileInfo();
+        if (!info)
+            continue;
+        for (const DFileInfo::AttributeID id : times)
+            total += info->attribute(id).toULongLong();
+        ++count;
+    }
+    Q_UNUSED(total)
+    print_result("times (6 attributes)", timer.elapsed(), count);
+}
+
+// bytes handed out by malloc right now
+static qint64 heap_used()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const struct mallinfo2 info = mallinfo2();
+    return static_cast<qint64>(info.uordblks + info.hblkhd);
+#else
+    const struct mallinfo info = mallinfo();
+    return static_cast<qint64>(info.uordblks) + info.hblkhd;
+#endif
+}
+
+static void print_memory(const char *name, qint64 bytes, quint64 count)
+{
+    fprintf(stdout, "%-24s %8lld KB  %10llu entries  %6lld B/entry\n", name, static_cast<long long>(bytes / 1024),
+            static_cast<unsigned long long>(count), static_cast<long long>(count ? bytes / static_cast<qint64>(count) : 0));
+}
+
+template<typename List>
+static List sorted_list(const QUrl &url, List (DEnumerator::*take)())
+{
+    DEnumerator enumerator(url);
+    enumerator.setSortRole(DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileName);
+    return (enumerator.*take)();
+}
+
+// heap held by a sorted listing of url, as SortFileInfo list and as DSortedListing.
+// the enumerator is gone when measuring, only the result is counted
+static void bench_mem(const QUrl &url)
+{
+    using SortFileInfoList = QList<QSharedPointer<DEnumerator::SortFileInfo>>;
+
+    // fills the process wide caches first
+    sorted_list<DSortedListing>(url, &DEnumerator::sortedListing);
+
+    quint64 dirs = 0;
+    {
+        const qint64 before = heap_used();
+        const SortFileInfoList &list = sorted_list<SortFileInfoList>(url, &DEnumerator::sortFileInfoList);
+        print_memory("mem (SortFileInfo)", heap_used() - before, static_cast<quint64>(list.size()));
+
+        QElapsedTimer timer;
+        timer.start();
+        for (const auto &info : list)
+            dirs += info->isDir ? 1 : 0;
+        print_result("iterate (SortFileInfo)", timer.elapsed(), static_cast<quint64>(list.size()));
+    }
+
+    {
+        const qint64 before = heap_used();
+        const DSortedListing &listing = sorted_list<DSortedListing>(url, &DEnumerator::sortedListing);
+        print_memory("mem (DSortedListing)", heap_used() - before, static_cast<quint64>(listing.size()));
+
+        QElapsedTimer timer;
+        timer.start();
+        for (const auto &entry : listing)
+            dirs += entry.isDir() ? 1 : 0;
+        print_result("iterate (DSortedListing)", timer.elapsed(), static_cast<quint64>(listing.size()));
+    }
+    Q_UNUSED(dirs)
+}
+
+static void usage()
+{
+    err_msg("usage: dfm-benchmark list|walk|sort|mem|query|times dir.");
+}
+
+// measure the hot paths of dfm-io against a real directory.
+int main(int argc, char *argv[])
+{
+    if (argc != 3) {
+        usage();
+        return 1;
+    }
+
+    QCoreApplication a(argc, argv);
+
+    const QUrl &url = QUrl::fromLocalFile(QString::fromLocal8Bit(argv[2]));
+    if (!url.isValid()) {
+        usage();
+        return 1;
+    }
+
+    if (strcmp(argv[1], "list") == 0) {
+        bench_list(url);
+    } else if (strcmp(argv[1], "walk") == 0) {
+        bench_walk(url);
+    } else if (strcmp(argv[1], "sort") == 0) {
+        bench_sort(url);
+    } else if (strcmp(argv[1], "mem") == 0) {
+        bench_mem(url);
+    } else if (strcmp(argv[1], "query") == 0) {
+        bench_query(url);
+    } else if (strcmp(argv[1], "times") == 0) {
+        bench_times(url);
+    } else {
+        usage();
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <utils/dcontenttypecache.h>
+#include <utils/dlocalenumerator.h>
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+
+#include <gtest/gtest.h>
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+QByteArray gioFastContentType(const QString &path, bool followSymlinks)
+{
+    g_autoptr(GFile) file = g_file_new_for_path(path.toLocal8Bit().constData());
+    g_autoptr(GFileInfo) info = g_file_query_info(file, G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE,
+                                                  followSymlinks ? G_FILE_QUERY_INFO_NONE : G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
+                                                  nullptr, nullptr);
+    if (!info)
+        return QByteArray();
+    return QByteArray(g_file_info_get_attribute_string(info, G_FILE_ATTRIBUTE_STANDARD_FAST_CONTENT_TYPE));
+}
+
+// what the native enumerator passes, the type and size of the target when following
+QByteArray nativeFastContentType(const QString &path, bool followSymlinks)
+{
+    const QByteArray &local = path.toLocal8Bit();
+    struct stat st;
+    if (lstat(local.constData(), &st) != 0)
+        return QByteArray();
+    if (followSymlinks && S_ISLNK(st.st_mode) && stat(local.constData(), &st) != 0)
+        lstat(local.constData(), &st);
+    const QByteArray &name = QFileInfo(path).fileName().toLocal8Bit();
+    return DLocalEnumerator::fastContentType(name.constData(), static_cast<unsigned char>(IFTODT(st.st_mode)), st.st_size);
+}
+
+DContentTypeCache::Key keyOf(const QString &path)
+{
+    struct stat st;
+    DContentTypeCache::Key key;
+    if (stat(path.toLocal8Bit().constData(), &st) != 0)
+        return key;
+    key.dev = st.st_dev;
+    key.ino = st.st_ino;
+    key.modifiedNs = static_cast<qint64>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    key.size = st.st_size;
+    return key;
+}
+
+bool writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+}   // namespace
+
+TEST(DContentTypeCache, FastContentTypeMatchesGio)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_TRUE(writeFile(dir.filePath("notes.txt"), "some text\n"));
+    ASSERT_TRUE(writeFile(dir.filePath("photo.png"), "not really a png"));
+    ASSERT_TRUE(writeFile(dir.filePath("noextension"), "#!/bin/sh\n"));
+    ASSERT_TRUE(writeFile(dir.filePath("empty.txt"), QByteArray()));
+    ASSERT_TRUE(QDir(dir.path()).mkdir("folder"));
+    ASSERT_EQ(symlink("notes.txt", dir.filePath("link").toLocal8Bit().constData()), 0);
+    ASSERT_EQ(symlink("folder", dir.filePath("folderlink").toLocal8Bit().constData()), 0);
+    ASSERT_EQ(symlink("missing", dir.filePath("broken").toLocal8Bit().constData()), 0);
+
+    const QStringList names { "notes.txt", "photo.png", "noextension", "empty.txt", "folder", "link", "folderlink", "broken" };
+    for (const QString &name : names) {
+        for (bool follow : { false, true }) {
+            const QString &path = dir.filePath(name);
+            EXPECT_EQ(nativeFastContentType(path, follow), gioFastContentType(path, follow))
+                    << name.toStdString() << (follow ? " followed" : "");
+        }
+    }
+}
+
+TEST(DContentTypeCache, KeyedByFileStamp)
+{
+    QTemporaryDir dir;
+    const QString &path = dir.filePath("a.txt");
+    ASSERT_TRUE(writeFile(path, "first"));
+    const DContentTypeCache::Key &key = keyOf(path);
+
+    DContentTypeCache cache;
+    EXPECT_TRUE(cache.find(key).isEmpty());
+    cache.insert(key, "text/plain");
+    EXPECT_EQ(cache.find(key), QByteArray("text/plain"));
+
+    DContentTypeCache::Key otherFile = key;
+    otherFile.ino += 1;
+    EXPECT_TRUE(cache.find(otherFile).isEmpty());
+    DContentTypeCache::Key otherDevice = key;
+    otherDevice.dev += 1;
+    EXPECT_TRUE(cache.find(otherDevice).isEmpty());
+    EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(DContentTypeCache, ChangedFileIsDropped)
+{
+    QTemporaryDir dir;
+    const QString &path = dir.filePath("a.txt");
+    ASSERT_TRUE(writeFile(path, "first"));
+    const DContentTypeCache::Key &before = keyOf(path);
+
+    DContentTypeCache cache;
+    cache.insert(before, "text/plain");
+
+    // same size, only the mtime tells the change
+    const struct timespec times[2] = { { 0, UTIME_OMIT }, { before.modifiedNs / 1000000000 + 10, 0 } };
+    ASSERT_TRUE(writeFile(path, "other"));
+    ASSERT_EQ(utimensat(AT_FDCWD, path.toLocal8Bit().constData(), times, 0), 0);
+    const DContentTypeCache::Key &after = keyOf(path);
+    ASSERT_EQ(after.ino, before.ino);
+    ASSERT_EQ(after.size, before.size);
+    ASSERT_NE(after.modifiedNs, before.modifiedNs);
+
+    EXPECT_TRUE(cache.find(after).isEmpty());
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_TRUE(cache.find(before).isEmpty());
+}
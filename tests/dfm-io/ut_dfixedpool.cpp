@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <utils/dfixedpool.h>
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <vector>
+
+USING_IO_NAMESPACE
+
+TEST(DFixedPool, BlockSize)
+{
+    DFixedPool pool(1, 4);
+    EXPECT_GE(pool.blockSize(), sizeof(void *));
+    EXPECT_EQ(pool.blockSize() % alignof(std::max_align_t), 0u);
+}
+
+TEST(DFixedPool, DistinctBlocks)
+{
+    DFixedPool pool(40, 3);
+    std::set<void *> blocks;
+    for (int i = 0; i < 10; ++i) {
+        void *block = pool.allocate();
+        ASSERT_NE(block, nullptr);
+        EXPECT_EQ(reinterpret_cast<quintptr>(block) % alignof(std::max_align_t), 0u);
+        EXPECT_TRUE(blocks.insert(block).second);
+    }
+    for (void *block : blocks)
+        pool.deallocate(block);
+}
+
+TEST(DFixedPool, ReusesFreedBlocks)
+{
+    DFixedPool pool(64, 8);
+    void *first = pool.allocate();
+    pool.deallocate(first);
+    EXPECT_EQ(pool.allocate(), first);
+    pool.deallocate(first);
+    pool.deallocate(nullptr);
+}
+
+TEST(DFixedPool, GivesBackEmptyChunks)
+{
+    DFixedPool pool(64, 4);
+    std::vector<void *> blocks;
+    for (int i = 0; i < 40; ++i)
+        blocks.push_back(pool.allocate());
+    EXPECT_EQ(pool.chunks.size(), 10u);
+
+    // a chunk stays while one of its blocks is in use
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (i % 4 != 0)
+            pool.deallocate(blocks[i]);
+    }
+    EXPECT_EQ(pool.chunks.size(), 10u);
+
+    for (size_t i = 0; i < blocks.size(); i += 4)
+        pool.deallocate(blocks[i]);
+    // one empty chunk is kept for the next allocation
+    EXPECT_EQ(pool.chunks.size(), 1u);
+
+    void *block = pool.allocate();
+    EXPECT_EQ(pool.chunks.size(), 1u);
+    pool.deallocate(block);
+}
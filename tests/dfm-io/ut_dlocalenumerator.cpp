@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <utils/dlocalenumerator.h>
+#include <utils/dlocalhelper.h>
+
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+// what the native listing fills that gio derives from more than one stat
+const char *const kComparedKeys[] = {
+    G_FILE_ATTRIBUTE_STANDARD_NAME,
+    G_FILE_ATTRIBUTE_STANDARD_TYPE,
+    G_FILE_ATTRIBUTE_STANDARD_DISPLAY_NAME,
+    G_FILE_ATTRIBUTE_STANDARD_EDIT_NAME,
+    G_FILE_ATTRIBUTE_STANDARD_COPY_NAME,
+    G_FILE_ATTRIBUTE_STANDARD_SYMLINK_TARGET,
+    G_FILE_ATTRIBUTE_STANDARD_SIZE,
+    G_FILE_ATTRIBUTE_ETAG_VALUE,
+    G_FILE_ATTRIBUTE_ID_FILE,
+    G_FILE_ATTRIBUTE_ACCESS_CAN_READ,
+    G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE,
+    G_FILE_ATTRIBUTE_ACCESS_CAN_DELETE,
+    G_FILE_ATTRIBUTE_ACCESS_CAN_RENAME,
+    G_FILE_ATTRIBUTE_ACCESS_CAN_TRASH,
+    G_FILE_ATTRIBUTE_TIME_MODIFIED,
+    G_FILE_ATTRIBUTE_UNIX_MODE,
+    G_FILE_ATTRIBUTE_UNIX_IS_MOUNTPOINT,
+};
+
+QByteArray attributeText(GFileInfo *info, const char *key)
+{
+    if (!g_file_info_has_attribute(info, key))
+        return "<unset>";
+    g_autofree gchar *text = g_file_info_get_attribute_as_string(info, key);
+    return QByteArray(text);
+}
+}   // namespace
+
+TEST(DLocalEnumerator, DefaultProjectionIsNative)
+{
+    EXPECT_TRUE(DLocalEnumerator::canQueryNatively(FILE_DEFAULT_ATTRIBUTES));
+    EXPECT_FALSE(DLocalEnumerator::canQueryNatively(FILE_DEFERRED_ATTRIBUTES));
+    EXPECT_FALSE(DLocalEnumerator::canQueryNatively("standard::content-type"));
+    EXPECT_FALSE(DLocalEnumerator::canQueryNatively(""));
+}
+
+TEST(DLocalEnumerator, DefaultProjectionMatchesGio)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    QDir(dir.path()).mkdir("sub");
+    QFile file(dir.filePath("file.txt"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("content");
+    file.close();
+    QFile::link(dir.filePath("file.txt"), dir.filePath("link"));
+    QFile::link(dir.filePath("missing"), dir.filePath("broken"));
+
+    GFileAttributeMatcher *matcher = DLocalHelper::attributeMatcher(FILE_DEFAULT_ATTRIBUTES);
+    const unsigned int mask = DLocalEnumerator::statxMask(matcher);
+
+    DLocalEnumerator enumerator(dir.path());
+    ASSERT_TRUE(enumerator.open());
+    int count = 0;
+    DLocalEnumerator::Entry entry;
+    while (enumerator.next(&entry, false)) {
+        ++count;
+        g_autoptr(GFileInfo) native = enumerator.createFileInfo(entry, matcher, mask, false);
+        g_autoptr(GFile) gfile = g_file_new_for_path(enumerator.childPath(entry.name).toLocal8Bit().constData());
+        g_autoptr(GFileInfo) gio = g_file_query_info(gfile, FILE_DEFAULT_ATTRIBUTES, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, nullptr, nullptr);
+        ASSERT_TRUE(gio);
+
+        for (const char *key : kComparedKeys)
+            EXPECT_EQ(attributeText(native, key), attributeText(gio, key)) << entry.name << " " << key;
+    }
+    EXPECT_EQ(count, 4);
+}
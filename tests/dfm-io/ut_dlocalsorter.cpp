@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <dfm-io/denumerator.h>
+#include <utils/dsortkey.h>
+#include <utils/dlocalhelper.h>
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QUrl>
+
+#include <algorithm>
+
+USING_IO_NAMESPACE
+
+namespace {
+// han characters mixed with digit runs, enough of them for the parallel sort
+QStringList mixedNames()
+{
+    QStringList names { "1", "2", "10", "1文件", "2文件", "10文件", "文件", "文件1", "文件2", "文件10",
+                        "新建文件夹", "新建文件夹1", "新建文件夹2", "新建文件夹10", "新建文件夹(2)",
+                        "a新建", "a10", "a9", "b2.txt", "b10.txt", "中1一", "中10一", "中2二" };
+    const QString hans = "文件新建夹中一二三";
+    for (int i = 0; i < 5000; ++i) {
+        QString name = hans.at(i % hans.length()) + QString::number(i + 1) + hans.at(i % 7);
+        if (i % 3 == 0)
+            name += ".txt";
+        names.append(name);
+    }
+    return names;
+}
+
+bool createFiles(const QTemporaryDir &dir, const QStringList &names)
+{
+    for (const QString &name : names) {
+        QFile file(dir.filePath(name));
+        if (!file.open(QIODevice::WriteOnly))
+            return false;
+    }
+    return true;
+}
+
+QStringList fileNames(const QList<QSharedPointer<DEnumerator::SortFileInfo>> &list)
+{
+    QStringList names;
+    for (const auto &info : list)
+        names.append(info->url.fileName());
+    return names;
+}
+}   // namespace
+
+TEST(TestDLocalSorter, sameOrderAsCompareByString)
+{
+    QStringList names = mixedNames();
+    // the old sort is only well defined where every key is exact
+    for (const QString &name : names)
+        ASSERT_TRUE(DSortKey(name).isExact()) << name.toStdString();
+
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_TRUE(createFiles(dir, names));
+
+    QSharedPointer<DEnumerator> enumerator { new DEnumerator(QUrl::fromLocalFile(dir.path())) };
+    enumerator->setSortRole(DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileName);
+    enumerator->setSortMixed(true);
+    const QStringList &sorted = fileNames(enumerator->sortFileInfoList());
+
+    std::sort(names.begin(), names.end(), DLocalHelper::compareByString);
+    EXPECT_EQ(sorted, names);
+}
+
+TEST(TestDLocalSorter, firstPageIsPrefixOfFullSort)
+{
+    const QStringList &names = mixedNames();
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_TRUE(createFiles(dir, names));
+
+    const auto roles = { DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileName,
+                         DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileSize };
+    for (auto role : roles) {
+        for (Qt::SortOrder order : { Qt::AscendingOrder, Qt::DescendingOrder }) {
+            QSharedPointer<DEnumerator> full { new DEnumerator(QUrl::fromLocalFile(dir.path())) };
+            full->setSortRole(role);
+            full->setSortOrder(order);
+            const QStringList &all = fileNames(full->sortFileInfoList());
+            ASSERT_EQ(all.size(), names.size());
+
+            QSharedPointer<DEnumerator> paged { new DEnumerator(QUrl::fromLocalFile(dir.path())) };
+            paged->setSortRole(role);
+            paged->setSortOrder(order);
+            const QStringList &first = fileNames(paged->sortFileInfoList(200));
+            ASSERT_GE(first.size(), 200);
+            EXPECT_EQ(first, all.mid(0, first.size()));
+            EXPECT_EQ(first + fileNames(paged->remainingSortFileInfoList()), all);
+        }
+    }
+}
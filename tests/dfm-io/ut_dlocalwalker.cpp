@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <utils/dlocalwalker.h>
+
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QSet>
+
+#include <gtest/gtest.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <unistd.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+// a few wide and a few deep dirs, each holding some files
+QSet<QByteArray> createTree(const QString &root)
+{
+    QSet<QByteArray> paths;
+    QDir dir(root);
+    for (int i = 0; i < 8; ++i) {
+        QString sub = QString("wide%1").arg(i);
+        for (int depth = 0; depth < (i % 4) + 1; ++depth) {
+            dir.mkpath(sub);
+            paths.insert(dir.filePath(sub).toLocal8Bit());
+            for (int f = 0; f < 40; ++f) {
+                const QString &file = dir.filePath(sub + QString("/file%1").arg(f));
+                QFile(file).open(QIODevice::WriteOnly);
+                paths.insert(file.toLocal8Bit());
+            }
+            sub += QString("/deep%1").arg(depth);
+        }
+    }
+    return paths;
+}
+
+QSet<QByteArray> walk(DLocalWalker *walker)
+{
+    QSet<QByteArray> paths;
+    DLocalWalker::Entry entry;
+    while (walker->next(&entry))
+        paths.insert(entry.path());
+    return paths;
+}
+}   // namespace
+
+TEST(DLocalWalker, WalksWholeTree)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QSet<QByteArray> &expected = createTree(dir.path());
+
+    for (int threads : { 1, 2, 4, 16 }) {
+        DLocalWalker walker(dir.path().toLocal8Bit(), threads, false);
+        walker.start();
+        EXPECT_EQ(walk(&walker), expected) << threads << " threads";
+        EXPECT_EQ(walker.lastErrno(), 0);
+    }
+}
+
+TEST(DLocalWalker, EmptyRootFinishes)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    DLocalWalker walker(dir.path().toLocal8Bit(), 4, false);
+    walker.start();
+    DLocalWalker::Entry entry;
+    EXPECT_FALSE(walker.next(&entry));
+    // asking again after the end does not block
+    EXPECT_FALSE(walker.next(&entry));
+}
+
+TEST(DLocalWalker, MissingRootReportsErrno)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+
+    DLocalWalker walker(dir.filePath("missing").toLocal8Bit(), 4, false);
+    walker.start();
+    DLocalWalker::Entry entry;
+    EXPECT_FALSE(walker.next(&entry));
+    EXPECT_EQ(walker.lastErrno(), ENOENT);
+}
+
+TEST(DLocalWalker, SymlinkLoopIsWalkedOnce)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_TRUE(QDir(dir.path()).mkdir("sub"));
+    const QByteArray &link = dir.filePath("sub/loop").toLocal8Bit();
+    ASSERT_EQ(symlink("..", link.constData()), 0);
+
+    DLocalWalker following(dir.path().toLocal8Bit(), 4, true);
+    following.start();
+    QSet<QByteArray> paths;
+    DLocalWalker::Entry entry;
+    while (following.next(&entry)) {
+        paths.insert(entry.path());
+        if (entry.name == "loop") {
+            EXPECT_EQ(entry.type, DT_LNK);
+            EXPECT_EQ(entry.targetType, DT_DIR);
+        }
+    }
+    const QSet<QByteArray> expected { dir.filePath("sub").toLocal8Bit(), link };
+    EXPECT_EQ(paths, expected);
+
+    DLocalWalker notFollowing(dir.path().toLocal8Bit(), 4, false);
+    notFollowing.start();
+    EXPECT_EQ(walk(&notFollowing), expected);
+}
+
+TEST(DLocalWalker, CancelEndsWalk)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    createTree(dir.path());
+
+    DLocalWalker walker(dir.path().toLocal8Bit(), 4, false);
+    walker.start();
+    DLocalWalker::Entry entry;
+    ASSERT_TRUE(walker.next(&entry));
+    walker.cancel();
+    // what is left of the current batch may still come, then it ends
+    int rest = 0;
+    while (walker.next(&entry))
+        ++rest;
+    EXPECT_LT(rest, 256);
+}
@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <utils/dmediacache.h>
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDir>
+
+#include <gtest/gtest.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+DMediaCache::Key keyFor(quint64 ino, qint64 modifiedNs = 1)
+{
+    DMediaCache::Key key;
+    key.dev = 42;
+    key.ino = ino;
+    key.modifiedNs = modifiedNs;
+    key.size = 1024;
+    return key;
+}
+
+DMediaCache::Values valuesFor(const QString &duration)
+{
+    DMediaCache::Values values;
+    values.duration = duration;
+    values.width = "1920";
+    values.height = "1080";
+    return values;
+}
+}   // namespace
+
+TEST(DMediaCache, FindsWhatWasInserted)
+{
+    QTemporaryDir dir;
+    DMediaCache cache(dir.filePath("media.cache"));
+    DMediaCache::Values values;
+    EXPECT_FALSE(cache.find(keyFor(1), DFileInfo::MediaType::kVideo, &values));
+
+    cache.insert(keyFor(1), DFileInfo::MediaType::kVideo, valuesFor("00:01:02"));
+    ASSERT_TRUE(cache.find(keyFor(1), DFileInfo::MediaType::kVideo, &values));
+    EXPECT_EQ(values.duration, "00:01:02");
+    EXPECT_EQ(values.width, "1920");
+    EXPECT_FALSE(cache.find(keyFor(1), DFileInfo::MediaType::kAudio, &values));
+}
+
+TEST(DMediaCache, ChangedFileMisses)
+{
+    QTemporaryDir dir;
+    DMediaCache cache(dir.filePath("media.cache"));
+    cache.insert(keyFor(1, 1), DFileInfo::MediaType::kVideo, valuesFor("old"));
+
+    DMediaCache::Values values;
+    EXPECT_FALSE(cache.find(keyFor(1, 2), DFileInfo::MediaType::kVideo, &values));
+    cache.insert(keyFor(1, 2), DFileInfo::MediaType::kVideo, valuesFor("new"));
+    ASSERT_TRUE(cache.find(keyFor(1, 2), DFileInfo::MediaType::kVideo, &values));
+    EXPECT_EQ(values.duration, "new");
+}
+
+TEST(DMediaCache, SurvivesReopen)
+{
+    QTemporaryDir dir;
+    const QString &path = dir.filePath("sub/media.cache");
+    {
+        DMediaCache cache(path);
+        cache.insert(keyFor(1), DFileInfo::MediaType::kVideo, valuesFor("first"));
+        cache.insert(keyFor(1), DFileInfo::MediaType::kVideo, valuesFor("second"));
+    }
+
+    // read in the background, found once it is in
+    DMediaCache cache(path);
+    cache.waitForLoaded();
+    DMediaCache::Values values;
+    ASSERT_TRUE(cache.find(keyFor(1), DFileInfo::MediaType::kVideo, &values));
+    EXPECT_EQ(values.duration, "second");
+}
+
+TEST(DMediaCache, InsertWhileLoadingWins)
+{
+    QTemporaryDir dir;
+    const QString &path = dir.filePath("media.cache");
+    {
+        DMediaCache cache(path);
+        cache.insert(keyFor(1), DFileInfo::MediaType::kVideo, valuesFor("file"));
+        cache.insert(keyFor(2), DFileInfo::MediaType::kVideo, valuesFor("other"));
+    }
+
+    DMediaCache cache(path);
+    cache.insert(keyFor(1), DFileInfo::MediaType::kVideo, valuesFor("memory"));
+    cache.waitForLoaded();
+    DMediaCache::Values values;
+    ASSERT_TRUE(cache.find(keyFor(1), DFileInfo::MediaType::kVideo, &values));
+    EXPECT_EQ(values.duration, "memory");
+    ASSERT_TRUE(cache.find(keyFor(2), DFileInfo::MediaType::kVideo, &values));
+    EXPECT_EQ(values.duration, "other");
+}
+
+TEST(DMediaCache, TornTailIsDropped)
+{
+    QTemporaryDir dir;
+    const QString &path = dir.filePath("media.cache");
+    {
+        DMediaCache cache(path);
+        cache.insert(keyFor(1), DFileInfo::MediaType::kVideo, valuesFor("kept"));
+    }
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write("\x40\x00\x00\x00garbage", 11);
+    file.close();
+
+    DMediaCache cache(path);
+    cache.waitForLoaded();
+    DMediaCache::Values values;
+    ASSERT_TRUE(cache.find(keyFor(1), DFileInfo::MediaType::kVideo, &values));
+    EXPECT_EQ(values.duration, "kept");
+    cache.insert(keyFor(2), DFileInfo::MediaType::kVideo, valuesFor("after"));
+
+    DMediaCache reopened(path);
+    reopened.waitForLoaded();
+    ASSERT_TRUE(reopened.find(keyFor(2), DFileInfo::MediaType::kVideo, &values));
+    EXPECT_EQ(values.duration, "after");
+}
+
+TEST(DMediaCache, CompactionKeepsNewest)
+{
+    QTemporaryDir dir;
+    const qint64 limit = 8192;
+    DMediaCache cache(dir.filePath("media.cache"), limit);
+    cache.waitForLoaded();
+    for (quint64 ino = 1; ino <= 1000; ++ino) {
+        cache.insert(keyFor(ino), DFileInfo::MediaType::kVideo, valuesFor(QString::number(ino)));
+        EXPECT_LE(cache.fileSize(), limit);
+    }
+
+    DMediaCache::Values values;
+    ASSERT_TRUE(cache.find(keyFor(1000), DFileInfo::MediaType::kVideo, &values));
+    EXPECT_EQ(values.duration, "1000");
+    EXPECT_FALSE(cache.find(keyFor(1), DFileInfo::MediaType::kVideo, &values));
+}
+
+TEST(DMediaCache, AppendsFollowAnotherCompaction)
+{
+    QTemporaryDir dir;
+    const QString &path = dir.filePath("media.cache");
+    const qint64 limit = 8192;
+    DMediaCache other(path, limit);
+    other.waitForLoaded();
+    DMediaCache cache(path, limit);
+    cache.waitForLoaded();
+    cache.insert(keyFor(1), DFileInfo::MediaType::kVideo, valuesFor("before"));
+
+    // the other instance renames a compacted file over the one cache appends to
+    for (quint64 ino = 100; ino < 400; ++ino)
+        other.insert(keyFor(ino), DFileInfo::MediaType::kVideo, valuesFor(QString::number(ino)));
+    cache.insert(keyFor(2), DFileInfo::MediaType::kVideo, valuesFor("after"));
+
+    DMediaCache reopened(path, limit);
+    reopened.waitForLoaded();
+    DMediaCache::Values values;
+    ASSERT_TRUE(reopened.find(keyFor(2), DFileInfo::MediaType::kVideo, &values));
+    EXPECT_EQ(values.duration, "after");
+    EXPECT_EQ(QDir(dir.path()).entryList(QDir::Files), QStringList({ "media.cache", "media.cache.lock" }));
+}
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <utils/dnamematcher.h>
+
+#include <gtest/gtest.h>
+
+USING_IO_NAMESPACE
+
+TEST(DNameMatcher, Empty)
+{
+    DNameMatcher matcher;
+    EXPECT_TRUE(matcher.isEmpty());
+    EXPECT_TRUE(matcher.matches("anything"));
+}
+
+TEST(DNameMatcher, Suffixes)
+{
+    DNameMatcher matcher({ "*.jpg", "*.tar.gz" }, false);
+    EXPECT_TRUE(matcher.matches("a.jpg"));
+    EXPECT_TRUE(matcher.matches("A.JPG"));
+    EXPECT_TRUE(matcher.matches("x.y.jpg"));
+    EXPECT_TRUE(matcher.matches("src.tar.gz"));
+    EXPECT_FALSE(matcher.matches("a.gz"));
+    EXPECT_FALSE(matcher.matches("a.jpeg"));
+    EXPECT_FALSE(matcher.matches("jpg"));
+}
+
+TEST(DNameMatcher, CaseSensitive)
+{
+    DNameMatcher matcher({ "*.jpg", "README" }, true);
+    EXPECT_TRUE(matcher.matches("a.jpg"));
+    EXPECT_FALSE(matcher.matches("a.JPG"));
+    EXPECT_TRUE(matcher.matches("README"));
+    EXPECT_FALSE(matcher.matches("readme"));
+}
+
+TEST(DNameMatcher, Globs)
+{
+    DNameMatcher matcher({ "IMG_????.*", "[abc]*.txt" }, false);
+    EXPECT_TRUE(matcher.matches("IMG_0001.jpg"));
+    EXPECT_TRUE(matcher.matches("img_0001.png"));
+    EXPECT_FALSE(matcher.matches("IMG_01.jpg"));
+    EXPECT_TRUE(matcher.matches("b-notes.txt"));
+    EXPECT_FALSE(matcher.matches("d-notes.txt"));
+}
+
+TEST(DNameMatcher, MatchAll)
+{
+    DNameMatcher matcher({ "*.jpg", "*" }, true);
+    EXPECT_TRUE(matcher.matches("whatever"));
+}
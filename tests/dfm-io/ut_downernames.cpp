@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "stub.h"
+
+#include <utils/downernames.h>
+#include <dfm-io/denumerator.h>
+#include <dfm-io/dfileinfo.h>
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QHash>
+
+#include <gtest/gtest.h>
+
+#include <pwd.h>
+#include <grp.h>
+#include <unistd.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+QHash<uid_t, int> userLookups;
+
+bool countedLookupUser(uid_t uid, DOwnerNames::Names *names)
+{
+    ++userLookups[uid];
+    names->age.start();
+    names->name = QString("user%1").arg(uid);
+    names->realName = names->name;
+    return true;
+}
+
+char kLogin[] = "someone";
+char kEmptyGecos[] = "";
+
+int passwdWithEmptyGecos(uid_t uid, struct passwd *pwd, char *, size_t, struct passwd **result)
+{
+    *pwd = {};
+    pwd->pw_name = kLogin;
+    pwd->pw_gecos = kEmptyGecos;
+    pwd->pw_uid = uid;
+    *result = pwd;
+    return 0;
+}
+
+int noPasswd(uid_t, struct passwd *, char *, size_t, struct passwd **result)
+{
+    *result = nullptr;
+    return 0;
+}
+
+int noGroup(gid_t, struct group *, char *, size_t, struct group **result)
+{
+    *result = nullptr;
+    return 0;
+}
+}   // namespace
+
+TEST(DOwnerNames, MissingEntryFallsBackToId)
+{
+    Stub stub;
+    stub.set(getpwuid_r, noPasswd);
+    stub.set(getgrgid_r, noGroup);
+
+    DOwnerNames::Names user;
+    EXPECT_TRUE(DOwnerNames::lookupUser(4242, &user));
+    EXPECT_EQ(user.name, QString("4242"));
+    EXPECT_EQ(user.realName, QString("user #4242"));
+
+    DOwnerNames::Names group;
+    EXPECT_TRUE(DOwnerNames::lookupGroup(4343, &group));
+    EXPECT_EQ(group.name, QString("4343"));
+}
+
+TEST(DOwnerNames, EmptyGecosFallsBackToLogin)
+{
+    Stub stub;
+    stub.set(getpwuid_r, passwdWithEmptyGecos);
+
+    DOwnerNames::Names user;
+    EXPECT_TRUE(DOwnerNames::lookupUser(4242, &user));
+    EXPECT_EQ(user.name, QString("someone"));
+    EXPECT_EQ(user.realName, QString("someone"));
+}
+
+TEST(DOwnerNames, ListingResolvesEachUidOnce)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    for (int i = 0; i < 20; ++i) {
+        QFile file(dir.filePath(QString("file%1").arg(i)));
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    }
+
+    Stub stub;
+    stub.set(ADDR(DOwnerNames, lookupUser), countedLookupUser);
+    DOwnerNames::instance()->users.clear();
+    userLookups.clear();
+
+    QSharedPointer<DEnumerator> enumerator { new DEnumerator(QUrl::fromLocalFile(dir.path())) };
+    int count = 0;
+    while (enumerator->hasNext()) {
+        const QSharedPointer<DFileInfo> &info = enumerator->fileInfo();
+        ASSERT_TRUE(info);
+        EXPECT_EQ(info->attribute(DFileInfo::AttributeID::kOwnerUser).toString(), QString("user%1").arg(getuid()));
+        EXPECT_EQ(info->attribute(DFileInfo::AttributeID::kOwnerUserReal).toString(), QString("user%1").arg(getuid()));
+        ++count;
+    }
+
+    EXPECT_EQ(count, 20);
+    EXPECT_EQ(userLookups.size(), 1);
+    EXPECT_EQ(userLookups.value(getuid()), 1);
+    DOwnerNames::instance()->users.clear();
+}
@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <utils/dqueryflight.h>
+
+#include <QTemporaryDir>
+#include <QFile>
+
+#include <gtest/gtest.h>
+
+#include <initializer_list>
+
+USING_IO_NAMESPACE
+
+namespace {
+struct Result
+{
+    bool done { false };
+    GFileInfo *info { nullptr };
+    int errorCode { -1 };
+
+    ~Result()
+    {
+        if (info)
+            g_object_unref(info);
+    }
+};
+
+void collect(GFileInfo *info, GError *error, gpointer userData)
+{
+    Result *result = static_cast<Result *>(userData);
+    result->done = true;
+    result->info = info;
+    if (error)
+        result->errorCode = error->code;
+}
+
+void waitFor(std::initializer_list<const Result *> results)
+{
+    for (const Result *result : results) {
+        while (!result->done)
+            g_main_context_iteration(nullptr, TRUE);
+    }
+}
+
+const char kAttributes[] = G_FILE_ATTRIBUTE_STANDARD_NAME "," G_FILE_ATTRIBUTE_STANDARD_SIZE;
+
+class DQueryFlightTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+        QFile file(dir.filePath("a.txt"));
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        ASSERT_EQ(file.write("some text"), 9);
+        file.close();
+        gfile = g_file_new_for_path(file.fileName().toLocal8Bit().constData());
+    }
+
+    void TearDown() override
+    {
+        g_object_unref(gfile);
+    }
+
+    void query(Result *result, GCancellable *cancellable = nullptr, int ioPriority = G_PRIORITY_DEFAULT)
+    {
+        DQueryFlight::instance()->queryInfo(gfile, kAttributes, G_FILE_QUERY_INFO_NONE, ioPriority, cancellable, collect, result);
+    }
+
+    int pending() const
+    {
+        return DQueryFlight::instance()->flights.size();
+    }
+
+    QTemporaryDir dir;
+    GFile *gfile { nullptr };
+};
+}   // namespace
+
+TEST_F(DQueryFlightTest, JoinsPendingQuery)
+{
+    Result first, second;
+    query(&first);
+    query(&second);
+    ASSERT_EQ(pending(), 1);
+    EXPECT_EQ(DQueryFlight::instance()->flights.first()->waiters.size(), 2);
+
+    waitFor({ &first, &second });
+    EXPECT_EQ(pending(), 0);
+    ASSERT_TRUE(first.info);
+    ASSERT_TRUE(second.info);
+    // each caller owns its own info
+    EXPECT_NE(first.info, second.info);
+    EXPECT_EQ(g_file_info_get_size(first.info), 9);
+    EXPECT_EQ(g_file_info_get_size(second.info), 9);
+}
+
+TEST_F(DQueryFlightTest, CancelledJoinerGetsCancelled)
+{
+    g_autoptr(GCancellable) cancellable = g_cancellable_new();
+    Result first, second;
+    query(&first);
+    query(&second, cancellable);
+    ASSERT_EQ(pending(), 1);
+    g_cancellable_cancel(cancellable);
+
+    waitFor({ &first, &second });
+    EXPECT_TRUE(first.info);
+    EXPECT_FALSE(second.info);
+    EXPECT_EQ(second.errorCode, G_IO_ERROR_CANCELLED);
+}
+
+TEST_F(DQueryFlightTest, FirstCallerCancelDoesNotCancelOthers)
+{
+    g_autoptr(GCancellable) cancellable = g_cancellable_new();
+    Result first, second;
+    query(&first, cancellable);
+    query(&second);
+    g_cancellable_cancel(cancellable);
+
+    waitFor({ &first, &second });
+    EXPECT_FALSE(first.info);
+    EXPECT_EQ(first.errorCode, G_IO_ERROR_CANCELLED);
+    EXPECT_TRUE(second.info);
+}
+
+TEST_F(DQueryFlightTest, AllCallersCancelledCancelsQuery)
+{
+    g_autoptr(GCancellable) one = g_cancellable_new();
+    g_autoptr(GCancellable) other = g_cancellable_new();
+    Result first, second;
+    query(&first, one);
+    query(&second, other);
+    GCancellable *flightCancellable = DQueryFlight::instance()->flights.first()->cancellable;
+
+    g_cancellable_cancel(one);
+    EXPECT_FALSE(g_cancellable_is_cancelled(flightCancellable));
+    g_cancellable_cancel(other);
+    EXPECT_TRUE(g_cancellable_is_cancelled(flightCancellable));
+
+    waitFor({ &first, &second });
+    EXPECT_EQ(first.errorCode, G_IO_ERROR_CANCELLED);
+    EXPECT_EQ(second.errorCode, G_IO_ERROR_CANCELLED);
+}
+
+TEST_F(DQueryFlightTest, CancelledQueryIsAskedAgain)
+{
+    Result first;
+    query(&first);
+    ASSERT_EQ(pending(), 1);
+    // as if every other caller had cancelled right before this one joined
+    g_cancellable_cancel(DQueryFlight::instance()->flights.first()->cancellable);
+
+    Result second;
+    query(&second);
+    EXPECT_EQ(pending(), 1);
+
+    waitFor({ &first, &second });
+    EXPECT_TRUE(first.info);
+    EXPECT_TRUE(second.info);
+    EXPECT_EQ(pending(), 0);
+}
+
+TEST_F(DQueryFlightTest, UrgentCallerStartsNewQuery)
+{
+    Result background, urgent, later;
+    query(&background, nullptr, G_PRIORITY_LOW);
+    DQueryFlight::Flight *lowFlight = DQueryFlight::instance()->flights.first();
+    query(&urgent, nullptr, G_PRIORITY_HIGH);
+    ASSERT_EQ(pending(), 1);
+    DQueryFlight::Flight *highFlight = DQueryFlight::instance()->flights.first();
+    EXPECT_NE(lowFlight, highFlight);
+    EXPECT_EQ(highFlight->ioPriority, G_PRIORITY_HIGH);
+
+    // less urgent callers join the urgent query
+    query(&later, nullptr, G_PRIORITY_DEFAULT);
+    EXPECT_EQ(highFlight->waiters.size(), 2);
+
+    waitFor({ &background, &urgent, &later });
+    EXPECT_TRUE(background.info);
+    EXPECT_TRUE(urgent.info);
+    EXPECT_TRUE(later.info);
+    EXPECT_EQ(pending(), 0);
+}
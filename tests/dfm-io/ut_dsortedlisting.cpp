@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <dfm-io/dsortedlisting.h>
+
+#include <gtest/gtest.h>
+
+USING_IO_NAMESPACE
+
+TEST(DSortedListing, AppendAndRead)
+{
+    DSortedListing listing("/tmp/dir/");
+    listing.append("b", 1, DSortedListing::kIsDir | DSortedListing::kIsReadable, 4096, 100);
+    listing.append(".hidden.txt", 11, DSortedListing::kIsFile | DSortedListing::kIsHide, 12, 200);
+
+    ASSERT_EQ(listing.size(), 2);
+    EXPECT_EQ(listing.parentPath(), QString("/tmp/dir"));
+    EXPECT_EQ(listing.fileNameBytes(1), QByteArray(".hidden.txt"));
+    EXPECT_EQ(listing.fileName(0), QString("b"));
+    EXPECT_EQ(listing.url(1), QUrl::fromLocalFile("/tmp/dir/.hidden.txt"));
+    EXPECT_TRUE(listing.flags(0).testFlag(DSortedListing::kIsDir));
+    EXPECT_EQ(listing.fileSize(1), 12);
+    EXPECT_EQ(listing.lastModified(0), 100);
+
+    const auto &info = listing.sortFileInfo(1);
+    EXPECT_TRUE(info->isFile);
+    EXPECT_TRUE(info->isHide);
+    EXPECT_FALSE(info->isReadable);
+    EXPECT_EQ(info->url, listing.url(1));
+
+    int count = 0;
+    for (const auto &entry : listing)
+        EXPECT_EQ(entry.index(), count++);
+    EXPECT_EQ(count, listing.size());
+}
+
+TEST(DSortedListing, RootParent)
+{
+    DSortedListing listing("/");
+    listing.append("usr", 3, DSortedListing::kIsDir, 0, 0);
+    EXPECT_EQ(listing.filePath(0), QString("/usr"));
+}
+
+TEST(DSortedListing, CopiesShareData)
+{
+    DSortedListing listing("/tmp");
+    listing.append("a", 1, DSortedListing::kIsFile, 1, 1);
+    DSortedListing copy = listing;
+    listing.append("b", 1, DSortedListing::kIsFile, 2, 2);
+    EXPECT_EQ(copy.size(), 1);
+    EXPECT_EQ(listing.size(), 2);
+}
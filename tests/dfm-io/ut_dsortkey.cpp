@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <utils/dsortkey.h>
+#include <utils/dlocalhelper.h>
+
+#include <gtest/gtest.h>
+
+#include <QDirIterator>
+#include <QStringList>
+
+#include <random>
+
+USING_IO_NAMESPACE
+
+namespace {
+// real file names from the system, plus names built around the corner cases of compareByString
+QStringList sortKeyCorpus()
+{
+    QStringList names;
+    const QStringList roots { "/usr/share", "/usr/include", "/usr/lib" };
+    for (const QString &root : roots) {
+        QDirIterator it(root, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (it.hasNext() && names.size() < 40000) {
+            it.next();
+            names.append(it.fileName());
+        }
+    }
+
+    names << "" << "." << ".." << ".bashrc" << "bashrc" << "a." << "a.b.c" << "A.txt" << "a.txt"
+          << "a0" << "a00" << "a0b" << "a01" << "a1" << "a1b" << "a10" << "a010" << "a9" << "007" << "07"
+          << "4294967295" << "4294967296" << "42949672950" << "99999999999999999999"
+          << "新建文件" << "新建文件夹" << "新建文件a" << "文件1" << "文件10" << "文件2"
+          << "résumé.pdf" << "Résumé.pdf" << "report.pdf" << "Ωmega" << "ωmega" << "αlpha"
+          << QString(QChar(0x212A)) + "elvin" << "kelvin" << "zelvin" << "file (1).txt" << "file_1.txt" << "file-1.txt"
+          << "Отчет 2" << "Отчет 10" << "отчет 3" << "Café 2" << "café 10" << "Ελλάδα 9" << "ελλάδα 10";
+
+    std::mt19937 random(1);
+    const QString alphabet = QString("aAbBzZ0123456789._- ()éÉωΩоО") + QChar(0x212A) + "新建文件夹中一二三";
+    for (int i = 0; i < 20000; ++i) {
+        QString name;
+        const int length = static_cast<int>(random() % 9);
+        for (int j = 0; j < length; ++j)
+            name.append(alphabet.at(static_cast<int>(random() % static_cast<unsigned>(alphabet.length()))));
+        names.append(name);
+    }
+    return names;
+}
+
+// compareByString orders two different cased non ascii letters by their own code,
+// the key by the lowercased one, see DSortKey
+bool caseOrderDiffers(const QString &left, const QString &right)
+{
+    const int length = qMin(left.length(), right.length());
+    for (int i = 0; i < length; ++i) {
+        const QChar l = left.at(i);
+        const QChar r = right.at(i);
+        if (l == r || l.toLower() == r.toLower())
+            continue;
+        if (l.toLower().unicode() < 0x80 || r.toLower().unicode() < 0x80)
+            return false;
+        return (l < r) != (l.toLower() < r.toLower());
+    }
+    return false;
+}
+}   // namespace
+
+TEST(TestDSortKey, sameOrderAsCompareByString)
+{
+    const QStringList &names = sortKeyCorpus();
+    QVector<DSortKey> keys;
+    keys.reserve(names.size());
+    for (const QString &name : names)
+        keys.append(DSortKey(name));
+
+    std::mt19937 random(2);
+    for (int i = 0; i < 500000; ++i) {
+        const int left = static_cast<int>(random() % static_cast<unsigned>(names.size()));
+        const int right = static_cast<int>(random() % static_cast<unsigned>(names.size()));
+        // a key that stopped early has no compareByString order behind its end
+        const DSortKey &leftKey = keys.at(left);
+        const DSortKey &rightKey = keys.at(right);
+        const bool exact = leftKey.isExact() && rightKey.isExact();
+        if (!exact && (leftKey.key().startsWith(rightKey.key()) || rightKey.key().startsWith(leftKey.key())))
+            continue;
+        if (caseOrderDiffers(names.at(left), names.at(right)))
+            continue;
+        EXPECT_EQ(DSortKey::lessThan(leftKey, rightKey),
+                  DLocalHelper::compareByString(names.at(left), names.at(right)))
+                << names.at(left).toStdString() << " <> " << names.at(right).toStdString();
+    }
+}
+
+TEST(TestDSortKey, strictWeakOrder)
+{
+    const QStringList &names = sortKeyCorpus();
+    QVector<DSortKey> keys;
+    keys.reserve(names.size());
+    for (const QString &name : names)
+        keys.append(DSortKey(name));
+
+    std::mt19937 random(3);
+    auto pick = [&]() -> const DSortKey & {
+        return keys.at(static_cast<int>(random() % static_cast<unsigned>(keys.size())));
+    };
+    for (int i = 0; i < 200000; ++i) {
+        const DSortKey &a = pick();
+        const DSortKey &b = pick();
+        const DSortKey &c = pick();
+        EXPECT_FALSE(DSortKey::lessThan(a, a)) << a.name().toStdString();
+        if (DSortKey::lessThan(a, b))
+            EXPECT_FALSE(DSortKey::lessThan(b, a)) << a.name().toStdString() << " <> " << b.name().toStdString();
+        if (DSortKey::lessThan(a, b) && DSortKey::lessThan(b, c))
+            EXPECT_TRUE(DSortKey::lessThan(a, c)) << a.name().toStdString() << " < " << c.name().toStdString();
+        if (a.name() != b.name())
+            EXPECT_NE(DSortKey::lessThan(a, b), DSortKey::lessThan(b, a));
+    }
+}
+
+TEST(TestDSortKey, numbersAsValues)
+{
+    EXPECT_TRUE(DSortKey::lessThan(DSortKey("a9"), DSortKey("a10")));
+    EXPECT_TRUE(DSortKey::lessThan(DSortKey("a010"), DSortKey("a10")));
+    EXPECT_FALSE(DSortKey::lessThan(DSortKey("a10"), DSortKey("a9")));
+    EXPECT_TRUE(DSortKey("a10").isExact());
+    EXPECT_FALSE(DSortKey("a00").isExact());
+}
+
+TEST(TestDSortKey, nonAsciiLettersKeepNumbersAsValues)
+{
+    // name pairs in the order compareByString gives them, no pair is skipped
+    const QList<QPair<QString, QString>> pairs {
+        { "Отчет 2", "Отчет 10" },
+        { "отчет 2", "Отчет 10" },
+        { "Отчет 9.txt", "отчет 10.txt" },
+        { "Отчет10", "Отчет11" },
+        { "Café 2", "Café 10" },
+        { "café 2", "Café 10" },
+        { "résumé2.pdf", "Résumé10.pdf" },
+        { "Ελλάδα 9", "ελλάδα 10" },
+        { "Über1a", "über1b" },
+    };
+    for (const auto &pair : pairs) {
+        ASSERT_TRUE(DLocalHelper::compareByString(pair.first, pair.second))
+                << pair.first.toStdString() << " < " << pair.second.toStdString();
+        EXPECT_TRUE(DSortKey::lessThan(DSortKey(pair.first), DSortKey(pair.second)))
+                << pair.first.toStdString() << " < " << pair.second.toStdString();
+        EXPECT_FALSE(DSortKey::lessThan(DSortKey(pair.second), DSortKey(pair.first)))
+                << pair.second.toStdString() << " < " << pair.first.toStdString();
+    }
+
+    // case alone does not decide before the rest of the name
+    EXPECT_TRUE(DSortKey::lessThan(DSortKey("Яблоко 1"), DSortKey("яблоко 2")));
+    EXPECT_TRUE(DSortKey::lessThan(DSortKey("яблоко 1"), DSortKey("Яблоко 2")));
+}
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <utils/dxattrbatch.h>
+
+#include <QTemporaryDir>
+#include <QFile>
+
+#include <gtest/gtest.h>
+
+#include <sys/xattr.h>
+
+USING_IO_NAMESPACE
+
+TEST(DXattrBatch, KeysAndNames)
+{
+    EXPECT_EQ(DXattrBatch::nameOf("xattr::tag"), QByteArray("user.tag"));
+    EXPECT_EQ(DXattrBatch::nameOf("xattr-sys::security.selinux"), QByteArray("security.selinux"));
+    EXPECT_EQ(DXattrBatch::keyOf("user.tag"), QByteArray("xattr::tag"));
+    EXPECT_EQ(DXattrBatch::keyOf("trusted.x"), QByteArray("xattr-sys::trusted.x"));
+}
+
+TEST(DXattrBatch, EscapeRoundTrip)
+{
+    const QByteArray raw("a\\b\x01\xff z", 7);
+    const QByteArray escaped = DXattrBatch::escape(raw);
+    EXPECT_EQ(escaped, QByteArray("a\\x5cb\\x01\\xff z"));
+    EXPECT_EQ(DXattrBatch::unescape(escaped), raw);
+    // not an escape, kept as is
+    EXPECT_EQ(DXattrBatch::unescape("\\xg1\\x"), QByteArray("\\xg1\\x"));
+}
+
+TEST(DXattrBatch, LocalReadWrite)
+{
+    QTemporaryDir dir;
+    QList<QUrl> urls;
+    for (const char *name : { "a.jpg", "b.jpg" }) {
+        QFile file(dir.filePath(name));
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        urls.append(QUrl::fromLocalFile(file.fileName()));
+    }
+    urls.append(QUrl::fromLocalFile(dir.filePath("missing.jpg")));
+
+    if (setxattr(urls.first().toLocalFile().toLocal8Bit().constData(), "user.probe", "1", 1, 0) != 0)
+        GTEST_SKIP() << "no user xattrs on " << dir.path().toStdString();
+
+    QMap<QByteArray, QByteArray> values;
+    values.insert("xattr::tag", QByteArray("red\0blue", 8));
+    values.insert("xattr::probe", QByteArray());
+    const QList<DFMIOError> &errors = DXattrBatch(urls).write(values);
+    ASSERT_EQ(errors.size(), 3);
+    EXPECT_FALSE(errors.at(0).isError());
+    EXPECT_FALSE(errors.at(1).isError());
+    EXPECT_EQ(errors.at(2).code(), DFM_IO_ERROR_NOT_FOUND);
+
+    const QList<DFileInfo::ExtendedAttributes> &all = DXattrBatch(urls).read({});
+    ASSERT_EQ(all.size(), 3);
+    EXPECT_EQ(all.at(0).values.keys(), QList<QByteArray>({ "xattr::tag" }));
+    EXPECT_EQ(all.at(1).values.value("xattr::tag"), QByteArray("red\0blue", 8));
+    EXPECT_TRUE(all.at(2).error.isError());
+
+    const QList<DFileInfo::ExtendedAttributes> &some = DXattrBatch(urls.mid(0, 1)).read({ "xattr::tag", "xattr::none" });
+    ASSERT_EQ(some.size(), 1);
+    EXPECT_FALSE(some.at(0).error.isError());
+    EXPECT_EQ(some.at(0).values.size(), 1);
+}